@@ -0,0 +1,112 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: CrackedColumn.cpp
+// ------------------------------------------------------------
+// Self-organizing copy of the goals column (see CrackedColumn.h).
+// ------------------------------------------------------------
+
+#include "CrackedColumn.h"
+#include <utility>
+using namespace std;
+
+void CrackedColumn::reset(const vector<int>& goals) {
+    entries_.resize(goals.size());
+    positions_.resize(goals.size());
+    for (size_t i = 0; i < goals.size(); ++i) {
+        entries_[i] = {goals[i], static_cast<uint32_t>(i)};
+        positions_[i] = static_cast<uint32_t>(i);
+    }
+    cracks_.clear();
+}
+
+void CrackedColumn::swapEntries(size_t a, size_t b) {
+    if (a == b) return;
+    swap(entries_[a], entries_[b]);
+    positions_[entries_[a].row] = static_cast<uint32_t>(a);
+    positions_[entries_[b].row] = static_cast<uint32_t>(b);
+}
+
+// ------------------------------------------------------------
+// Helper Function: crack
+// ------------------------------------------------------------
+// Only the piece between the neighbouring cracks is partitioned:
+// smaller values are swapped to its front, the rest to its back.
+// ------------------------------------------------------------
+size_t CrackedColumn::crack(int64_t bound) {
+    auto next = cracks_.lower_bound(bound);
+    if (next != cracks_.end() && next->first == bound) return next->second;
+
+    size_t low = (next == cracks_.begin()) ? 0 : prev(next)->second;
+    size_t high = (next == cracks_.end()) ? entries_.size() : next->second;
+
+    while (low < high) {
+        if (entries_[low].goals < bound) {
+            ++low;
+        } else {
+            swapEntries(low, --high);
+        }
+    }
+    cracks_.emplace_hint(next, bound, low);
+    return low;
+}
+
+// ------------------------------------------------------------
+// Helper Function: ripple
+// ------------------------------------------------------------
+// Moving up: the entry swaps with the last entry of its piece, and
+// the crack above it moves down one place – the entry is now the
+// first entry of the next piece. Moving down is the mirror image.
+// Only the pieces between the old and new value are touched.
+// ------------------------------------------------------------
+void CrackedColumn::ripple(size_t at, int64_t from, int64_t to) {
+    if (to > from) {
+        for (auto it = cracks_.upper_bound(from); it != cracks_.end() && it->first <= to; ++it) {
+            size_t last = it->second - 1;
+            swapEntries(at, last);
+            at = last;
+            it->second = last;
+        }
+    } else if (to < from) {
+        auto it = cracks_.upper_bound(from);
+        while (it != cracks_.begin()) {
+            --it;
+            if (it->first <= to) break;
+            size_t first = it->second;
+            swapEntries(at, first);
+            at = first;
+            it->second = first + 1;
+        }
+    }
+}
+
+void CrackedColumn::append(uint32_t row, int goals) {
+    if (positions_.size() <= row) positions_.resize(row + 1);
+    positions_[row] = static_cast<uint32_t>(entries_.size());
+    entries_.push_back({goals, row});
+    // A new entry starts in the last piece, above every crack.
+    ripple(entries_.size() - 1, INT64_MAX, goals);
+}
+
+void CrackedColumn::update(uint32_t row, int oldGoals, int newGoals) {
+    size_t at = positions_[row];
+    entries_[at].goals = newGoals;
+    ripple(at, oldGoals, newGoals);
+}
+
+size_t CrackedColumn::count(int minGoals, int maxGoals) {
+    if (minGoals > maxGoals) return 0;
+    size_t first = crack(minGoals);
+    size_t last = crack(int64_t(maxGoals) + 1);
+    return last - first;
+}
+
+vector<uint32_t> CrackedColumn::rows(int minGoals, int maxGoals) {
+    vector<uint32_t> result;
+    if (minGoals > maxGoals) return result;
+    size_t first = crack(minGoals);
+    size_t last = crack(int64_t(maxGoals) + 1);
+
+    result.reserve(last - first);
+    for (size_t i = first; i < last; ++i) result.push_back(entries_[i].row);
+    return result;
+}
@@ -0,0 +1,84 @@
+//
+// Module 9 - Streams and Files
+// Header File: CrackedColumn.h
+// ------------------------------------------------------------
+// An index on the goals column that builds itself while it is
+// being queried ("database cracking").
+//
+// Sorting the whole column up front would make every range query
+// fast, but the first query would have to wait for the sort. A
+// cracked column starts as a plain copy of (goals, row) pairs.
+// Each range query [A, B] then partitions ("cracks") only the
+// piece of the copy that contains A, and the piece that contains
+// B + 1, quicksort-style:
+//
+//   query 1: 10..19   | <10        | 10..19 | >=20              |
+//   query 2: 5..9     | <5 | 5..9  | 10..19 | >=20              |
+//
+// The crack positions are remembered, so a piece that has been
+// cracked is never looked at again: the answer to a query is the
+// run of entries between two cracks. Early queries cost about one
+// pass over the column; as the cracks pile up, the pieces get
+// smaller and queries get cheaper, without an explicit index build.
+//
+// A change to a row's goals moves its entry across the cracks
+// between its old and new value, one swap per crack ("ripple"),
+// so the column never has to be copied again. A goal scored
+// usually crosses at most one crack.
+//
+// Not thread-safe; Soccer protects it with its own locks.
+//
+// Example:
+//   CrackedColumn column;
+//   column.reset(goals);
+//   size_t n = column.count(10, 19);      // cracks at 10 and 20
+//   auto rows = column.rows(10, 19);      // no cracking needed now
+// ------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+class CrackedColumn {
+public:
+    // Replaces the copy with goals[0..n) (row i = goals[i]) and
+    // forgets every crack.
+    void reset(const std::vector<int>& goals);
+
+    // Keep the copy in step with the table.
+    void append(uint32_t row, int goals);
+    void update(uint32_t row, int oldGoals, int newGoals);
+
+    // Number of rows / the rows (in no particular order) with
+    // minGoals <= goals <= maxGoals. Both crack the column.
+    size_t count(int minGoals, int maxGoals);
+    std::vector<uint32_t> rows(int minGoals, int maxGoals);
+
+    // Number of cracks made so far.
+    size_t cracks() const { return cracks_.size(); }
+
+private:
+    struct Entry {
+        int goals;
+        uint32_t row;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> positions_;   // Row → index in entries_
+
+    // Bound → first index whose goals are >= bound. Everything
+    // before that index is < bound. Bounds are 64-bit so that
+    // "maxGoals + 1" can't overflow.
+    std::map<int64_t, size_t> cracks_;
+
+    // Makes sure there is a crack at 'bound' and returns its index.
+    size_t crack(int64_t bound);
+
+    void swapEntries(size_t a, size_t b);
+
+    // Moves the entry at index 'at' across every crack between
+    // 'from' and 'to' (exclusive / inclusive as the order needs).
+    void ripple(size_t at, int64_t from, int64_t to);
+};
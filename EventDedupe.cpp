@@ -0,0 +1,128 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: EventDedupe.cpp
+// ------------------------------------------------------------
+// Time-windowed duplicate detection (see EventDedupe.h).
+// ------------------------------------------------------------
+
+#include "EventDedupe.h"
+#include <algorithm>
+#include <functional>
+using namespace std;
+
+EventDedupe::EventDedupe(Clock::duration window, size_t maxKeysPerWindow)
+    : window_(window), maxKeys_(max<size_t>(1, maxKeysPerWindow)) {
+    // At most half full, so probe sequences stay short.
+    tableSize_ = 2;
+    while (tableSize_ < maxKeys_ * 2) tableSize_ *= 2;
+}
+
+bool EventDedupe::Generation::contains(uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; slots[i] != 0; i = (i + 1) & mask) {
+        if (slots[i] == hash) return true;
+    }
+    return false;
+}
+
+void EventDedupe::Generation::insert(uint64_t hash) {
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i] != 0) i = (i + 1) & mask;   // Linear probing
+    slots[i] = hash;
+    ++used;
+}
+
+// ------------------------------------------------------------
+// Function: Generation::erase
+// ------------------------------------------------------------
+// With linear probing a slot can't simply be emptied: a later
+// hash of the same probe run would no longer be found. Instead,
+// each later hash that may sit in the hole (its home slot is not
+// between the hole and itself) is moved back into it, until the
+// run ends.
+// ------------------------------------------------------------
+void EventDedupe::Generation::erase(uint64_t hash) {
+    if (slots.empty()) return;
+    size_t mask = slots.size() - 1;
+    size_t hole = hash & mask;
+    while (slots[hole] != hash) {
+        if (slots[hole] == 0) return;           // Not in this generation
+        hole = (hole + 1) & mask;
+    }
+
+    for (size_t i = (hole + 1) & mask; slots[i] != 0; i = (i + 1) & mask) {
+        size_t home = slots[i] & mask;
+        bool staysPut = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!staysPut) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole] = 0;
+    --used;
+}
+
+void EventDedupe::Generation::clear(Clock::time_point now) {
+    fill(slots.begin(), slots.end(), 0);
+    used = 0;
+    started = now;
+}
+
+// ------------------------------------------------------------
+// Function: rotate
+// ------------------------------------------------------------
+// The current generation becomes the previous one; the old
+// previous generation is emptied and becomes the new current.
+// ------------------------------------------------------------
+void EventDedupe::rotate(Clock::time_point now) {
+    current_ = 1 - current_;
+    generations_[current_].clear(now);
+}
+
+uint64_t EventDedupe::keyHash(string_view key) {
+    uint64_t h = hash<string_view>{}(key);
+    return h == 0 ? 1 : h;              // 0 marks an empty slot
+}
+
+bool EventDedupe::firstTime(string_view key, Clock::time_point now) {
+    return firstTime(keyHash(key), now);
+}
+
+void EventDedupe::forget(uint64_t keyHash) {
+    for (Generation& generation : generations_) {
+        generation.erase(keyHash);
+    }
+}
+
+bool EventDedupe::firstTime(uint64_t keyHash, Clock::time_point now) {
+    // The tables are allocated on first use, so a stream without
+    // keys costs nothing.
+    if (generations_[0].slots.empty()) {
+        for (Generation& generation : generations_) {
+            generation.slots.assign(tableSize_, 0);
+            generation.started = now;
+        }
+    }
+
+    // Retire generations that have grown too old.
+    Clock::duration age = now - generations_[current_].started;
+    if (age >= 2 * window_) {
+        rotate(now);                    // After a long pause, both generations are stale
+        rotate(now);
+    } else if (age >= window_) {
+        rotate(now);
+    }
+
+    if (generations_[current_].contains(keyHash) || generations_[1 - current_].contains(keyHash)) {
+        ++duplicates_;
+        return false;
+    }
+
+    if (generations_[current_].used >= maxKeys_) {
+        ++earlyRotations_;
+        rotate(now);
+    }
+    generations_[current_].insert(keyHash);
+    return true;
+}
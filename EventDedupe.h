@@ -0,0 +1,109 @@
+//
+// Module 9 - Streams and Files
+// Header File: EventDedupe.h
+// ------------------------------------------------------------
+// Remembers which goal events were already counted, so an event
+// that a feed provider sends twice is only counted once.
+//
+// Events carry an "idempotency key" – any text that is the same
+// every time the SAME event is sent, for example:
+//
+//     Messi,+1,id=m1042-g3
+//
+// Remembering every key forever would use unbounded memory, so
+// keys are only remembered for a time window ("resends arrive
+// within a few minutes"). Two generations of keys are kept:
+//
+//     previous generation   current generation
+//     [ keys from the last  [ keys from this
+//       window ]              window ]         ← new keys go here
+//
+// A key is a duplicate if it is in either generation. When the
+// current generation is older than the window (or full), it
+// becomes the previous one and the old previous one is dropped
+// in O(1). So a key is remembered for at least one full window
+// (unless the generation fills up first – see earlyRotations())
+// and at most two.
+//
+// Each generation is a fixed-size open-addressing hash table of
+// 64-bit key hashes: no allocation per event, O(1) per lookup,
+// and memory is fixed at about 2 x 16-32 bytes x maxKeysPerWindow
+// (allocated when the first key arrives). Storing
+// hashes instead of keys means two different keys could collide,
+// but with 64 bits that is about 1 in 10^7 even after a billion
+// keys.
+//
+// A key is remembered as soon as it is seen, so a repeat inside
+// the same batch is caught too. If the batch then can't be saved,
+// forget() takes its keys back, so the provider's resend counts.
+//
+// Example:
+//   EventDedupe seen(std::chrono::minutes(10), 1 << 20);
+//   if (seen.firstTime("m1042-g3", now)) { count the goal }
+// ------------------------------------------------------------
+
+#pragma once
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+class EventDedupe {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EventDedupe(Clock::duration window, size_t maxKeysPerWindow);
+
+    // ------------------------------------------------------------
+    // Function: firstTime
+    // ------------------------------------------------------------
+    // Returns true (and remembers 'key') the first time a key is
+    // seen within the window; false for a repeat.
+    // ------------------------------------------------------------
+    bool firstTime(std::string_view key, Clock::time_point now);
+
+    // The same for a key that was already hashed with keyHash().
+    bool firstTime(uint64_t keyHash, Clock::time_point now);
+
+    // The hash a key is remembered by (never 0).
+    static uint64_t keyHash(std::string_view key);
+
+    // ------------------------------------------------------------
+    // Function: forget
+    // ------------------------------------------------------------
+    // Removes a key that firstTime() remembered, so it counts as
+    // new the next time it arrives.
+    // ------------------------------------------------------------
+    void forget(uint64_t keyHash);
+
+    uint64_t duplicates() const { return duplicates_; }
+
+    // Rotations forced by a full generation rather than by time.
+    // If this grows, keys are remembered for less than the window.
+    uint64_t earlyRotations() const { return earlyRotations_; }
+
+private:
+    // One generation: hashes stored in a power-of-two table,
+    // 0 meaning "empty slot".
+    struct Generation {
+        std::vector<uint64_t> slots;
+        size_t used = 0;
+        Clock::time_point started;
+
+        bool contains(uint64_t hash) const;
+        void insert(uint64_t hash);
+        void erase(uint64_t hash);
+        void clear(Clock::time_point now);
+    };
+
+    Clock::duration window_;
+    size_t maxKeys_;
+    size_t tableSize_;
+    Generation generations_[2];
+    int current_ = 0;
+    uint64_t duplicates_ = 0;
+    uint64_t earlyRotations_ = 0;
+
+    void rotate(Clock::time_point now);
+};
@@ -0,0 +1,109 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: Executor.cpp
+// ------------------------------------------------------------
+// Thread pool and I/O thread for async Soccer calls (see
+// Executor.h).
+// ------------------------------------------------------------
+
+#include "Executor.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+using namespace std;
+
+// ============================================================
+// ThreadPoolExecutor
+// ============================================================
+
+ThreadPoolExecutor::ThreadPoolExecutor(unsigned threads) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPoolExecutor::run, this);
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (thread& worker : workers_) worker.join();
+}
+
+void ThreadPoolExecutor::post(coroutine_handle<> handle) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        queue_.push_back(handle);
+    }
+    ready_.notify_one();
+}
+
+void ThreadPoolExecutor::run() {
+    for (;;) {
+        coroutine_handle<> next;
+        {
+            unique_lock<mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;   // Stopping, and nothing left to do
+            next = queue_.front();
+            queue_.pop_front();
+        }
+        next.resume();
+    }
+}
+
+// ============================================================
+// IoLoop
+// ============================================================
+
+IoLoop::IoLoop() : thread_(&IoLoop::loop, this) {}
+
+IoLoop::~IoLoop() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+}
+
+void IoLoop::submit(function<void()> job) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        jobs_.push_back(move(job));
+    }
+    ready_.notify_one();
+}
+
+void IoLoop::loop() {
+    for (;;) {
+        function<void()> job;
+        {
+            unique_lock<mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;
+            job = move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+// ============================================================
+// Defaults
+// ============================================================
+
+// The default executor is the process-wide work-stealing pool,
+// so async calls and parallel jobs share the same threads.
+Executor& defaultExecutor() {
+    return TaskScheduler::shared();
+}
+
+IoLoop& defaultIoLoop() {
+    // Create the executor first so it is destroyed last: jobs that
+    // are still running at exit post their coroutines to it.
+    defaultExecutor();
+    static IoLoop io;
+    return io;
+}
@@ -0,0 +1,193 @@
+//
+// Module 9 - Streams and Files
+// Header File: Executor.h
+// ------------------------------------------------------------
+// Where asynchronous Soccer work (see Task.h) actually runs.
+//
+//   Executor            anything that can resume a coroutine
+//                       "somewhere" – the pluggable part. Soccer's
+//                       async functions continue on the executor
+//                       they are given.
+//   ThreadPoolExecutor  a fixed set of threads sharing one queue
+//   IoLoop              ONE dedicated thread for blocking file I/O
+//
+// The split matters for scaling: a coroutine that needs to write
+// soccer.csv doesn't block an executor thread on the disk. It
+// hands the write to the IoLoop and suspends; the executor thread
+// moves on to other clients. When the write completes, the I/O
+// thread posts the coroutine back to its executor, which resumes
+// it. A handful of executor threads can therefore keep thousands
+// of logical clients moving, with only the I/O thread ever waiting
+// on the disk (and Soccer serializes writes anyway).
+//
+// Example:
+//   ThreadPoolExecutor pool(4);
+//   IoLoop io;
+//   league.setAsyncContext(pool, io);
+//   syncWait(league.updatePlayerAsync("Messi", 13));
+// ------------------------------------------------------------
+
+#pragma once
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Task.h"
+
+// ------------------------------------------------------------
+// Class: Executor
+// ------------------------------------------------------------
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    // Arranges for 'handle' to be resumed, soon, on one of this
+    // executor's threads. Must not resume it inline.
+    virtual void post(std::coroutine_handle<> handle) = 0;
+
+    // "co_await executor.schedule()" moves the current coroutine
+    // onto this executor.
+    auto schedule() {
+        struct Awaiter {
+            Executor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor.post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+};
+
+// ------------------------------------------------------------
+// Class: ThreadPoolExecutor
+// ------------------------------------------------------------
+// 'threads' = 0 starts one thread per CPU. The destructor finishes
+// every coroutine already posted, then joins the threads.
+// ------------------------------------------------------------
+class ThreadPoolExecutor : public Executor {
+public:
+    explicit ThreadPoolExecutor(unsigned threads = 0);
+    ~ThreadPoolExecutor() override;
+
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    void post(std::coroutine_handle<> handle) override;
+    size_t threadCount() const { return workers_.size(); }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::coroutine_handle<>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    void run();
+};
+
+// ------------------------------------------------------------
+// Class: IoLoop
+// ------------------------------------------------------------
+// Runs blocking jobs one at a time, in order, on its own thread.
+// The destructor finishes the jobs already submitted.
+// ------------------------------------------------------------
+class IoLoop {
+public:
+    IoLoop();
+    ~IoLoop();
+
+    IoLoop(const IoLoop&) = delete;
+    IoLoop& operator=(const IoLoop&) = delete;
+
+    void submit(std::function<void()> job);
+
+    // ------------------------------------------------------------
+    // Function: run
+    // ------------------------------------------------------------
+    // "co_await io.run(executor, work)" runs work() on the I/O
+    // thread and resumes the caller on 'executor' with its result
+    // (or its exception).
+    // ------------------------------------------------------------
+    template <typename Work>
+    auto run(Executor& executor, Work work);
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::function<void()>> jobs_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void loop();
+};
+
+template <typename Work>
+auto IoLoop::run(Executor& executor, Work work) {
+    using Result = std::invoke_result_t<Work&>;
+    using Stored = std::conditional_t<std::is_void_v<Result>, bool, Result>;
+
+    struct Awaiter {
+        IoLoop& io;
+        Executor& executor;
+        Work work;
+        std::optional<Stored> result;
+        std::exception_ptr error;
+
+        bool await_ready() const noexcept { return false; }
+
+        // The awaiter lives in the suspended coroutine's frame, so
+        // the I/O thread may safely write into it until it posts the
+        // coroutine back.
+        void await_suspend(std::coroutine_handle<> handle) {
+            io.submit([this, handle] {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        work();
+                        result.emplace(true);
+                    } else {
+                        result.emplace(work());
+                    }
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                executor.post(handle);
+            });
+        }
+
+        Result await_resume() {
+            if (error) std::rethrow_exception(error);
+            if constexpr (!std::is_void_v<Result>) return std::move(*result);
+        }
+    };
+    return Awaiter{*this, executor, std::move(work), std::nullopt, nullptr};
+}
+
+// Shared defaults, started on first use: the process-wide
+// TaskScheduler (see TaskScheduler.h), and one I/O thread.
+Executor& defaultExecutor();
+IoLoop& defaultIoLoop();
+
+// ------------------------------------------------------------
+// Function: spawn
+// ------------------------------------------------------------
+// Starts 'task' on 'executor' and returns immediately; nobody
+// waits for it. An exception escaping the task ends the program,
+// so catch what you expect inside it.
+// ------------------------------------------------------------
+namespace TaskDetail {
+inline Detached runOn(Executor& executor, Task<void> task) {
+    co_await executor.schedule();
+    co_await task;
+}
+} // namespace TaskDetail
+
+inline void spawn(Executor& executor, Task<void> task) {
+    TaskDetail::runOn(executor, std::move(task));
+}
@@ -0,0 +1,272 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: FileChecksum.cpp
+// ------------------------------------------------------------
+// CRC32C block checksums for data files (see FileChecksum.h).
+// ------------------------------------------------------------
+
+#include "FileChecksum.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FILE_CHECKSUM_X86 1
+#endif
+using namespace std;
+
+namespace FileChecksum {
+
+namespace {
+
+constexpr char kHeader[] = "crc32c";
+
+// Blocks handed to one task at a time by verifyFile() (1 MB).
+constexpr size_t kBlocksPerTask = 16;
+
+// ------------------------------------------------------------
+// Helper Function: tableCrc
+// ------------------------------------------------------------
+// One byte per step, using a 256-entry table built on first use
+// (0x82F63B78 is the CRC32C polynomial, bit-reversed).
+// ------------------------------------------------------------
+uint32_t tableCrc(uint32_t crc, const unsigned char* p, size_t n) {
+    static const array<uint32_t, 256> table = [] {
+        array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    for (size_t i = 0; i < n; ++i) {
+        crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef FILE_CHECKSUM_X86
+// ------------------------------------------------------------
+// Helper Function: hardwareCrc
+// ------------------------------------------------------------
+// The SSE4.2 crc32 instruction takes 8 bytes at a time. Like
+// GoalAggregates' AVX2 kernel, only this function is compiled
+// for SSE4.2, so the program still starts on older CPUs.
+// ------------------------------------------------------------
+__attribute__((target("sse4.2")))
+uint32_t hardwareCrc(uint32_t crc, const unsigned char* p, size_t n) {
+    uint64_t c = crc;
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);   // No alignment needed
+        c = _mm_crc32_u64(c, word);
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    for (; n > 0; ++p, --n) {
+        c32 = _mm_crc32_u8(c32, *p);
+    }
+    return c32;
+}
+#endif
+
+// Reads exactly 'n' bytes at 'offset', or fewer at the end of the file.
+size_t readAt(int fd, char* buffer, size_t n, uint64_t offset) {
+    size_t done = 0;
+    while (done < n) {
+        ssize_t got = pread(fd, buffer + done, n - done, static_cast<off_t>(offset + done));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        done += static_cast<size_t>(got);
+    }
+    return done;
+}
+
+bool parseBlock(string_view line, Block& block) {
+    const char* p = line.data();
+    const char* end = line.data() + line.size();
+
+    auto r = from_chars(p, end, block.offset);
+    if (r.ec != errc() || r.ptr == end || *r.ptr != ',') return false;
+    r = from_chars(r.ptr + 1, end, block.length);
+    if (r.ec != errc() || r.ptr == end || *r.ptr != ',') return false;
+    r = from_chars(r.ptr + 1, end, block.crc, 16);
+    return r.ec == errc() && r.ptr == end;
+}
+
+void formatBlock(ostream& out, const Block& block) {
+    char crc[9];
+    auto r = to_chars(crc, crc + 8, block.crc, 16);
+    out << block.offset << ',' << block.length << ',';
+    for (ptrdiff_t pad = 8 - (r.ptr - crc); pad > 0; --pad) out << '0';
+    out.write(crc, r.ptr - crc);
+    out << '\n';
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+// Function: crc32c
+// ------------------------------------------------------------
+// The bits are inverted on the way in and out (part of the CRC32C
+// definition), which is also what lets a result be continued.
+// ------------------------------------------------------------
+uint32_t crc32c(const void* data, size_t n, uint32_t crc) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef FILE_CHECKSUM_X86
+    static const bool hasSse42 = __builtin_cpu_supports("sse4.2");
+    if (hasSse42) return ~hardwareCrc(crc, p, n);
+#endif
+    return ~tableCrc(crc, p, n);
+}
+
+Block makeBlock(uint64_t offset, string_view bytes) {
+    return {offset, bytes.size(), crc32c(bytes.data(), bytes.size())};
+}
+
+string sidecarPath(const string& file) {
+    return file + ".crc";
+}
+
+// ------------------------------------------------------------
+// Function: saveBlocks
+// Stream used: ofstream (output file stream)
+// ------------------------------------------------------------
+bool saveBlocks(const string& sidecar, const vector<Block>& blocks) {
+    {
+        ofstream out(sidecar, ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << kHeader << '\n';
+        for (const Block& block : blocks) {
+            formatBlock(out, block);
+        }
+        if (!out.flush()) {
+            return false;
+        }
+    }   // 'out' closes here
+
+    int fd = open(sidecar.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+}
+
+bool appendBlock(const string& sidecar, const Block& block) {
+    if (access(sidecar.c_str(), F_OK) != 0) {
+        return true;            // The data file isn't checked
+    }
+    ofstream out(sidecar, ios::app);
+    if (!out) {
+        return false;
+    }
+    formatBlock(out, block);
+    return static_cast<bool>(out.flush());
+}
+
+// ------------------------------------------------------------
+// Function: loadBlocks
+// Stream used: ifstream (input file stream)
+// ------------------------------------------------------------
+bool loadBlocks(const string& sidecar, vector<Block>& blocks) {
+    ifstream in(sidecar);
+    string line;
+    if (!in || !getline(in, line) || line != kHeader) {
+        return false;
+    }
+
+    while (getline(in, line)) {
+        Block block;
+        if (parseBlock(line, block)) blocks.push_back(block);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: verifyFile
+// ------------------------------------------------------------
+// Every task reads its blocks with pread() into its own buffer, so
+// the tasks never share a file position and run fully in parallel.
+// A block that runs past the end of the file was cut short and
+// counts as damaged without being read.
+// ------------------------------------------------------------
+Report verifyFile(const string& path) {
+    Report report;
+    vector<Block> blocks;
+    if (!loadBlocks(sidecarPath(path), blocks)) {
+        return report;
+    }
+    report.checked = true;
+    report.blocks = blocks.size();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) < 0) {
+        if (fd >= 0) close(fd);
+        return report;          // The caller finds out it can't read the file
+    }
+    uint64_t size = static_cast<uint64_t>(info.st_size);
+
+    vector<char> bad(blocks.size(), 0);
+    TaskScheduler::shared().parallelFor(0, blocks.size(), kBlocksPerTask, [&](size_t first, size_t last) {
+        vector<char> buffer;
+        for (size_t i = first; i < last; ++i) {
+            const Block& block = blocks[i];
+            if (block.offset > size || block.length > size - block.offset) {
+                bad[i] = 1;
+                continue;
+            }
+            buffer.resize(block.length);
+            size_t got = readAt(fd, buffer.data(), block.length, block.offset);
+            bad[i] = got != block.length || crc32c(buffer.data(), got) != block.crc;
+        }
+    });
+    close(fd);
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        report.bytes += blocks[i].length;
+        if (bad[i]) {
+            uint64_t end = min(size, blocks[i].offset + blocks[i].length);
+            report.damaged.push_back({min(size, blocks[i].offset), end});
+        }
+    }
+    sort(report.damaged.begin(), report.damaged.end());
+    return report;
+}
+
+// ------------------------------------------------------------
+// Function: BlockWriter
+// ------------------------------------------------------------
+void BlockWriter::addLine(string_view line) {
+    pending_.append(line);
+    pending_ += '\n';
+    if (pending_.size() >= kBlockBytes) writePending();
+}
+
+bool BlockWriter::finish() {
+    if (!pending_.empty()) writePending();
+    return static_cast<bool>(out_);
+}
+
+void BlockWriter::writePending() {
+    blocks_.push_back(makeBlock(written_, pending_));
+    out_.write(pending_.data(), static_cast<streamsize>(pending_.size()));
+    written_ += pending_.size();
+    pending_.clear();
+}
+
+} // namespace FileChecksum
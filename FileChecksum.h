@@ -0,0 +1,134 @@
+//
+// Module 9 - Streams and Files
+// Header File: FileChecksum.h
+// ------------------------------------------------------------
+// Block checksums for the data files, so a damaged part of a file
+// is noticed instead of being read as players without a word.
+//
+// A file is cut into blocks of about 64 KB, always at the end of a
+// line. The CRC32C checksum of every block is kept in a small text
+// file next to it (soccer.csv → soccer.csv.crc), one block per line:
+//
+//     crc32c
+//     0,65544,9a3c01f2        → bytes 0..65543 have checksum 9a3c01f2
+//     65544,40011,5b7e44d0
+//     105555,10,0c1d2e3f      → one appended line ("Messi,12\n")
+//
+// soccer.csv itself stays plain "Name,Goals" text that any program
+// (or person) can read. A file without a .crc file – an old one,
+// or one written by another program – is simply not checked, and
+// bytes that no block covers are accepted as they are.
+//
+// A mismatch says that a block changed – a hand edit changes it
+// too – not which of its lines are wrong. So readers only warn
+// about it and still read every line that makes sense; the next
+// rewrite of the file (or Soccer::repair()) stores new checksums.
+//
+// CRC32C is used because x86 CPUs with SSE4.2 compute it with one
+// instruction per 8 bytes. The CPU is checked at run time; older
+// machines use a lookup table instead. verifyFile() checks the
+// blocks in parallel on the shared TaskScheduler, so checking a
+// big file takes about as long as reading it.
+//
+// Example:
+//   FileChecksum::Report report = FileChecksum::verifyFile("soccer.csv");
+//   if (!report.ok()) std::cerr << report.damaged.size() << " damaged blocks\n";
+// ------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace FileChecksum {
+
+// Blocks are cut at the first line end after this many bytes.
+constexpr size_t kBlockBytes = 64 * 1024;
+
+struct Block {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    uint32_t crc = 0;
+};
+
+// ------------------------------------------------------------
+// Function: crc32c
+// ------------------------------------------------------------
+// The CRC32C (Castagnoli) checksum of 'n' bytes. Pass a previous
+// result as 'crc' to continue it:
+//   crc32c(b, nb, crc32c(a, na)) == crc32c(a followed by b)
+// ------------------------------------------------------------
+uint32_t crc32c(const void* data, size_t n, uint32_t crc = 0);
+
+// The block for 'bytes', which start at 'offset' in the file.
+Block makeBlock(uint64_t offset, std::string_view bytes);
+
+// "soccer.csv" → "soccer.csv.crc"
+std::string sidecarPath(const std::string& file);
+
+// ------------------------------------------------------------
+// Function: saveBlocks / appendBlock / loadBlocks
+// ------------------------------------------------------------
+//   saveBlocks  → writes a whole checksum file (and fsyncs it)
+//   appendBlock → adds one block to an existing checksum file; does
+//                 nothing if there is none (the data file is then
+//                 unchecked until it is rewritten)
+//   loadBlocks  → reads one; false if it doesn't exist or isn't a
+//                 checksum file. Damaged lines (e.g. a half-written
+//                 last one) are skipped: those bytes are unchecked.
+// ------------------------------------------------------------
+bool saveBlocks(const std::string& sidecar, const std::vector<Block>& blocks);
+bool appendBlock(const std::string& sidecar, const Block& block);
+bool loadBlocks(const std::string& sidecar, std::vector<Block>& blocks);
+
+// ------------------------------------------------------------
+// Struct: Report
+// ------------------------------------------------------------
+//   checked → the file has a checksum file
+//   blocks  → blocks it lists
+//   bytes   → bytes those blocks cover
+//   damaged → [begin, end) byte range of every block whose checksum
+//             doesn't match (or that runs past the end of the
+//             file), in file order
+// ------------------------------------------------------------
+struct Report {
+    bool checked = false;
+    size_t blocks = 0;
+    uint64_t bytes = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> damaged;
+
+    bool ok() const { return damaged.empty(); }
+};
+
+// Checks every block of 'path' against its checksum file.
+Report verifyFile(const std::string& path);
+
+// ------------------------------------------------------------
+// Class: BlockWriter
+// ------------------------------------------------------------
+// Writes lines to 'out' one block at a time and remembers each
+// block's checksum. Call finish() after the last line.
+// ------------------------------------------------------------
+class BlockWriter {
+public:
+    explicit BlockWriter(std::ostream& out) : out_(out) {}
+
+    void addLine(std::string_view line);   // Adds the '\n' itself
+    bool finish();                         // False if a write failed
+
+    const std::vector<Block>& blocks() const { return blocks_; }
+
+private:
+    std::ostream& out_;
+    std::string pending_;
+    uint64_t written_ = 0;
+    std::vector<Block> blocks_;
+
+    void writePending();
+};
+
+} // namespace FileChecksum
@@ -0,0 +1,140 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: FormTracker.cpp
+// ------------------------------------------------------------
+// Sliding-window "form" leaderboards (see FormTracker.h).
+// ------------------------------------------------------------
+
+#include "FormTracker.h"
+#include <algorithm>
+#include <iterator>
+using namespace std;
+
+bool FormTracker::MostGoalsFirst::operator()(const pair<int, uint32_t>& a,
+                                             const pair<int, uint32_t>& b) const {
+    if (a.first != b.first) return a.first > b.first;
+    return (*players)[a.second].name < (*players)[b.second].name;
+}
+
+FormTracker::FormTracker(size_t matchWindow, uint32_t dayWindow)
+    : matchWindow_(max<size_t>(1, matchWindow)),
+      dayWindow_(max<uint32_t>(1, dayWindow)),
+      byMatches_(MostGoalsFirst{&players_}),
+      byDays_(MostGoalsFirst{&players_}) {}
+
+uint32_t FormTracker::playerId(string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(players_.size());
+    players_.push_back({string(name), 0, 0});
+    ids_.emplace(string(name), id);
+    return id;
+}
+
+void FormTracker::add(string_view player, uint32_t match, uint32_t day, int delta) {
+    if (match == 0 || delta == 0) return;
+
+    uint32_t id = playerId(player);
+    addToMatches(id, match, delta);
+    addToDays(id, day, delta);
+}
+
+// ------------------------------------------------------------
+// Helper Function: addToMatches
+// ------------------------------------------------------------
+// The window is tiny (5 buckets by default) and events almost
+// always belong to the newest match, so the bucket is searched
+// from the back. A new match id beyond the window pushes the
+// oldest bucket out, and its goals are subtracted.
+// ------------------------------------------------------------
+void FormTracker::addToMatches(uint32_t id, uint32_t match, int delta) {
+    size_t i = matches_.size();
+    while (i > 0 && matches_[i - 1].match > match) --i;
+
+    if (i > 0 && matches_[i - 1].match == match) {
+        --i;
+    } else {
+        if (i == 0 && matches_.size() == matchWindow_) return;   // Older than the window
+        matches_.insert(matches_.begin() + i, {match, {}});
+        if (matches_.size() > matchWindow_) {
+            for (const auto& entry : matches_.front().goals) {
+                setScore(byMatches_, &Player::matchGoals, entry.first,
+                         players_[entry.first].matchGoals - entry.second);
+            }
+            matches_.pop_front();
+            --i;
+        }
+    }
+
+    matches_[i].goals[id] += delta;
+    setScore(byMatches_, &Player::matchGoals, id, players_[id].matchGoals + delta);
+}
+
+// ------------------------------------------------------------
+// Helper Function: addToDays
+// ------------------------------------------------------------
+void FormTracker::addToDays(uint32_t id, uint32_t day, int delta) {
+    // A newer day moves the window forward first.
+    if (days_.empty() || day > days_.back().day) {
+        expireDays(day);
+    } else {
+        uint32_t newest = days_.back().day;
+        uint32_t oldest = newest >= dayWindow_ ? newest - dayWindow_ + 1 : 0;
+        if (day < oldest) return;   // Already outside the window
+    }
+
+    // Events almost always belong to the newest bucket, so search
+    // from the back.
+    auto bucket = days_.end();
+    while (bucket != days_.begin() && prev(bucket)->day > day) --bucket;
+    if (bucket != days_.begin() && prev(bucket)->day == day) {
+        --bucket;
+    } else {
+        bucket = days_.insert(bucket, {day, {}});
+    }
+
+    bucket->goals[id] += delta;
+    setScore(byDays_, &Player::dayGoals, id, players_[id].dayGoals + delta);
+}
+
+// ------------------------------------------------------------
+// Helper Function: expireDays
+// ------------------------------------------------------------
+// Each bucket is subtracted exactly once, when it leaves the
+// window, so the cost is spread over the events that filled it.
+// ------------------------------------------------------------
+void FormTracker::expireDays(uint32_t today) {
+    uint32_t oldest = today >= dayWindow_ ? today - dayWindow_ + 1 : 0;
+    while (!days_.empty() && days_.front().day < oldest) {
+        for (const auto& entry : days_.front().goals) {
+            setScore(byDays_, &Player::dayGoals, entry.first, players_[entry.first].dayGoals - entry.second);
+        }
+        days_.pop_front();
+    }
+}
+
+void FormTracker::setScore(Ranking& ranking, int Player::*score, uint32_t id, int goals) {
+    int& current = players_[id].*score;
+    if (current == goals) return;
+
+    if (current != 0) ranking.erase({current, id});
+    current = goals;
+    if (current != 0) ranking.insert({current, id});
+}
+
+// ------------------------------------------------------------
+// Function: top
+// ------------------------------------------------------------
+vector<pair<string, int>> FormTracker::top(FormWindow window, size_t k, uint32_t today) {
+    if (window == FormWindow::DAYS) {
+        expireDays(today);
+    }
+    const Ranking& ranking = (window == FormWindow::MATCHES) ? byMatches_ : byDays_;
+
+    vector<pair<string, int>> result;
+    for (auto it = ranking.begin(); it != ranking.end() && result.size() < k; ++it) {
+        result.push_back({players_[it->second].name, it->first});
+    }
+    return result;
+}
@@ -0,0 +1,113 @@
+//
+// Module 9 - Streams and Files
+// Header File: FormTracker.h
+// ------------------------------------------------------------
+// "Who is in form?" – goals scored recently, as opposed to the
+// all-time totals in soccer.csv. Two windows are tracked:
+//
+//   MATCHES  goals in the league's last 5 matches
+//   DAYS     goals in the last 30 days
+//
+// Both are kept up to date one event at a time, so a leaderboard
+// query never goes back to the goal history:
+//
+//   - Goals per match are kept in one bucket per match id, for
+//     the newest 5 match ids seen in the whole league. When a
+//     newer match arrives, the oldest bucket is subtracted from
+//     the players it mentions and thrown away – so a player who
+//     stops scoring drops out once 5 newer matches were played.
+//
+//   - Goals per day work the same way, one bucket per day. When
+//     a day falls out of the window, its bucket is subtracted.
+//
+//   - Each window keeps its players in a sorted set (most goals
+//     first), updated whenever a score changes (O(log n)). The
+//     top k are then just the first k entries of the set: O(k).
+//
+// Match 0 ("not a match" – opening balances and corrections in the
+// goal history) is ignored. Match ids are expected to grow over
+// time; a late event for a match that has already left the window
+// is ignored.
+//
+// Not thread-safe; Soccer protects it with its own mutex.
+//
+// Example:
+//   FormTracker form;
+//   form.add("Messi", 7, currentDay(), 1);
+//   auto hot = form.top(FormWindow::MATCHES, 10, currentDay());
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "Soccer.h"   // for NameHash and FormWindow
+
+class FormTracker {
+public:
+    explicit FormTracker(size_t matchWindow = 5, uint32_t dayWindow = 30);
+
+    // Adds one goal event (a match-0 event is ignored).
+    void add(std::string_view player, uint32_t match, uint32_t day, int delta);
+
+    // ------------------------------------------------------------
+    // Function: top
+    // ------------------------------------------------------------
+    // The 'k' players with the most goals in the window, most
+    // first (ties by name). For DAYS, days before
+    // 'today - dayWindow + 1' are dropped first.
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> top(FormWindow window, size_t k, uint32_t today);
+
+private:
+    struct Player {
+        std::string name;
+        int matchGoals = 0;
+        int dayGoals = 0;
+    };
+
+    // Orders (goals, player id) by goals (most first), then name.
+    struct MostGoalsFirst {
+        const std::vector<Player>* players;
+        bool operator()(const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) const;
+    };
+    using Ranking = std::set<std::pair<int, uint32_t>, MostGoalsFirst>;
+
+    // All goals scored in one match, per player id.
+    struct MatchBucket {
+        uint32_t match;
+        std::unordered_map<uint32_t, int> goals;
+    };
+
+    // All goals scored on one day, per player id.
+    struct DayBucket {
+        uint32_t day;
+        std::unordered_map<uint32_t, int> goals;
+    };
+
+    size_t matchWindow_;
+    uint32_t dayWindow_;
+
+    std::vector<Player> players_;
+    std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> ids_;
+    Ranking byMatches_;
+    Ranking byDays_;
+    std::deque<MatchBucket> matches_;   // Oldest first, at most matchWindow_ buckets
+    std::deque<DayBucket> days_;         // Oldest first, at most dayWindow_ buckets
+
+    uint32_t playerId(std::string_view name);
+    void addToMatches(uint32_t id, uint32_t match, int delta);
+    void addToDays(uint32_t id, uint32_t day, int delta);
+    void expireDays(uint32_t today);
+
+    // Moves a player to their new place in 'ranking'. Players with
+    // zero goals in the window are left out of it.
+    void setScore(Ranking& ranking, int Player::*score, uint32_t id, int goals);
+};
@@ -0,0 +1,126 @@
+//
+// Module 9 - Streams and Files
+// Header File: Generator.h
+// ------------------------------------------------------------
+// A minimal C++20 coroutine generator: a function that produces a
+// sequence of values one at a time with co_yield, and a range-for
+// loop that pulls them out.
+//
+//   Generator<int> countTo(int n) {
+//       for (int i = 1; i <= n; ++i) co_yield i;
+//   }
+//
+//   for (int i : countTo(3)) cout << i;   // 123
+//
+// Nothing runs until the loop asks for the first value, and the
+// function is paused at each co_yield until the loop asks for the
+// next one. So a generator never builds a container of results,
+// and a loop that stops early (break) never pays for the rest.
+// When the Generator object is destroyed, the paused function is
+// destroyed too, running the destructors of its local variables
+// (for example, releasing a lock it holds).
+//
+// Values are yielded by reference: each one is valid until the
+// loop moves on to the next.
+//
+// A Generator is also a std::ranges view, so it can be piped into
+// std::views::filter, take, ... like any other range.
+//
+// (std::generator only arrives in C++23.)
+// ------------------------------------------------------------
+
+#pragma once
+#include <coroutine>
+#include <ranges>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+template <typename T>
+class Generator : public std::ranges::view_base {
+public:
+    struct promise_type {
+        const T* current = nullptr;
+        std::exception_ptr error;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }   // Lazy start
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { error = std::current_exception(); }
+
+        // co_await isn't meaningful inside a generator.
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    // Input iterator: ++ resumes the coroutine up to its next co_yield.
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(Handle handle) : handle_(handle) {}
+
+        const T& operator*() const { return *handle_.promise().current; }
+        const T* operator->() const { return handle_.promise().current; }
+
+        iterator& operator++() {
+            advance(handle_);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return !it.handle_ || it.handle_.done();
+        }
+
+    private:
+        Handle handle_ = nullptr;
+    };
+
+    Generator(Generator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    ~Generator() {
+        if (handle_) handle_.destroy();
+    }
+
+    // Runs the coroutine up to its first co_yield.
+    iterator begin() {
+        if (handle_) advance(handle_);
+        return iterator(handle_);
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    Handle handle_;
+
+    explicit Generator(Handle handle) : handle_(handle) {}
+
+    // Resumes the coroutine, passing on any exception it threw.
+    static void advance(Handle handle) {
+        handle.resume();
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+    }
+};
@@ -0,0 +1,248 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: GoalAggregates.cpp
+// ------------------------------------------------------------
+// SIMD + multi-threaded statistics over the goals column (see
+// GoalAggregates.h).
+// ------------------------------------------------------------
+
+#include "GoalAggregates.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include "TaskScheduler.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GOAL_AGGREGATES_X86 1
+#endif
+using namespace std;
+
+namespace GoalAggregates {
+
+namespace {
+
+// Below this many values per thread, starting threads costs more
+// than it saves.
+constexpr size_t MIN_VALUES_PER_THREAD = 1 << 18;
+
+// Counters allowed per value. percentiles() only counts when the
+// range of values is at most this many times n (a few hundred
+// players with one 10-million-goal typo shouldn't allocate 80 MB),
+// and histogram() uses fewer threads rather than give each one
+// its own copy of a range that is large next to its slice.
+constexpr size_t COUNTERS_PER_VALUE = 4;
+
+// What one slice contributes. Sums are exact 64-bit integers, so
+// merging slices in any order gives the same answer.
+struct Partial {
+    size_t count = 0;
+    int64_t sum = 0;
+    int64_t sumOfSquares = 0;
+    int min = INT_MAX;
+    int max = INT_MIN;
+
+    void merge(const Partial& other) {
+        count += other.count;
+        sum += other.sum;
+        sumOfSquares += other.sumOfSquares;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+};
+
+// The plain loop: also handles the last few values the SIMD loop
+// leaves over.
+Partial scalarKernel(const int* goals, size_t n) {
+    Partial p;
+    p.count = n;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t value = goals[i];
+        p.sum += value;
+        p.sumOfSquares += value * value;
+        p.min = std::min(p.min, goals[i]);
+        p.max = std::max(p.max, goals[i]);
+    }
+    return p;
+}
+
+#ifdef GOAL_AGGREGATES_X86
+// ------------------------------------------------------------
+// Helper Function: avx2Kernel
+// ------------------------------------------------------------
+// 8 ints per step. Sums and squares are widened to 64 bits (4 per
+// register) so they can't overflow; min/max stay 32-bit.
+// The target attribute lets this one function use AVX2 without
+// compiling the whole program for it.
+// ------------------------------------------------------------
+__attribute__((target("avx2")))
+Partial avx2Kernel(const int* goals, size_t n) {
+    __m256i minimum = _mm256_set1_epi32(INT_MAX);
+    __m256i maximum = _mm256_set1_epi32(INT_MIN);
+    __m256i sums = _mm256_setzero_si256();
+    __m256i squares = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(goals + i));
+        minimum = _mm256_min_epi32(minimum, v);
+        maximum = _mm256_max_epi32(maximum, v);
+
+        __m256i low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v));
+        __m256i high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1));
+        sums = _mm256_add_epi64(sums, _mm256_add_epi64(low, high));
+        squares = _mm256_add_epi64(squares, _mm256_mul_epi32(low, low));
+        squares = _mm256_add_epi64(squares, _mm256_mul_epi32(high, high));
+    }
+
+    // Fold the lanes into single numbers.
+    alignas(32) int32_t mins[8], maxs[8];
+    alignas(32) int64_t sumLanes[4], squareLanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mins), minimum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), maximum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sumLanes), sums);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(squareLanes), squares);
+
+    Partial p = scalarKernel(goals + i, n - i);
+    p.count = n;
+    for (int lane = 0; lane < 8; ++lane) {
+        p.min = std::min(p.min, mins[lane]);
+        p.max = std::max(p.max, maxs[lane]);
+    }
+    for (int lane = 0; lane < 4; ++lane) {
+        p.sum += sumLanes[lane];
+        p.sumOfSquares += squareLanes[lane];
+    }
+    return p;
+}
+#endif
+
+Partial kernel(const int* goals, size_t n) {
+#ifdef GOAL_AGGREGATES_X86
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) return avx2Kernel(goals, n);
+#endif
+    return scalarKernel(goals, n);
+}
+
+unsigned threadCount(size_t n, unsigned threads) {
+    // The shared scheduler's workers plus the calling thread.
+    if (threads == 0) threads = TaskScheduler::shared().workerCount() + 1;
+    return static_cast<unsigned>(max<size_t>(1, min<size_t>(threads, n / MIN_VALUES_PER_THREAD)));
+}
+
+// ------------------------------------------------------------
+// Helper Function: forEachSlice
+// ------------------------------------------------------------
+// Calls work(slice, begin, end) for 'threads' equal slices of
+// [0, n), in parallel on the shared TaskScheduler.
+// ------------------------------------------------------------
+template <typename Work>
+void forEachSlice(size_t n, unsigned threads, Work work) {
+    size_t slice = (n + threads - 1) / threads;
+    TaskScheduler::shared().parallelFor(0, threads, 1, [&](size_t first, size_t last) {
+        for (size_t t = first; t < last; ++t) {
+            work(static_cast<unsigned>(t), t * slice, min(n, (t + 1) * slice));
+        }
+    });
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+// Function: summarize
+// ------------------------------------------------------------
+GoalSummary summarize(const int* goals, size_t n, unsigned threads) {
+    GoalSummary summary;
+    if (n == 0) return summary;
+
+    threads = threadCount(n, threads);
+    vector<Partial> partials(threads);
+    forEachSlice(n, threads, [&](unsigned t, size_t begin, size_t end) {
+        partials[t] = kernel(goals + begin, end - begin);
+    });
+
+    Partial total;
+    for (const Partial& p : partials) total.merge(p);
+
+    summary.count = total.count;
+    summary.sum = total.sum;
+    summary.min = total.min;
+    summary.max = total.max;
+    summary.mean = double(total.sum) / n;
+    // E[x²] - E[x]², from exact integer sums.
+    summary.variance = max(0.0, double(total.sumOfSquares) / n - summary.mean * summary.mean);
+    return summary;
+}
+
+// ------------------------------------------------------------
+// Function: histogram
+// ------------------------------------------------------------
+// Each thread counts into its own array; the arrays are added at
+// the end, so no two threads ever write the same counter.
+// ------------------------------------------------------------
+bool histogram(const int* goals, size_t n, GoalHistogram& result, size_t maxRange, unsigned threads) {
+    result = GoalHistogram();
+    if (n == 0) return true;
+
+    GoalSummary summary = summarize(goals, n, threads);
+    size_t range = size_t(int64_t(summary.max) - summary.min) + 1;
+    if (range > maxRange) return false;
+
+    threads = threadCount(n, threads);
+    threads = static_cast<unsigned>(max<size_t>(1, min<size_t>(threads, COUNTERS_PER_VALUE * n / range)));
+    vector<vector<uint64_t>> partials(threads);
+    forEachSlice(n, threads, [&](unsigned t, size_t begin, size_t end) {
+        vector<uint64_t> counts(range, 0);
+        for (size_t i = begin; i < end; ++i) {
+            ++counts[size_t(int64_t(goals[i]) - summary.min)];
+        }
+        partials[t] = move(counts);
+    });
+
+    result.min = summary.min;
+    result.counts = move(partials[0]);
+    for (unsigned t = 1; t < threads; ++t) {
+        for (size_t i = 0; i < range; ++i) result.counts[i] += partials[t][i];
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: percentiles
+// ------------------------------------------------------------
+vector<int> percentiles(const int* goals, size_t n, const vector<double>& ps, unsigned threads) {
+    vector<int> values;
+    if (n == 0) return vector<int>(ps.size(), 0);
+
+    // Rank of percentile p among n values (1-based, nearest rank).
+    auto rankOf = [n](double p) {
+        double clamped = min(100.0, max(0.0, p));
+        return max<size_t>(1, size_t(ceil(clamped / 100.0 * n)));
+    };
+
+    GoalHistogram counts;
+    size_t maxRange = min(size_t(1) << 24, COUNTERS_PER_VALUE * n);
+    if (histogram(goals, n, counts, maxRange, threads)) {
+        for (double p : ps) {
+            size_t rank = rankOf(p);
+            uint64_t seen = 0;
+            size_t i = 0;
+            while (i + 1 < counts.counts.size() && seen + counts.counts[i] < rank) {
+                seen += counts.counts[i++];
+            }
+            values.push_back(counts.min + int(i));
+        }
+        return values;
+    }
+
+    // Values spread too widely to count: select on a copy instead.
+    vector<int> copy(goals, goals + n);
+    for (double p : ps) {
+        auto nth = copy.begin() + (rankOf(p) - 1);
+        nth_element(copy.begin(), nth, copy.end());
+        values.push_back(*nth);
+    }
+    return values;
+}
+
+} // namespace GoalAggregates
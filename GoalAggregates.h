@@ -0,0 +1,84 @@
+//
+// Module 9 - Streams and Files
+// Header File: GoalAggregates.h
+// ------------------------------------------------------------
+// Statistics over a whole column of goal counts: count, sum,
+// mean, min, max, variance, a histogram and percentiles.
+//
+// Soccer keeps every goal count in one contiguous std::vector<int>
+// (see "In-memory player table" in Soccer.h), which is exactly
+// what these kernels need:
+//
+//   - SIMD: with AVX2, 8 goal counts are added / compared / squared
+//     per instruction. The CPU is checked at run time, so the same
+//     program still runs (with the plain loop) on older machines.
+//
+//   - Threads: a large column is cut into one slice per thread of
+//     the shared TaskScheduler (see TaskScheduler.h); each slice is
+//     summarized on its own and the partial results are merged
+//     (sums add up, min of mins, max of maxes).
+//
+//   - Counting: goal counts are small integers, so percentiles
+//     don't need sorting. One pass counts how many players have
+//     each goal count (a histogram); a percentile is then found by
+//     walking the counts. O(n + range) instead of O(n log n), so
+//     it is only used while the range is at most a few times n.
+//
+// Example:
+//   GoalSummary s = GoalAggregates::summarize(goals.data(), goals.size());
+//   auto p = GoalAggregates::percentiles(goals.data(), goals.size(), {50, 90, 99});
+// ------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct GoalSummary {
+    size_t count = 0;
+    int64_t sum = 0;
+    int min = 0;
+    int max = 0;
+    double mean = 0;
+    double variance = 0;     // Population variance
+};
+
+// How many players have each goal count: counts[i] is the number
+// of players with exactly 'min + i' goals.
+struct GoalHistogram {
+    int min = 0;
+    std::vector<uint64_t> counts;
+};
+
+namespace GoalAggregates {
+
+// ------------------------------------------------------------
+// Function: summarize
+// ------------------------------------------------------------
+// Count, sum, min, max, mean and variance in one pass. 'threads'
+// = 0 picks one thread per CPU for large inputs.
+// ------------------------------------------------------------
+GoalSummary summarize(const int* goals, size_t n, unsigned threads = 0);
+
+// ------------------------------------------------------------
+// Function: histogram
+// ------------------------------------------------------------
+// Counts players per goal count. Returns false (and leaves
+// 'result' empty) if the values spread over more than
+// 'maxRange' different counts.
+// ------------------------------------------------------------
+bool histogram(const int* goals, size_t n, GoalHistogram& result,
+               size_t maxRange = size_t(1) << 24, unsigned threads = 0);
+
+// ------------------------------------------------------------
+// Function: percentiles
+// ------------------------------------------------------------
+// The goal count at each percentile p (0-100), "nearest rank"
+// style: the smallest value with at least p% of players at or
+// below it. Uses the histogram, or selection (nth_element) if the
+// range is more than 4 × n.
+// ------------------------------------------------------------
+std::vector<int> percentiles(const int* goals, size_t n, const std::vector<double>& ps,
+                             unsigned threads = 0);
+
+} // namespace GoalAggregates
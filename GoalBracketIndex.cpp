@@ -0,0 +1,65 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: GoalBracketIndex.cpp
+// ------------------------------------------------------------
+// Bitmap index over goal brackets (see GoalBracketIndex.h).
+// ------------------------------------------------------------
+
+#include "GoalBracketIndex.h"
+#include <algorithm>
+#include <climits>
+using namespace std;
+
+// Index of the bracket holding 'goals': 0 for "<1", i for
+// [EDGES[i-1], EDGES[i]), and EDGES.size() for the last one.
+size_t GoalBracketIndex::bracketOf(int goals) {
+    return size_t(upper_bound(EDGES.begin(), EDGES.end(), goals) - EDGES.begin());
+}
+
+void GoalBracketIndex::insert(uint32_t row, int goals) {
+    brackets_[bracketOf(goals)].add(row);
+}
+
+void GoalBracketIndex::update(uint32_t row, int oldGoals, int newGoals) {
+    size_t from = bracketOf(oldGoals);
+    size_t to = bracketOf(newGoals);
+    if (from == to) return;   // The common case: nothing to do
+    brackets_[from].remove(row);
+    brackets_[to].add(row);
+}
+
+void GoalBracketIndex::clear() {
+    for (RoaringBitmap& bracket : brackets_) bracket = RoaringBitmap();
+}
+
+// ------------------------------------------------------------
+// Function: count
+// ------------------------------------------------------------
+size_t GoalBracketIndex::count(int minGoals, int maxGoals, const vector<int>& goals,
+                               const RoaringBitmap* within) const {
+    if (minGoals > maxGoals) return 0;
+
+    size_t total = 0;
+    for (size_t b = 0; b < brackets_.size(); ++b) {
+        // Goal range covered by bracket b.
+        int low = (b == 0) ? INT_MIN : EDGES[b - 1];
+        int high = (b == EDGES.size()) ? INT_MAX : EDGES[b] - 1;
+        if (high < minGoals || low > maxGoals) continue;
+
+        auto countRows = [&](const RoaringBitmap& rows) {
+            rows.forEach([&](uint32_t row) {
+                int g = goals[row];
+                if (g >= minGoals && g <= maxGoals) ++total;
+            });
+        };
+
+        if (low >= minGoals && high <= maxGoals) {
+            total += within ? RoaringBitmap::andCardinality(brackets_[b], *within) : brackets_[b].cardinality();
+        } else if (within) {
+            countRows(RoaringBitmap::intersect(brackets_[b], *within));
+        } else {
+            countRows(brackets_[b]);
+        }
+    }
+    return total;
+}
@@ -0,0 +1,71 @@
+//
+// Module 9 - Streams and Files
+// Header File: GoalBracketIndex.h
+// ------------------------------------------------------------
+// Answers "how many players have between A and B goals?" without
+// looking at every row.
+//
+// Goal counts are grouped into a few fixed brackets:
+//
+//   <1  1  2  3-4  5-9  10-14  15-19  20-29  30-49  50-99  100+
+//
+// and each bracket keeps the set of rows in it as a compressed
+// bitmap (see RoaringBitmap.h). A count is then:
+//
+//   - for every bracket that lies completely inside [A, B]: the
+//     bitmap's cardinality (kept up to date, so O(1) per container);
+//   - for the (at most two) brackets that only partly overlap:
+//     check the goals of just the rows in that bracket.
+//
+// So "10 or more goals" adds up seven cardinalities and never
+// touches the goals column at all. "Arsenal players with 10 or
+// more goals" does the same with each bracket ANDed with the
+// team's rows.
+//
+// The index is kept up to date one row at a time: insert() when a
+// row is appended, update() when its goals change – which only
+// moves the row if it changed brackets.
+//
+// Not thread-safe; Soccer protects it with its table lock.
+//
+// Example:
+//   GoalBracketIndex index;
+//   index.insert(0, 12);
+//   size_t scorers = index.count(10, INT_MAX, goals);
+// ------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "RoaringBitmap.h"
+
+class GoalBracketIndex {
+public:
+    void insert(uint32_t row, int goals);
+    void update(uint32_t row, int oldGoals, int newGoals);
+    void clear();
+
+    // ------------------------------------------------------------
+    // Function: count
+    // ------------------------------------------------------------
+    // Number of rows with minGoals <= goals <= maxGoals. 'goals' is
+    // the goals column the rows refer to (used only for the brackets
+    // that straddle minGoals or maxGoals).
+    //
+    // With 'within' (e.g. one team's rows), only rows in that set
+    // count: each bracket is intersected with it, a whole bracket
+    // with andCardinality() and without building the intersection.
+    // ------------------------------------------------------------
+    size_t count(int minGoals, int maxGoals, const std::vector<int>& goals,
+                 const RoaringBitmap* within = nullptr) const;
+
+private:
+    // Lowest goal count of each bracket after the first ("<1").
+    static constexpr std::array<int, 10> EDGES = {1, 2, 3, 5, 10, 15, 20, 30, 50, 100};
+
+    static size_t bracketOf(int goals);
+
+    std::array<RoaringBitmap, EDGES.size() + 1> brackets_;
+};
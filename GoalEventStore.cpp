@@ -0,0 +1,330 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: GoalEventStore.cpp
+// ------------------------------------------------------------
+// The binary goal history (see GoalEventStore.h).
+//
+// Appends use POSIX write()/fdatasync() like SoccerLog; reads map
+// the whole events file into memory with mmap(), so scanning
+// millions of records is just walking an array.
+// ------------------------------------------------------------
+
+#include "GoalEventStore.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <climits>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace {
+
+// "SGEV" + format version 2, so a wrong file is never summed.
+// (Version 1 had 12-byte records without the day.)
+constexpr char HEADER[8] = {'S', 'G', 'E', 'V', 2, 0, 0, 0};
+constexpr size_t HEADER_SIZE = sizeof(HEADER);
+
+} // namespace
+
+uint32_t currentDay() {
+    auto days = chrono::duration_cast<chrono::days>(chrono::system_clock::now().time_since_epoch());
+    return static_cast<uint32_t>(days.count());
+}
+
+GoalEventStore::GoalEventStore(const string& path)
+    : eventsPath_(path), namesPath_(path.substr(0, path.rfind(".events")) + ".players") {}
+
+GoalEventStore::~GoalEventStore() {
+    if (eventsFd_ >= 0) close(eventsFd_);
+    if (namesFd_ >= 0) close(namesFd_);
+}
+
+bool GoalEventStore::exists(const string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+// ------------------------------------------------------------
+// Function: open
+// ------------------------------------------------------------
+bool GoalEventStore::open() {
+    lock_guard<mutex> lock(mutex_);
+    if (eventsFd_ >= 0) return true;
+
+    // Step 1: the player dictionary. Only lines that end with '\n'
+    // are names; the rest of a torn last line is cut off, or the
+    // next name would be glued to it.
+    string dictionary;
+    {
+        ifstream in(namesPath_, ios::binary);
+        dictionary.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    size_t complete = dictionary.rfind('\n') + 1;   // 0 if there is no '\n'
+    size_t start = 0;
+    while (start < complete) {
+        size_t end = dictionary.find('\n', start);
+        string name = dictionary.substr(start, end - start);
+        ids_.emplace(name, static_cast<uint32_t>(names_.size()));
+        names_.push_back(move(name));
+        start = end + 1;
+    }
+
+    namesFd_ = ::open(namesPath_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    eventsFd_ = ::open(eventsPath_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (namesFd_ < 0 || eventsFd_ < 0) {
+        cerr << "Error: Could not open " << eventsPath_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    if (complete < dictionary.size() && ftruncate(namesFd_, static_cast<off_t>(complete)) < 0) {
+        cerr << "Error: Could not repair " << namesPath_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    namesBytes_ = complete;
+
+    // Step 2: a new file gets its header; a torn last record is cut off.
+    struct stat info;
+    if (fstat(eventsFd_, &info) < 0) return false;
+    size_t size = static_cast<size_t>(info.st_size);
+
+    if (size < HEADER_SIZE) {
+        if (ftruncate(eventsFd_, 0) < 0) return false;
+        eventsBytes_ = HEADER_SIZE;
+        return writeAll(eventsFd_, string(HEADER, HEADER_SIZE), eventsPath_);
+    }
+
+    char header[HEADER_SIZE];
+    if (pread(eventsFd_, header, HEADER_SIZE, 0) != ssize_t(HEADER_SIZE) ||
+        memcmp(header, HEADER, HEADER_SIZE) != 0) {
+        cerr << "Error: " << eventsPath_ << " is not a goal event store.\n";
+        return false;
+    }
+
+    size_t extra = (size - HEADER_SIZE) % sizeof(Record);
+    if (extra != 0 && ftruncate(eventsFd_, size - extra) < 0) {
+        cerr << "Error: Could not repair " << eventsPath_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    eventsBytes_ = size - extra;
+    return true;
+}
+
+bool GoalEventStore::writeAll(int fd, const string& bytes, const string& path) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t n = write(fd, bytes.data() + written, bytes.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            cerr << "Error: Could not write to " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (syncOnAppend_ && fdatasync(fd) < 0) {
+        cerr << "Error: Could not sync " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: append
+// ------------------------------------------------------------
+// New names are written (and synced) first, so no record on disk
+// ever points at an id that isn't in the dictionary yet.
+//
+// If a write fails, both files are cut back to their size before
+// the call: a half-written name or record would otherwise stay
+// in front of everything appended later.
+// ------------------------------------------------------------
+bool GoalEventStore::append(const vector<GoalEvent>& events) {
+    if (events.empty()) return true;
+    lock_guard<mutex> lock(mutex_);
+    if (eventsFd_ < 0) return false;
+
+    string newNames;
+    string records;
+    records.reserve(events.size() * sizeof(Record));
+    size_t firstNewId = names_.size();
+    uint32_t today = currentDay();
+
+    for (const GoalEvent& event : events) {
+        auto it = ids_.find(event.player);
+        if (it == ids_.end()) {
+            it = ids_.emplace(event.player, static_cast<uint32_t>(names_.size())).first;
+            names_.push_back(event.player);
+            newNames += event.player;
+            newNames += '\n';
+        }
+
+        // Split deltas that don't fit in an int16.
+        int remaining = event.delta;
+        do {
+            int part = clamp(remaining, int(INT16_MIN), int(INT16_MAX));
+            Record record{it->second, event.match, event.day ? event.day : today, event.minute,
+                          static_cast<int16_t>(part)};
+            records.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            remaining -= part;
+        } while (remaining != 0);
+    }
+
+    if ((newNames.empty() || writeAll(namesFd_, newNames, namesPath_)) &&
+        writeAll(eventsFd_, records, eventsPath_)) {
+        namesBytes_ += newNames.size();
+        eventsBytes_ += records.size();
+        return true;
+    }
+
+    // Forget the names, and cut off whatever part of the batch
+    // made it to disk.
+    for (size_t id = firstNewId; id < names_.size(); ++id) ids_.erase(names_[id]);
+    names_.resize(firstNewId);
+    if (ftruncate(eventsFd_, static_cast<off_t>(eventsBytes_)) < 0 ||
+        ftruncate(namesFd_, static_cast<off_t>(namesBytes_)) < 0) {
+        cerr << "Error: Could not undo the failed append to " << eventsPath_ << ": " << strerror(errno) << "\n";
+    }
+    return false;
+}
+
+// ------------------------------------------------------------
+// Function: mapRecords
+// ------------------------------------------------------------
+bool GoalEventStore::mapRecords(const function<void(const Record*, size_t)>& visit) const {
+    int fd = ::open(eventsPath_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        cerr << "Error: Could not open " << eventsPath_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    size_t count = size > HEADER_SIZE ? (size - HEADER_SIZE) / sizeof(Record) : 0;
+    if (count == 0) {
+        close(fd);
+        visit(nullptr, 0);
+        return true;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // The mapping stays valid without the descriptor
+    if (data == MAP_FAILED) {
+        cerr << "Error: Could not map " << eventsPath_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    visit(reinterpret_cast<const Record*>(static_cast<const char*>(data) + HEADER_SIZE), count);
+    munmap(data, size);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: rebuildTotals
+// ------------------------------------------------------------
+// Each slice of the records is summed into its own array of
+// totals (indexed by player id – no hashing, no locks) by the
+// shared TaskScheduler, and the arrays are added together at the
+// end.
+// ------------------------------------------------------------
+vector<pair<string, int>> GoalEventStore::rebuildTotals(unsigned threads) const {
+    vector<string> names;
+    {
+        lock_guard<mutex> lock(mutex_);
+        names = names_;
+    }
+    size_t players = names.size();
+
+    vector<long long> totals(players, 0);
+    mapRecords([&](const Record* records, size_t count) {
+        if (threads == 0) threads = TaskScheduler::shared().workerCount() + 1;
+        // Not worth a thread for fewer than ~64K records.
+        threads = static_cast<unsigned>(min<size_t>(threads, count / 65536 + 1));
+
+        vector<vector<long long>> partial(threads, vector<long long>(players, 0));
+        size_t slice = (count + threads - 1) / threads;
+
+        TaskScheduler::shared().parallelFor(0, threads, 1, [&](size_t first, size_t last) {
+            for (size_t t = first; t < last; ++t) {
+                vector<long long>& sums = partial[t];
+                size_t end = min(count, (t + 1) * slice);
+                for (size_t i = t * slice; i < end; ++i) {
+                    // Ids beyond the names we copied belong to newer appends.
+                    if (records[i].player < players) {
+                        sums[records[i].player] += records[i].delta;
+                    }
+                }
+            }
+        });
+
+        for (const auto& sums : partial) {
+            for (size_t id = 0; id < players; ++id) totals[id] += sums[id];
+        }
+    });
+
+    vector<pair<string, int>> result;
+    result.reserve(players);
+    for (size_t id = 0; id < players; ++id) {
+        result.push_back({move(names[id]), static_cast<int>(totals[id])});
+    }
+    return result;
+}
+
+// ------------------------------------------------------------
+// Function: history
+// ------------------------------------------------------------
+vector<GoalEvent> GoalEventStore::history(string_view player) const {
+    uint32_t id;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = ids_.find(string(player));
+        if (it == ids_.end()) return {};
+        id = it->second;
+    }
+
+    vector<GoalEvent> events;
+    mapRecords([&](const Record* records, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (records[i].player == id) {
+                events.push_back({string(player), records[i].match, records[i].minute,
+                                  records[i].delta, records[i].day});
+            }
+        }
+    });
+    return events;
+}
+
+uint64_t GoalEventStore::eventCount() const {
+    struct stat info;
+    if (stat(eventsPath_.c_str(), &info) < 0 || size_t(info.st_size) < HEADER_SIZE) return 0;
+    return (info.st_size - HEADER_SIZE) / sizeof(Record);
+}
+
+// ------------------------------------------------------------
+// Function: replay
+// ------------------------------------------------------------
+bool GoalEventStore::replay(const function<void(const string&, uint32_t, uint32_t, int)>& visit) const {
+    vector<string> names;
+    {
+        lock_guard<mutex> lock(mutex_);
+        names = names_;
+    }
+
+    return mapRecords([&](const Record* records, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const Record& r = records[i];
+            if (r.player < names.size()) {
+                visit(names[r.player], r.match, r.day, r.delta);
+            }
+        }
+    });
+}
@@ -0,0 +1,144 @@
+//
+// Module 9 - Streams and Files
+// Header File: GoalEventStore.h
+// ------------------------------------------------------------
+// The full history of every goal: who scored, in which match,
+// in which minute. soccer.csv only keeps each player's current
+// total; this store keeps the events that total was built from
+// ("event sourcing"), so the totals can always be recomputed and
+// questions like "when did Messi score?" or "who is in form?"
+// (see FormTracker.h) can be answered.
+//
+// Two files sit next to the data file:
+//
+//   soccer.csv.players   one player name per line; the line number
+//                        (from 0) is the player's id
+//   soccer.csv.events    an 8-byte header, then one fixed-size
+//                        16-byte binary record per event:
+//
+//       +-----------+-----------+--------+--------+-------+
+//       | player id | match id  |  day   | minute | delta |
+//       |  uint32   |  uint32   | uint32 | uint16 | int16 |
+//       +-----------+-----------+--------+--------+-------+
+//
+// 'day' counts days since 1970-01-01 (UTC). Numbers are stored in
+// the machine's native byte order. Storing an id instead of the
+// name keeps a record at 16 bytes, and fixed size records mean
+// the file can be cut into equal ranges and summed by several
+// threads at once (rebuildTotals).
+//
+// Match 0 is used for changes that didn't come from a match: the
+// opening balance taken when the store is created, and manual
+// corrections (see Soccer::recordGoals).
+//
+// A crash can leave a half-written record at the end of the file,
+// or a half-written name at the end of the dictionary; open() cuts
+// both off. A failed append cuts both files back to where they
+// were. A new name is always on disk before the first event that
+// uses its id.
+//
+// Example:
+//   GoalEventStore store("soccer.csv.events");
+//   store.open();
+//   store.append({{"Messi", 7, 63, 1}});
+//   auto totals = store.rebuildTotals(8);
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+struct GoalEvent {
+    std::string player;
+    uint32_t match = 0;
+    uint16_t minute = 0;
+    int delta = 1;
+    uint32_t day = 0;     // Days since 1970-01-01; 0 = "today" when appended
+};
+
+// Today's day number, as stored in GoalEvent::day.
+uint32_t currentDay();
+
+class GoalEventStore {
+public:
+    explicit GoalEventStore(const std::string& path);
+    ~GoalEventStore();
+
+    GoalEventStore(const GoalEventStore&) = delete;
+    GoalEventStore& operator=(const GoalEventStore&) = delete;
+
+    // True if a store already exists at 'path'.
+    static bool exists(const std::string& path);
+
+    // ------------------------------------------------------------
+    // Function: open
+    // ------------------------------------------------------------
+    // Creates the files if needed and reads the player names.
+    // The events themselves are NOT read.
+    // ------------------------------------------------------------
+    bool open();
+
+    // ------------------------------------------------------------
+    // Function: append
+    // ------------------------------------------------------------
+    // Adds events to the end of the store with one write() (plus
+    // fdatasync if sync is on). A delta too big for 16 bits is
+    // split over several records.
+    // ------------------------------------------------------------
+    bool append(const std::vector<GoalEvent>& events);
+
+    // ------------------------------------------------------------
+    // Function: rebuildTotals
+    // ------------------------------------------------------------
+    // Adds up every event per player in 'threads' parallel slices
+    // (0 = one per thread of the shared TaskScheduler). Returns
+    // {name, total} in id order.
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> rebuildTotals(unsigned threads = 0) const;
+
+    // Every event for one player, oldest first.
+    std::vector<GoalEvent> history(std::string_view player) const;
+
+    // Calls 'visit' for every event, oldest first.
+    bool replay(const std::function<void(const std::string& player, uint32_t match,
+                                         uint32_t day, int delta)>& visit) const;
+
+    uint64_t eventCount() const;
+    void setSyncOnAppend(bool sync) { syncOnAppend_ = sync; }
+
+private:
+    // The on-disk record. Exactly 16 bytes, no padding.
+    struct Record {
+        uint32_t player;
+        uint32_t match;
+        uint32_t day;
+        uint16_t minute;
+        int16_t delta;
+    };
+    static_assert(sizeof(Record) == 16, "event records must be 16 bytes");
+
+    std::string eventsPath_;
+    std::string namesPath_;
+    int eventsFd_ = -1;
+    int namesFd_ = -1;
+    bool syncOnAppend_ = true;
+    size_t eventsBytes_ = 0;   // File sizes after the last complete append
+    size_t namesBytes_ = 0;
+
+    // Player names by id, and the reverse lookup.
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, uint32_t> ids_;
+
+    // Calls 'visit' for every complete record, with the file
+    // mapped read-only. Returns false if the file can't be read.
+    bool mapRecords(const std::function<void(const Record*, size_t)>& visit) const;
+    bool writeAll(int fd, const std::string& bytes, const std::string& path);
+};
@@ -0,0 +1,361 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: GoalIngestor.cpp
+// ------------------------------------------------------------
+// Micro-batched goal event ingestion (see GoalIngestor.h).
+//
+// Input is read with read() into a large buffer and parsed in
+// place – no getline(), no stringstream and no std::string per
+// event – which is what makes millions of events per second
+// possible on a single thread.
+// ------------------------------------------------------------
+
+#include "GoalIngestor.h"
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace {
+
+constexpr size_t READ_BUFFER_SIZE = 1 << 20;   // 1 MiB
+constexpr int FOLLOW_POLL_MS = 20;             // How often "tail -f" checks for growth
+
+} // namespace
+
+// ------------------------------------------------------------
+// Function: parseGoalEvent
+// ------------------------------------------------------------
+bool parseGoalEvent(string_view line, string_view& name, int& delta, string_view& eventId) {
+    eventId = {};
+    size_t comma = line.rfind(',');
+    if (comma != string_view::npos && line.substr(comma + 1, 3) == "id=") {
+        eventId = line.substr(comma + 4);
+        if (eventId.empty()) return false;
+        line = line.substr(0, comma);
+        comma = line.rfind(',');
+    }
+
+    if (comma == string_view::npos || comma == 0) return false;
+
+    const char* first = line.data() + comma + 1;
+    const char* last = line.data() + line.size();
+    if (first < last && *first == '+') ++first;   // from_chars doesn't accept '+'
+    if (first == last) return false;
+
+    auto result = from_chars(first, last, delta);
+    if (result.ec != errc() || result.ptr != last) return false;
+
+    name = line.substr(0, comma);
+    return true;
+}
+
+bool normalizeEventName(string_view& name) {
+    size_t first = name.find_first_not_of(" \t");
+    if (first == string_view::npos) return false;
+    size_t last = name.find_last_not_of(" \t");
+    name = name.substr(first, last - first + 1);
+    return name.size() <= MAX_EVENT_NAME_LENGTH && SoccerLog::validName(name);
+}
+
+// ============================================================
+// LatencyHistogram
+// ============================================================
+
+// Bucket i holds latencies below 2^i microseconds.
+void LatencyHistogram::add(chrono::nanoseconds latency, uint64_t count) {
+    uint64_t nanos = static_cast<uint64_t>(max<int64_t>(0, latency.count()));
+    uint64_t micros = nanos / 1000;
+
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && (uint64_t(1) << bucket) <= micros) {
+        ++bucket;
+    }
+    buckets_[bucket] += count;
+    total_ += count;
+    maxNanos_ = max(maxNanos_, nanos);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKETS; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    total_ += other.total_;
+    maxNanos_ = max(maxNanos_, other.maxNanos_);
+}
+
+double LatencyHistogram::percentileMicros(double p) const {
+    if (total_ == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * total_);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += buckets_[i];
+        if (seen > rank) {
+            return min(double(uint64_t(1) << i), maxMicros());
+        }
+    }
+    return maxMicros();
+}
+
+// ============================================================
+// GoalIngestor
+// ============================================================
+
+GoalIngestor::GoalIngestor(Soccer& league, IngestOptions options)
+    : league_(league), options_(options),
+      dedupe_(chrono::seconds(options.dedupeWindowSeconds), options.dedupeMaxKeys) {
+    options_.maxBatchEvents = max<size_t>(1, options_.maxBatchEvents);
+}
+
+// ------------------------------------------------------------
+// Function: ingestFile
+// ------------------------------------------------------------
+// A FIFO reports end of input every time its writer goes away.
+// With 'follow', we simply open it again, which waits for the
+// next writer.
+// ------------------------------------------------------------
+bool GoalIngestor::ingestFile(const string& path) {
+    if (path == "-") {
+        return ingestFd(STDIN_FILENO);
+    }
+
+    while (true) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR && !stopping_) continue;
+            if (errno == EINTR) return true;
+            cerr << "Error: Could not open " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+
+        struct stat info;
+        bool isFifo = fstat(fd, &info) == 0 && S_ISFIFO(info.st_mode);
+
+        bool ok = ingestFd(fd);
+        close(fd);
+
+        if (!ok || !isFifo || !options_.follow || stopping_) {
+            return ok;
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Function: ingestFd
+// ------------------------------------------------------------
+// The main loop:
+//   1. Wait (poll) until there is input – but never longer than
+//      the time left before the current batch is due.
+//   2. Read a chunk and parse its complete lines.
+//   3. Apply the batch if it is full, old enough, or the input
+//      has run dry for now.
+// ------------------------------------------------------------
+bool GoalIngestor::ingestFd(int fd) {
+    struct stat info;
+    bool regularFile = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+
+    vector<char> buffer(READ_BUFFER_SIZE);
+    size_t carried = 0;          // Bytes of an unfinished line kept from last read
+    Clock::time_point started = Clock::now();
+    bool ok = true;
+
+    while (!stopping_) {
+        // Step 1: wait for input, bounded by the batch deadline.
+        if (!regularFile) {
+            int timeout = -1;
+            if (pendingEvents_ > 0) {
+                auto waited = chrono::duration_cast<chrono::milliseconds>(Clock::now() - batchStart_);
+                timeout = max<int>(0, options_.maxBatchDelayMs - int(waited.count()));
+            }
+
+            pollfd waitFor{fd, POLLIN, 0};
+            int ready = poll(&waitFor, 1, timeout);
+            if (ready < 0 && errno != EINTR) {
+                cerr << "Error: poll failed: " << strerror(errno) << "\n";
+                ok = false;
+                break;
+            }
+            if (ready <= 0) {           // Timed out (or interrupted)
+                if (batchIsDue(Clock::now())) applyBatch();
+                continue;
+            }
+        }
+
+        // Step 2: read and parse.
+        if (carried == buffer.size()) {
+            buffer.resize(buffer.size() * 2);   // A single huge line
+        }
+        ssize_t n = read(fd, buffer.data() + carried, buffer.size() - carried);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error: Could not read events: " << strerror(errno) << "\n";
+            ok = false;
+            break;
+        }
+
+        if (n == 0) {
+            // End of input for now: nothing else is coming soon.
+            applyBatch();
+            if (!options_.follow) break;
+            if (!regularFile) break;             // FIFO: ingestFile() reopens it
+            usleep(FOLLOW_POLL_MS * 1000);       // Regular file: wait for it to grow
+            continue;
+        }
+
+        size_t available = carried + static_cast<size_t>(n);
+        size_t used = parseChunk(buffer.data(), available, Clock::now());
+        carried = available - used;
+        memmove(buffer.data(), buffer.data() + used, carried);
+
+        // Step 3: apply if due.
+        if (batchIsDue(Clock::now())) {
+            applyBatch();
+        }
+    }
+
+    // A final line without a trailing newline still counts.
+    if (carried > 0 && !options_.follow) {
+        Clock::time_point now = Clock::now();
+        if (pendingEvents_ == 0) batchStart_ = now;
+        uint64_t before = pendingEvents_;
+        addEvent(string_view(buffer.data(), carried), now);
+        if (pendingEvents_ > before) pendingChunks_.push_back({now, pendingEvents_ - before});
+    }
+    applyBatch();
+
+    stats_.seconds += chrono::duration<double>(Clock::now() - started).count();
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Function: parseChunk
+// ------------------------------------------------------------
+size_t GoalIngestor::parseChunk(const char* data, size_t size, Clock::time_point readAt) {
+    uint64_t before = pendingEvents_;
+    if (pendingEvents_ == 0) {
+        batchStart_ = readAt;
+    }
+
+    size_t pos = 0;
+    while (pos < size) {
+        const void* newline = memchr(data + pos, '\n', size - pos);
+        if (!newline) break;
+
+        size_t end = static_cast<const char*>(newline) - data;
+        addEvent(string_view(data + pos, end - pos), readAt);
+        pos = end + 1;
+    }
+
+    if (pendingEvents_ > before) {
+        pendingChunks_.push_back({readAt, pendingEvents_ - before});
+    }
+    return pos;
+}
+
+// ------------------------------------------------------------
+// Function: addEvent
+// ------------------------------------------------------------
+// Adds one event's delta to the player's running total for
+// this batch – unless its id shows it was already counted. The
+// id is kept with the batch, so applyBatch() can forget it again
+// if the batch isn't saved.
+// ------------------------------------------------------------
+void GoalIngestor::addEvent(string_view line, Clock::time_point readAt) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty()) return;
+
+    string_view name, eventId;
+    int delta;
+    if (!parseGoalEvent(line, name, delta, eventId) || !normalizeEventName(name)) {
+        ++stats_.badLines;
+        return;
+    }
+    if (!eventId.empty() && options_.dedupeWindowSeconds > 0) {
+        uint64_t key = EventDedupe::keyHash(eventId);
+        if (!dedupe_.firstTime(key, readAt)) {
+            ++stats_.duplicates;
+            return;
+        }
+        pendingKeys_.push_back(key);
+    }
+
+    auto it = pending_.find(name);
+    if (it == pending_.end()) {
+        pending_.emplace(string(name), delta);
+    } else {
+        it->second += delta;
+    }
+    ++pendingEvents_;
+}
+
+bool GoalIngestor::batchIsDue(Clock::time_point now) const {
+    if (pendingEvents_ == 0) return false;
+    return pendingEvents_ >= options_.maxBatchEvents ||
+           now - batchStart_ >= chrono::milliseconds(options_.maxBatchDelayMs);
+}
+
+// ------------------------------------------------------------
+// Function: applyBatch
+// ------------------------------------------------------------
+// Hands the per-player totals to Soccer in one call and records
+// how long every event in the batch waited. A batch that wasn't
+// saved gives its event ids back, so resent events still count.
+// ------------------------------------------------------------
+void GoalIngestor::applyBatch() {
+    if (pendingEvents_ == 0) return;
+
+    vector<pair<string, int>> deltas;
+    deltas.reserve(pending_.size());
+    for (auto& entry : pending_) {
+        if (entry.second != 0) {
+            deltas.push_back({entry.first, entry.second});
+        }
+    }
+
+    bool applied = league_.applyGoalEvents(deltas);
+    Clock::time_point done = Clock::now();
+
+    ++stats_.batches;
+    if (applied) {
+        stats_.events += pendingEvents_;
+        for (const auto& chunk : pendingChunks_) {
+            stats_.latency.add(done - chunk.first, chunk.second);
+        }
+    } else {
+        ++stats_.failedBatches;
+        for (uint64_t key : pendingKeys_) dedupe_.forget(key);
+    }
+
+    pending_.clear();
+    pendingKeys_.clear();
+    pendingChunks_.clear();
+    pendingEvents_ = 0;
+}
+
+// ------------------------------------------------------------
+// Function: report
+// ------------------------------------------------------------
+void GoalIngestor::report(ostream& out) const {
+    reportIngestStats(out, stats_);
+}
+
+void reportIngestStats(ostream& out, const IngestStats& stats) {
+    double rate = stats.seconds > 0 ? stats.events / stats.seconds : 0;
+    out << "events=" << stats.events
+        << " bad_lines=" << stats.badLines
+        << " duplicates=" << stats.duplicates
+        << " batches=" << stats.batches
+        << " failed_batches=" << stats.failedBatches
+        << " seconds=" << stats.seconds
+        << " events_per_sec=" << static_cast<uint64_t>(rate)
+        << " latency_p50_us=" << stats.latency.percentileMicros(50)
+        << " latency_p99_us=" << stats.latency.percentileMicros(99)
+        << " latency_max_us=" << stats.latency.maxMicros()
+        << '\n';
+}
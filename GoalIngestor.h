@@ -0,0 +1,174 @@
+//
+// Module 9 - Streams and Files
+// Header File: GoalIngestor.h
+// ------------------------------------------------------------
+// Reads a continuous stream of live goal events and applies them
+// to a Soccer table in small batches ("micro-batches").
+//
+// Each event is one line:
+//
+//     Messi,+1
+//     Rapinoe,+2
+//     Ronaldo,-1        (a goal taken away by VAR)
+//     Messi,+1,id=m1042-g3
+//
+// The optional "id=" field is an idempotency key: if the feed
+// sends the same key again within the dedupe window, the repeat
+// is counted as a duplicate and ignored (see EventDedupe.h).
+// Events without a key are always counted. Keys of a batch that
+// couldn't be saved are forgotten again, so a resend counts.
+//
+// The stream can come from standard input, a named pipe (FIFO),
+// or a regular file. With 'follow' turned on, the ingestor keeps
+// waiting for more data at the end of input, like "tail -f"
+// (for a FIFO it waits for the next writer to connect).
+//
+// Why micro-batches? Applying events one at a time would cost one
+// lock and one disk write per goal. Instead, events that arrive
+// close together are added up per player and handed to
+// Soccer::applyGoalEvents() as one batch – one log write and one
+// fdatasync for thousands of events.
+//
+// A batch is applied when it reaches 'maxBatchEvents' events, when
+// its oldest event has waited 'maxBatchDelayMs', or when the input
+// has nothing more to read right now.
+//
+// Latency is measured from the moment an event's bytes were read
+// until its batch was durably logged and applied.
+//
+// Example:
+//   GoalIngestor ingestor(league);
+//   ingestor.ingestFile("/tmp/goals.fifo");
+//   ingestor.report(std::cerr);
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include "Soccer.h"
+#include "EventDedupe.h"
+
+// ------------------------------------------------------------
+// Function: parseGoalEvent
+// ------------------------------------------------------------
+// Splits one event line ("Name,+N", "Name,-N" or "Name,N", each
+// optionally followed by ",id=KEY") into the player name, the
+// delta and the key ("" if there is none). 'name' and 'eventId'
+// point into 'line'. Returns false for anything else.
+// ------------------------------------------------------------
+bool parseGoalEvent(std::string_view line, std::string_view& name, int& delta,
+                    std::string_view& eventId);
+
+// Longer player names are rejected as bad input.
+constexpr size_t MAX_EVENT_NAME_LENGTH = 255;
+
+// ------------------------------------------------------------
+// Function: normalizeEventName
+// ------------------------------------------------------------
+// Trims spaces and tabs from both ends of a parsed name. Returns
+// false – the line counts as bad – if nothing is left, if it is
+// longer than MAX_EVENT_NAME_LENGTH, or if the table can't store
+// it (SoccerLog::validName). Both GoalIngestor and IngestPipeline
+// check every event with it.
+// ------------------------------------------------------------
+bool normalizeEventName(std::string_view& name);
+
+struct IngestOptions {
+    size_t maxBatchEvents = 65536;   // Apply once this many events are waiting
+    int maxBatchDelayMs = 5;         // ...or once the oldest has waited this long
+    bool follow = false;             // Keep waiting for data at end of input
+    int dedupeWindowSeconds = 600;   // Remember event ids this long (0 = no dedupe)
+    size_t dedupeMaxKeys = 1 << 20;  // ...but at most this many per window
+};
+
+// ------------------------------------------------------------
+// Class: LatencyHistogram
+// ------------------------------------------------------------
+// Counts latencies in power-of-two microsecond buckets
+// (<1us, <2us, <4us, ...). Adding is O(1) and the memory use is
+// fixed, so it can record millions of events per second.
+// Percentiles are reported as the upper edge of their bucket.
+// ------------------------------------------------------------
+class LatencyHistogram {
+public:
+    void add(std::chrono::nanoseconds latency, uint64_t count = 1);
+    void merge(const LatencyHistogram& other);
+    uint64_t count() const { return total_; }
+    double percentileMicros(double p) const;
+    double maxMicros() const { return maxNanos_ / 1000.0; }
+
+private:
+    static constexpr int BUCKETS = 40;
+    uint64_t buckets_[BUCKETS] = {};
+    uint64_t total_ = 0;
+    uint64_t maxNanos_ = 0;
+};
+
+struct IngestStats {
+    uint64_t events = 0;        // Events applied
+    uint64_t badLines = 0;      // Lines that weren't "Name,+N"
+    uint64_t duplicates = 0;    // Events dropped because their id was seen before
+    uint64_t batches = 0;       // applyGoalEvents() calls
+    uint64_t failedBatches = 0; // Batches the log refused (events lost)
+    double seconds = 0;         // Wall time spent ingesting
+    LatencyHistogram latency;
+};
+
+// Prints one "key=value" summary line for 'stats'.
+void reportIngestStats(std::ostream& out, const IngestStats& stats);
+
+class GoalIngestor {
+public:
+    explicit GoalIngestor(Soccer& league, IngestOptions options = {});
+
+    // ------------------------------------------------------------
+    // Function: ingestFile
+    // ------------------------------------------------------------
+    // Reads events from 'path' ("-" means standard input) until the
+    // end of input (or forever with 'follow', until stop()).
+    // Returns false if the input could not be opened or read.
+    // ------------------------------------------------------------
+    bool ingestFile(const std::string& path);
+
+    // Same as ingestFile, for an already open file descriptor.
+    bool ingestFd(int fd);
+
+    // Asks a running ingest to apply what it has and return.
+    // Safe to call from a signal handler.
+    void stop() { stopping_ = true; }
+
+    const IngestStats& stats() const { return stats_; }
+
+    // Prints one "key=value" summary line.
+    void report(std::ostream& out) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Soccer& league_;
+    IngestOptions options_;
+    std::atomic<bool> stopping_{false};
+    IngestStats stats_;
+    EventDedupe dedupe_;
+
+    // The batch being collected: total delta per player, plus when
+    // each chunk of its events was read (for the latency numbers).
+    std::unordered_map<std::string, int, NameHash, std::equal_to<>> pending_;
+    std::vector<std::pair<Clock::time_point, uint64_t>> pendingChunks_;
+    std::vector<uint64_t> pendingKeys_;   // Event ids (hashed) in the batch
+    uint64_t pendingEvents_ = 0;
+    Clock::time_point batchStart_;
+
+    // Parses every complete line in [data, data+size) and returns
+    // how many bytes were used (a partial last line is left over).
+    size_t parseChunk(const char* data, size_t size, Clock::time_point readAt);
+    void addEvent(std::string_view line, Clock::time_point readAt);
+    void applyBatch();
+    bool batchIsDue(Clock::time_point now) const;
+};
@@ -0,0 +1,516 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: IngestPipeline.cpp
+// ------------------------------------------------------------
+// The four pipeline stages described in IngestPipeline.h. Each
+// stage is a plain function that loops "pop from my input queue,
+// do my part, push to my output queue" until its input is closed,
+// then closes its own output so the next stage can finish too.
+// ------------------------------------------------------------
+
+#include "IngestPipeline.h"
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+constexpr size_t READ_BUFFER_SIZE = 1 << 20;   // 1 MiB per chunk
+constexpr int POLL_MS = 50;                    // How often a waiting reader checks stop()
+constexpr int FOLLOW_POLL_MS = 20;             // How often "tail -f" checks for growth
+
+// Queue sizes, in items. Chunks are up to 1 MiB each, so the
+// first queue holds at most a few MiB of unparsed-ahead input.
+constexpr size_t CHUNK_QUEUE_SIZE = 8;
+constexpr size_t BATCH_QUEUE_SIZE = 4;
+
+// One event inside a chunk: the name is text[offset, offset+length),
+// the id (if idLength > 0) likewise.
+struct ParsedEvent {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t idOffset;
+    uint32_t idLength;
+    int delta;
+};
+
+// Stage 1 → 2: the complete lines of one read(), already split.
+struct ParsedChunk {
+    string text;
+    vector<ParsedEvent> events;
+    Clock::time_point readAt;
+    uint64_t badLines = 0;
+};
+
+// Stage 2 → 3 → 4: one micro-batch of per-player totals.
+struct GoalBatch {
+    vector<pair<string, int>> deltas;
+    uint64_t events = 0;
+    vector<pair<Clock::time_point, uint64_t>> chunks;   // For latency
+    vector<uint64_t> keys;                              // Event ids (hashed)
+};
+
+// ------------------------------------------------------------
+// Helper: ForgottenKeys
+// ------------------------------------------------------------
+// Stage 3 → 2, the only way back: the event ids of batches the
+// log refused. Only the validate thread touches the EventDedupe,
+// so it forgets them itself before it looks at the next chunk.
+// The flag keeps that check to one load while nothing failed.
+// ------------------------------------------------------------
+class ForgottenKeys {
+public:
+    void add(const vector<uint64_t>& keys) {
+        if (keys.empty()) return;
+        lock_guard<mutex> lock(mutex_);
+        keys_.insert(keys_.end(), keys.begin(), keys.end());
+        any_.store(true, memory_order_release);
+    }
+
+    void forgetIn(EventDedupe& dedupe) {
+        if (!any_.load(memory_order_acquire)) return;
+        lock_guard<mutex> lock(mutex_);
+        for (uint64_t key : keys_) dedupe.forget(key);
+        keys_.clear();
+        any_.store(false, memory_order_relaxed);
+    }
+
+private:
+    mutex mutex_;
+    vector<uint64_t> keys_;
+    atomic<bool> any_{false};
+};
+
+double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// ------------------------------------------------------------
+// Helper: StageTimer
+// ------------------------------------------------------------
+// Splits a stage's wall time into busy / waiting-for-input /
+// waiting-for-output. Whatever isn't counted as waiting is busy.
+// ------------------------------------------------------------
+class StageTimer {
+public:
+    explicit StageTimer(StageMetrics& metrics) : metrics_(metrics), started_(Clock::now()) {}
+    ~StageTimer() {
+        double total = secondsSince(started_);
+        metrics_.busySeconds = max(0.0, total - metrics_.inputWaitSeconds - metrics_.outputWaitSeconds);
+    }
+
+    template <typename Wait>
+    auto input(Wait wait) {
+        Clock::time_point start = Clock::now();
+        auto result = wait();
+        metrics_.inputWaitSeconds += secondsSince(start);
+        return result;
+    }
+
+    template <typename Wait>
+    void output(Wait wait) {
+        Clock::time_point start = Clock::now();
+        wait();
+        metrics_.outputWaitSeconds += secondsSince(start);
+    }
+
+private:
+    StageMetrics& metrics_;
+    Clock::time_point started_;
+};
+
+// Splits every line of chunk.text into chunk.events.
+void parseLines(ParsedChunk& chunk) {
+    const char* data = chunk.text.data();
+    size_t size = chunk.text.size();
+    size_t pos = 0;
+
+    while (pos < size) {
+        const void* newline = memchr(data + pos, '\n', size - pos);
+        size_t end = newline ? static_cast<const char*>(newline) - data : size;
+
+        string_view line(data + pos, end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) {
+            string_view name, eventId;
+            int delta;
+            if (parseGoalEvent(line, name, delta, eventId)) {
+                chunk.events.push_back({uint32_t(name.data() - data), uint32_t(name.size()),
+                                        uint32_t(eventId.data() - data), uint32_t(eventId.size()), delta});
+            } else {
+                ++chunk.badLines;
+            }
+        }
+        pos = end + 1;
+    }
+}
+
+// ------------------------------------------------------------
+// Stage 1: read + parse
+// ------------------------------------------------------------
+// Only whole lines go into a chunk; an unfinished last line is
+// carried over to the next read(). Returns false on a read error.
+// ------------------------------------------------------------
+bool parseStage(int fd, const IngestOptions& options, const atomic<bool>& stopping,
+                SpscQueue<ParsedChunk>& out, StageMetrics& metrics) {
+    StageTimer timer(metrics);
+
+    struct stat info;
+    bool regularFile = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+
+    vector<char> buffer(READ_BUFFER_SIZE);
+    size_t carried = 0;
+    bool ok = true;
+
+    auto send = [&](ParsedChunk& chunk) {
+        parseLines(chunk);
+        ++metrics.items;
+        timer.output([&] { out.push(move(chunk)); });
+    };
+
+    while (!stopping) {
+        // Wait for input in short slices so stop() is noticed even
+        // if no writer ever shows up.
+        if (!regularFile) {
+            int ready = timer.input([&] {
+                pollfd waitFor{fd, POLLIN, 0};
+                return poll(&waitFor, 1, POLL_MS);
+            });
+            if (ready < 0 && errno != EINTR) {
+                cerr << "Error: poll failed: " << strerror(errno) << "\n";
+                ok = false;
+                break;
+            }
+            if (ready <= 0) continue;
+        }
+
+        if (carried == buffer.size()) {
+            buffer.resize(buffer.size() * 2);   // A single huge line
+        }
+        ssize_t n = read(fd, buffer.data() + carried, buffer.size() - carried);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error: Could not read events: " << strerror(errno) << "\n";
+            ok = false;
+            break;
+        }
+        if (n == 0) {
+            if (!options.follow || !regularFile) break;   // FIFO: ingestFile() reopens it
+            timer.input([] {
+                this_thread::sleep_for(chrono::milliseconds(FOLLOW_POLL_MS));
+                return 0;
+            });
+            continue;
+        }
+
+        size_t available = carried + static_cast<size_t>(n);
+        const void* lastNewline = memrchr(buffer.data(), '\n', available);
+        if (!lastNewline) {
+            carried = available;
+            continue;
+        }
+
+        size_t used = static_cast<const char*>(lastNewline) - buffer.data() + 1;
+        ParsedChunk chunk;
+        chunk.readAt = Clock::now();
+        chunk.text.assign(buffer.data(), used);
+        carried = available - used;
+        memmove(buffer.data(), buffer.data() + used, carried);
+        send(chunk);
+    }
+
+    // A final line without a trailing newline still counts.
+    if (carried > 0 && !options.follow) {
+        ParsedChunk chunk;
+        chunk.readAt = Clock::now();
+        chunk.text.assign(buffer.data(), carried);
+        send(chunk);
+    }
+
+    out.close();
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Stage 2: validate / normalize / batch
+// ------------------------------------------------------------
+// A batch is handed on when it is full, when its oldest event has
+// waited maxBatchDelayMs, or when the input has ended. Repeated
+// event ids are dropped here ('dedupe' is nullptr when off); the
+// ids of batches persist couldn't save come back via 'forgotten'.
+// ------------------------------------------------------------
+void validateStage(const IngestOptions& options, EventDedupe* dedupe, ForgottenKeys& forgotten,
+                   SpscQueue<ParsedChunk>& in, SpscQueue<GoalBatch>& out, StageMetrics& metrics,
+                   uint64_t& badLines, uint64_t& duplicates) {
+    StageTimer timer(metrics);
+
+    unordered_map<string, int, NameHash, equal_to<>> pending;
+    GoalBatch batch;
+    Clock::time_point batchStart;
+
+    auto emit = [&]() {
+        if (batch.events == 0) return;
+        batch.deltas.reserve(pending.size());
+        for (auto& entry : pending) {
+            if (entry.second != 0) {
+                batch.deltas.push_back({entry.first, entry.second});
+            }
+        }
+        pending.clear();
+        ++metrics.items;
+        timer.output([&] { out.push(move(batch)); });
+        batch = GoalBatch();
+    };
+
+    ParsedChunk chunk;
+    while (true) {
+        // With nothing pending there is no deadline; wait as long as it takes.
+        Clock::time_point deadline = batch.events > 0
+            ? batchStart + chrono::milliseconds(options.maxBatchDelayMs)
+            : Clock::time_point::max();
+        auto result = timer.input([&] { return in.popUntil(chunk, deadline); });
+
+        if (result == SpscQueue<ParsedChunk>::PopResult::CLOSED) break;
+        if (result == SpscQueue<ParsedChunk>::PopResult::TIMEOUT) {
+            emit();
+            continue;
+        }
+
+        if (dedupe) forgotten.forgetIn(*dedupe);
+
+        badLines += chunk.badLines;
+        uint64_t accepted = 0;
+        for (const ParsedEvent& event : chunk.events) {
+            string_view name = string_view(chunk.text).substr(event.nameOffset, event.nameLength);
+            if (!normalizeEventName(name)) {
+                ++badLines;
+                continue;
+            }
+            if (dedupe && event.idLength > 0) {
+                uint64_t key = EventDedupe::keyHash(string_view(chunk.text).substr(event.idOffset, event.idLength));
+                if (!dedupe->firstTime(key, chunk.readAt)) {
+                    ++duplicates;
+                    continue;
+                }
+                batch.keys.push_back(key);
+            }
+
+            if (batch.events == 0 && accepted == 0) batchStart = chunk.readAt;
+            auto it = pending.find(name);
+            if (it == pending.end()) {
+                pending.emplace(string(name), event.delta);
+            } else {
+                it->second += event.delta;
+            }
+            ++accepted;
+
+            if (batch.events + accepted >= options.maxBatchEvents) {
+                batch.events += accepted;
+                batch.chunks.push_back({chunk.readAt, accepted});
+                accepted = 0;
+                emit();
+            }
+        }
+
+        if (accepted > 0) {
+            batch.events += accepted;
+            batch.chunks.push_back({chunk.readAt, accepted});
+        }
+        if (batch.events > 0 && Clock::now() - batchStart >= chrono::milliseconds(options.maxBatchDelayMs)) {
+            emit();
+        }
+    }
+
+    emit();
+    out.close();
+}
+
+// ------------------------------------------------------------
+// Stage 3: persist (write-ahead log)
+// ------------------------------------------------------------
+// A batch the log refuses is dropped here and never applied; its
+// event ids go back to the validate stage to be forgotten.
+// ------------------------------------------------------------
+void persistStage(Soccer& league, ForgottenKeys& forgotten, SpscQueue<GoalBatch>& in,
+                  SpscQueue<GoalBatch>& out, StageMetrics& metrics, uint64_t& failedBatches) {
+    StageTimer timer(metrics);
+
+    GoalBatch batch;
+    while (timer.input([&] { return in.pop(batch); })) {
+        ++metrics.items;
+        if (!league.logGoalEvents(batch.deltas)) {
+            ++failedBatches;
+            forgotten.add(batch.keys);
+            continue;
+        }
+        timer.output([&] { out.push(move(batch)); });
+    }
+    out.close();
+}
+
+// ------------------------------------------------------------
+// Stage 4: apply to the in-memory table
+// ------------------------------------------------------------
+void applyStage(Soccer& league, SpscQueue<GoalBatch>& in, StageMetrics& metrics, IngestStats& stats) {
+    StageTimer timer(metrics);
+
+    GoalBatch batch;
+    while (timer.input([&] { return in.pop(batch); })) {
+        ++metrics.items;
+        league.applyLoggedGoalEvents(batch.deltas);
+
+        Clock::time_point done = Clock::now();
+        stats.events += batch.events;
+        for (const auto& chunk : batch.chunks) {
+            stats.latency.add(done - chunk.first, chunk.second);
+        }
+    }
+}
+
+void reportStage(ostream& out, const char* name, const StageMetrics& m) {
+    double total = m.busySeconds + m.inputWaitSeconds + m.outputWaitSeconds;
+    auto percent = [total](double part) { return total > 0 ? int(100 * part / total + 0.5) : 0; };
+    out << "stage=" << name
+        << " items=" << m.items
+        << " busy_pct=" << percent(m.busySeconds)
+        << " input_wait_pct=" << percent(m.inputWaitSeconds)
+        << " output_wait_pct=" << percent(m.outputWaitSeconds)
+        << '\n';
+}
+
+void reportQueue(ostream& out, const char* name, const QueueMetrics& m) {
+    out << "queue=" << name
+        << " capacity=" << m.capacity
+        << " avg_occupancy=" << m.averageOccupancy
+        << " high_water=" << m.highWater
+        << " pushes=" << m.pushes
+        << " full_waits=" << m.fullWaits
+        << '\n';
+}
+
+} // namespace
+
+IngestPipeline::IngestPipeline(Soccer& league, IngestOptions options)
+    : league_(league), options_(options),
+      dedupe_(chrono::seconds(options.dedupeWindowSeconds), options.dedupeMaxKeys) {
+    options_.maxBatchEvents = max<size_t>(1, options_.maxBatchEvents);
+}
+
+// ------------------------------------------------------------
+// Function: ingestFile
+// ------------------------------------------------------------
+bool IngestPipeline::ingestFile(const string& path) {
+    if (path == "-") {
+        return ingestFd(STDIN_FILENO);
+    }
+
+    while (true) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR && !stopping_) continue;
+            if (errno == EINTR) return true;
+            cerr << "Error: Could not open " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+
+        struct stat info;
+        bool isFifo = fstat(fd, &info) == 0 && S_ISFIFO(info.st_mode);
+
+        bool ok = ingestFd(fd);
+        close(fd);
+
+        if (!ok || !isFifo || !options_.follow || stopping_) {
+            return ok;
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Function: ingestFd
+// ------------------------------------------------------------
+// Starts one thread per stage and waits for all of them. The
+// queues are closed front to back, so by the time the apply
+// thread returns every event that was read has been handled.
+// ------------------------------------------------------------
+bool IngestPipeline::ingestFd(int fd) {
+    Clock::time_point started = Clock::now();
+
+    SpscQueue<ParsedChunk> chunks(CHUNK_QUEUE_SIZE);
+    SpscQueue<GoalBatch> batches(BATCH_QUEUE_SIZE);
+    SpscQueue<GoalBatch> logged(BATCH_QUEUE_SIZE);
+
+    StageMetrics parseRun, validateRun, persistRun, applyRun;
+    uint64_t badLines = 0;         // Counted by the validate stage (parse counts travel in the chunks)
+    uint64_t duplicates = 0;
+    uint64_t failedBatches = 0;
+    IngestStats applied;
+    bool ok = true;
+
+    thread parser([&] { ok = parseStage(fd, options_, stopping_, chunks, parseRun); });
+    EventDedupe* dedupe = options_.dedupeWindowSeconds > 0 ? &dedupe_ : nullptr;
+    ForgottenKeys forgotten;
+    thread validator([&] {
+        validateStage(options_, dedupe, forgotten, chunks, batches, validateRun, badLines, duplicates);
+    });
+    thread persister([&] { persistStage(league_, forgotten, batches, logged, persistRun, failedBatches); });
+    thread applier([&] { applyStage(league_, logged, applyRun, applied); });
+
+    parser.join();
+    validator.join();
+    persister.join();
+    applier.join();
+    if (dedupe) forgotten.forgetIn(*dedupe);   // Refused after the validator finished
+
+    // Add this run to the totals (ingestFile() may run several).
+    stats_.badLines += badLines;
+    stats_.duplicates += duplicates;
+    stats_.failedBatches += failedBatches;
+    stats_.batches += persistRun.items;
+    stats_.events += applied.events;
+    stats_.latency.merge(applied.latency);
+    stats_.seconds += secondsSince(started);
+
+    auto addRun = [](StageMetrics& total, const StageMetrics& run) {
+        total.items += run.items;
+        total.busySeconds += run.busySeconds;
+        total.inputWaitSeconds += run.inputWaitSeconds;
+        total.outputWaitSeconds += run.outputWaitSeconds;
+    };
+    addRun(parseMetrics_, parseRun);
+    addRun(validateMetrics_, validateRun);
+    addRun(persistMetrics_, persistRun);
+    addRun(applyMetrics_, applyRun);
+
+    // Queues are rebuilt for every run; keep the latest numbers.
+    chunkQueue_ = chunks.metrics();
+    batchQueue_ = batches.metrics();
+    loggedQueue_ = logged.metrics();
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Function: report
+// ------------------------------------------------------------
+void IngestPipeline::report(ostream& out) const {
+    reportIngestStats(out, stats_);
+    reportStage(out, "parse", parseMetrics_);
+    reportStage(out, "validate", validateMetrics_);
+    reportStage(out, "persist", persistMetrics_);
+    reportStage(out, "apply", applyMetrics_);
+    reportQueue(out, "parse->validate", chunkQueue_);
+    reportQueue(out, "validate->persist", batchQueue_);
+    reportQueue(out, "persist->apply", loggedQueue_);
+}
@@ -0,0 +1,94 @@
+//
+// Module 9 - Streams and Files
+// Header File: IngestPipeline.h
+// ------------------------------------------------------------
+// A multi-threaded version of GoalIngestor for very high event
+// rates. The work is split into four stages, each on its own
+// thread, connected by bounded lock-free queues (SpscQueue.h):
+//
+//    read+parse ──► validate/normalize ──► persist ──► apply
+//         chunks               batches           batches
+//
+//   1. parse     reads the input in large chunks and splits every
+//                complete line into (name, delta).
+//   2. validate  trims names and drops bad ones and repeated
+//                event ids (the same checks as GoalIngestor, see
+//                normalizeEventName), and adds the deltas up per
+//                player into micro-batches
+//                (same size/delay rules as GoalIngestor).
+//   3. persist   appends each batch to the update log
+//                (Soccer::logGoalEvents – the slow, fdatasync part).
+//                The event ids of a batch it can't save are handed
+//                back to validate to be forgotten.
+//   4. apply     adds the batch to the in-memory table
+//                (Soccer::applyLoggedGoalEvents).
+//
+// Why persist BEFORE apply? The log is a write-ahead log: a change
+// that readers can see must already be on disk, or a crash could
+// "un-score" a goal somebody was shown. While batch N is being
+// applied, batch N+1 is already being synced, so the two still
+// overlap.
+//
+// Every queue is bounded. If a stage falls behind, its input queue
+// fills up, the stage before it blocks in push(), and eventually
+// the parse stage stops reading – so a writer on a pipe slows down
+// instead of the program's memory growing without limit.
+//
+// report() prints the usual GoalIngestor summary line, then one
+// line per stage (how much of its time it was busy vs. waiting)
+// and per queue (how full it was).
+//
+// Example:
+//   IngestPipeline pipeline(league);
+//   pipeline.ingestFile("/tmp/goals.fifo");
+//   pipeline.report(std::cerr);
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <atomic>
+#include <ostream>
+#include "GoalIngestor.h"   // IngestOptions, IngestStats, parseGoalEvent
+#include "SpscQueue.h"
+#include "Soccer.h"
+
+// Time one stage spent working vs. waiting on its queues.
+struct StageMetrics {
+    uint64_t items = 0;          // Chunks or batches handled
+    double busySeconds = 0;
+    double inputWaitSeconds = 0;   // Waiting for the stage before (queue empty)
+    double outputWaitSeconds = 0;  // Blocked by the stage after (queue full)
+};
+
+class IngestPipeline {
+public:
+    explicit IngestPipeline(Soccer& league, IngestOptions options = {});
+
+    // ------------------------------------------------------------
+    // Function: ingestFile
+    // ------------------------------------------------------------
+    // Same contract as GoalIngestor::ingestFile: "-" is standard
+    // input, and with 'follow' a FIFO is reopened for the next
+    // writer. Starts the stage threads and returns when all of
+    // them have finished.
+    // ------------------------------------------------------------
+    bool ingestFile(const std::string& path);
+    bool ingestFd(int fd);
+
+    // Asks the pipeline to drain what it has read and return.
+    // Safe to call from a signal handler.
+    void stop() { stopping_ = true; }
+
+    const IngestStats& stats() const { return stats_; }
+    void report(std::ostream& out) const;
+
+private:
+    Soccer& league_;
+    IngestOptions options_;
+    std::atomic<bool> stopping_{false};
+    IngestStats stats_;
+    EventDedupe dedupe_;            // Used only by the validate thread
+
+    StageMetrics parseMetrics_, validateMetrics_, persistMetrics_, applyMetrics_;
+    QueueMetrics chunkQueue_, batchQueue_, loggedQueue_;
+};
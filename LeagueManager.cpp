@@ -0,0 +1,231 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: LeagueManager.cpp
+// ------------------------------------------------------------
+// Many leagues in one process, within one memory budget (see
+// LeagueManager.h).
+//
+// Locking: an entry's loadMutex is always taken before mutex_,
+// never the other way round. mutex_ is only held for bookkeeping –
+// loading, measuring and checkpointing a league happen outside it,
+// so one slow disk never stalls requests for other leagues.
+// ------------------------------------------------------------
+
+#include "LeagueManager.h"
+#include "TaskScheduler.h"
+#include <filesystem>
+#include <iostream>
+using namespace std;
+
+LeagueManager::LeagueManager(size_t memoryBudget, size_t maxLoaded)
+    : memoryBudget_(memoryBudget), maxLoaded_(maxLoaded) {}
+
+LeagueManager::~LeagueManager() {
+    for (auto& entry : entries_) {
+        if (entry.second->soccer) entry.second->soccer->checkpoint();
+    }
+}
+
+// ------------------------------------------------------------
+// Function: addLeague
+// ------------------------------------------------------------
+bool LeagueManager::addLeague(const string& name, const string& filename) {
+    auto entry = make_shared<Entry>();
+    entry->filename = filename;
+
+    lock_guard<mutex> lock(mutex_);
+    return entries_.emplace(name, move(entry)).second;
+}
+
+// ------------------------------------------------------------
+// Function: addDirectory
+// ------------------------------------------------------------
+size_t LeagueManager::addDirectory(const string& directory) {
+    error_code error;
+    filesystem::directory_iterator it(directory, error);
+    if (error) {
+        cerr << "Error: Could not read directory " << directory << ": " << error.message() << "\n";
+        return 0;
+    }
+
+    size_t added = 0;
+    for (const auto& file : it) {
+        const filesystem::path& path = file.path();
+        if (!file.is_regular_file() || path.extension() != ".csv") continue;
+        if (addLeague(path.stem().string(), path.string())) ++added;
+    }
+    return added;
+}
+
+// ------------------------------------------------------------
+// Function: league
+// ------------------------------------------------------------
+// Steps:
+//   1. Loaded already: move it to the front of lru_ and return it.
+//   2. Otherwise take the entry's loadMutex (a second caller for
+//      the same league waits here instead of loading it twice),
+//      read the file without holding mutex_, and register it.
+//   3. trim() to make room, after every lock is released. The
+//      caller's pointer keeps the new league itself safe.
+// ------------------------------------------------------------
+shared_ptr<Soccer> LeagueManager::league(const string& name) {
+    shared_ptr<Entry> entry;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        if (it == entries_.end()) return nullptr;
+        entry = it->second;
+
+        if (entry->soccer) {
+            lru_.splice(lru_.begin(), lru_, entry->lru);
+            ++hits_;
+            return entry->soccer;
+        }
+    }
+
+    shared_ptr<Soccer> soccer;
+    {
+        lock_guard<mutex> loadLock(entry->loadMutex);
+        {
+            lock_guard<mutex> lock(mutex_);
+            if (entry->soccer) {   // Loaded while we waited
+                lru_.splice(lru_.begin(), lru_, entry->lru);
+                ++hits_;
+                return entry->soccer;
+            }
+        }
+
+        soccer = make_shared<Soccer>(entry->filename);
+        soccer->setVerbose(false);
+        soccer->setAsyncContext(TaskScheduler::shared(), io_);
+        size_t bytes = soccer->memoryUsage();
+
+        lock_guard<mutex> lock(mutex_);
+        entry->soccer = soccer;
+        entry->memoryBytes = bytes;
+        lru_.push_front(name);
+        entry->lru = lru_.begin();
+        memoryBytes_ += bytes;
+        ++loads_;
+    }
+
+    trim();
+    return soccer;
+}
+
+// ------------------------------------------------------------
+// Function: evict
+// ------------------------------------------------------------
+bool LeagueManager::evict(const string& name) {
+    shared_ptr<Entry> entry;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        if (it == entries_.end()) return false;
+        entry = it->second;
+    }
+    return evictEntry(*entry);
+}
+
+// ------------------------------------------------------------
+// Helper Function: trim
+// ------------------------------------------------------------
+// Leagues grow after they are loaded (addPlayer), so the loaded
+// ones are measured again first. Then victims are picked from the
+// least recently used end, skipping leagues that are in use.
+// ------------------------------------------------------------
+void LeagueManager::trim() {
+    vector<pair<shared_ptr<Entry>, size_t>> measured;
+    {
+        vector<pair<shared_ptr<Entry>, shared_ptr<Soccer>>> loaded;
+        {
+            lock_guard<mutex> lock(mutex_);
+            for (const string& name : lru_) {
+                const auto& entry = entries_.at(name);
+                loaded.push_back({entry, entry->soccer});
+            }
+        }
+        for (auto& league : loaded) {
+            measured.push_back({league.first, league.second->memoryUsage()});
+        }
+    }   // Our extra references to the leagues are gone again here
+
+    vector<shared_ptr<Entry>> victims;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (auto& m : measured) {
+            if (!m.first->soccer) continue;   // Evicted meanwhile
+            memoryBytes_ = memoryBytes_ - m.first->memoryBytes + m.second;
+            m.first->memoryBytes = m.second;
+        }
+
+        size_t bytes = memoryBytes_;
+        size_t count = lru_.size();
+        for (auto it = lru_.rbegin(); it != lru_.rend() && count > 1; ++it) {
+            if (bytes <= memoryBudget_ && (maxLoaded_ == 0 || count <= maxLoaded_)) break;
+
+            const auto& entry = entries_.at(*it);
+            if (entry->soccer.use_count() > 1) continue;   // Somebody is using it
+            victims.push_back(entry);
+            bytes -= entry->memoryBytes;
+            --count;
+        }
+    }
+
+    for (const auto& entry : victims) {
+        evictEntry(*entry);
+    }
+}
+
+// ------------------------------------------------------------
+// Helper Function: evictEntry
+// ------------------------------------------------------------
+// The league is checkpointed while loadMutex is still held: a
+// league() call for it waits until the file is complete before
+// reading it back.
+// ------------------------------------------------------------
+bool LeagueManager::evictEntry(Entry& entry) {
+    lock_guard<mutex> loadLock(entry.loadMutex);
+
+    shared_ptr<Soccer> soccer;
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (!entry.soccer || entry.soccer.use_count() > 1) return false;
+
+        soccer = move(entry.soccer);
+        lru_.erase(entry.lru);
+        memoryBytes_ -= entry.memoryBytes;
+        entry.memoryBytes = 0;
+        ++evictions_;
+    }
+
+    soccer->checkpoint();
+    return true;   // 'soccer' is the last reference: the table is freed here
+}
+
+// ------------------------------------------------------------
+// Function: leagueNames
+// ------------------------------------------------------------
+vector<string> LeagueManager::leagueNames() const {
+    lock_guard<mutex> lock(mutex_);
+    vector<string> names;
+    names.reserve(entries_.size());
+    for (const auto& entry : entries_) names.push_back(entry.first);
+    return names;
+}
+
+// ------------------------------------------------------------
+// Function: stats
+// ------------------------------------------------------------
+LeagueManagerStats LeagueManager::stats() const {
+    lock_guard<mutex> lock(mutex_);
+    LeagueManagerStats s;
+    s.hosted = entries_.size();
+    s.loaded = lru_.size();
+    s.memoryBytes = memoryBytes_;
+    s.memoryBudget = memoryBudget_;
+    s.hits = hits_;
+    s.loads = loads_;
+    s.evictions = evictions_;
+    return s;
+}
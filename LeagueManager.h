@@ -0,0 +1,137 @@
+//
+// Module 9 - Streams and Files
+// Header File: LeagueManager.h
+// ------------------------------------------------------------
+// Hosts many leagues (one data file each) in one process.
+//
+// A Soccer object keeps its whole file in memory, so hundreds of
+// them would need hundreds of processes – or a lot of RAM in one.
+// LeagueManager keeps only the leagues that are being used:
+//
+//   - Leagues are registered by name (addLeague / addDirectory)
+//     but not loaded. league(name) loads one on first use.
+//   - The loaded leagues share ONE memory budget. When loading a
+//     league pushes the total over it, the least recently used
+//     leagues are checkpointed (see Soccer::checkpoint) and
+//     dropped from memory – "evicted". Their data is already on
+//     disk, so the next league(name) simply loads them again.
+//   - A league somebody still holds (a shared_ptr returned by
+//     league()) is never evicted, so it can't disappear under a
+//     running request.
+//
+// Everything else is shared as well: every hosted league runs its
+// async calls (see Executor.h) on the process-wide TaskScheduler
+// and does its file writes on the manager's single I/O thread, so
+// the thread count stays the same however many leagues there are.
+//
+// Thread-safe: league() may be called from any thread.
+//
+// Example:
+//   LeagueManager leagues(64 << 20);          // 64 MB for all tables
+//   leagues.addDirectory("leagues");           // leagues/*.csv
+//   auto premier = leagues.league("premier");  // loads leagues/premier.csv
+//   premier->updatePlayer("Salah", 20);
+// ------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Soccer.h"
+#include "Executor.h"
+
+struct LeagueManagerStats {
+    size_t hosted = 0;          // Registered leagues
+    size_t loaded = 0;          // Leagues in memory right now
+    size_t memoryBytes = 0;     // Estimated bytes used by the loaded leagues
+    size_t memoryBudget = 0;
+    uint64_t hits = 0;          // league() calls that found the league loaded
+    uint64_t loads = 0;         // ...that had to read it from disk
+    uint64_t evictions = 0;
+};
+
+class LeagueManager {
+public:
+    // ------------------------------------------------------------
+    // Constructor
+    // ------------------------------------------------------------
+    // 'memoryBudget' is the total (estimated) size of all loaded
+    // tables in bytes. 'maxLoaded' additionally caps how many
+    // leagues are in memory at once (0 = no cap). One league is
+    // always kept, even if it alone is over the budget.
+    // ------------------------------------------------------------
+    explicit LeagueManager(size_t memoryBudget = 256u << 20, size_t maxLoaded = 0);
+
+    // Checkpoints and closes every loaded league.
+    ~LeagueManager();
+
+    LeagueManager(const LeagueManager&) = delete;
+    LeagueManager& operator=(const LeagueManager&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: addLeague / addDirectory
+    // ------------------------------------------------------------
+    // addLeague registers 'filename' under 'name' (false if the
+    // name is taken). addDirectory registers every *.csv file in
+    // 'directory', named after the file without ".csv", and
+    // returns how many were added.
+    // ------------------------------------------------------------
+    bool addLeague(const std::string& name, const std::string& filename);
+    size_t addDirectory(const std::string& directory);
+
+    // ------------------------------------------------------------
+    // Function: league
+    // ------------------------------------------------------------
+    // Returns the league, loading it if it isn't in memory, or
+    // nullptr if no league has this name. Keep the pointer only as
+    // long as you use the league – while you hold it, it can't be
+    // evicted (and async calls on it must finish before you let go).
+    // ------------------------------------------------------------
+    std::shared_ptr<Soccer> league(const std::string& name);
+
+    // Evicts one league now (false if unknown, not loaded or in use).
+    bool evict(const std::string& name);
+
+    // Registered names, sorted.
+    std::vector<std::string> leagueNames() const;
+
+    LeagueManagerStats stats() const;
+
+private:
+    struct Entry {
+        std::string filename;
+        std::shared_ptr<Soccer> soccer;        // nullptr while evicted
+        size_t memoryBytes = 0;                // Estimate from the last trim()
+        std::list<std::string>::iterator lru;  // Position in lru_ while loaded
+        std::mutex loadMutex;                  // One loader at a time per league
+    };
+
+    size_t memoryBudget_;
+    size_t maxLoaded_;
+
+    mutable std::mutex mutex_;   // Protects entries_ ... evictions_
+    std::map<std::string, std::shared_ptr<Entry>> entries_;
+    std::list<std::string> lru_;   // Loaded leagues, most recently used first
+    size_t memoryBytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t loads_ = 0;
+    uint64_t evictions_ = 0;
+
+    // The one I/O thread every hosted league writes on. Declared
+    // last so it finishes its jobs before the leagues are destroyed.
+    IoLoop io_;
+
+    // Re-measures the loaded leagues and evicts from the back of
+    // lru_ until they fit the budget again.
+    void trim();
+
+    // Checkpoints and unloads 'entry' unless it is in use or not
+    // loaded. Takes the entry's loadMutex, so a league is never
+    // read back from disk while it is still being written out.
+    bool evictEntry(Entry& entry);
+};
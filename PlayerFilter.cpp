@@ -0,0 +1,400 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: PlayerFilter.cpp
+// ------------------------------------------------------------
+// Parser and compiler for player filters (see PlayerFilter.h).
+// ------------------------------------------------------------
+
+#include "PlayerFilter.h"
+#include <memory>
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cctype>
+#include <utility>
+using namespace std;
+
+namespace {
+
+// ============================================================
+// Tokens
+// ============================================================
+
+struct Token {
+    enum Type { WORD, NUMBER, STRING, OPERATOR, OPEN, CLOSE, END } type;
+    string text;          // Lowercased for WORD
+    int64_t number = 0;   // NUMBER
+    size_t position = 0;  // Offset in the query, for error messages
+};
+
+bool tokenize(string_view text, vector<Token>& tokens, string& error) {
+    size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+
+        Token token;
+        token.position = i;
+        if (c == '(' || c == ')') {
+            token.type = (c == '(') ? Token::OPEN : Token::CLOSE;
+            ++i;
+        } else if (c == '\'' || c == '"') {
+            size_t end = text.find(c, i + 1);
+            if (end == string_view::npos) {
+                error = "unterminated string at " + to_string(i);
+                return false;
+            }
+            token.type = Token::STRING;
+            token.text = string(text.substr(i + 1, end - i - 1));
+            i = end + 1;
+        } else if (isdigit(static_cast<unsigned char>(c)) ||
+                   (c == '-' && i + 1 < text.size() && isdigit(static_cast<unsigned char>(text[i + 1])))) {
+            size_t end = i + 1;
+            while (end < text.size() && isdigit(static_cast<unsigned char>(text[end]))) ++end;
+            auto result = from_chars(text.data() + i, text.data() + end, token.number);
+            if (result.ec != errc() || token.number < INT_MIN || token.number > INT_MAX) {
+                error = "number out of range at " + to_string(i);
+                return false;
+            }
+            token.type = Token::NUMBER;
+            i = end;
+        } else if (c == '=' || c == '!' || c == '<' || c == '>') {
+            size_t length = (i + 1 < text.size() && text[i + 1] == '=') ? 2 : 1;
+            token.type = Token::OPERATOR;
+            token.text = string(text.substr(i, length));
+            if (token.text == "!") {
+                error = "expected != at " + to_string(i);
+                return false;
+            }
+            i += length;
+        } else if (isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t end = i;
+            while (end < text.size() &&
+                   (isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_')) {
+                ++end;
+            }
+            token.type = Token::WORD;
+            for (size_t k = i; k < end; ++k) {
+                token.text += static_cast<char>(tolower(static_cast<unsigned char>(text[k])));
+            }
+            i = end;
+        } else {
+            error = string("unexpected '") + c + "' at " + to_string(i);
+            return false;
+        }
+        tokens.push_back(move(token));
+    }
+
+    Token end;
+    end.type = Token::END;
+    end.position = text.size();
+    tokens.push_back(end);
+    return true;
+}
+
+// ============================================================
+// Syntax tree
+// ============================================================
+
+enum class NameTest { EQUALS, NOT_EQUALS, STARTS_WITH, ENDS_WITH, CONTAINS };
+
+struct Node {
+    enum Kind { GOALS, NAME, AND, OR, NOT } kind;
+    int64_t low = 0, high = 0;                // GOALS: low <= goals <= high
+    NameTest test = NameTest::EQUALS;         // NAME
+    string text;                              // NAME
+    vector<unique_ptr<Node>> children;        // AND / OR (2+), NOT (1)
+};
+
+unique_ptr<Node> goalsNode(int64_t low, int64_t high) {
+    auto node = make_unique<Node>();
+    node->kind = Node::GOALS;
+    node->low = low;
+    node->high = high;
+    return node;
+}
+
+unique_ptr<Node> notNode(unique_ptr<Node> child) {
+    auto node = make_unique<Node>();
+    node->kind = Node::NOT;
+    node->children.push_back(move(child));
+    return node;
+}
+
+// ------------------------------------------------------------
+// Class: Parser
+// ------------------------------------------------------------
+// Recursive descent, one function per grammar rule.
+// ------------------------------------------------------------
+class Parser {
+public:
+    Parser(const vector<Token>& tokens, string& error) : tokens_(tokens), error_(error) {}
+
+    unique_ptr<Node> parse() {
+        auto node = expr();
+        if (node && peek().type != Token::END) return fail("unexpected input");
+        return node;
+    }
+
+private:
+    const vector<Token>& tokens_;
+    string& error_;
+    size_t next_ = 0;
+
+    const Token& peek() const { return tokens_[next_]; }
+    const Token& take() { return tokens_[next_++]; }
+    bool isWord(const char* word) const {
+        return peek().type == Token::WORD && peek().text == word;
+    }
+
+    unique_ptr<Node> fail(const string& message) {
+        error_ = message + " at " + to_string(peek().position);
+        return nullptr;
+    }
+
+    // Parses 'operand (keyword operand)*' into one n-ary node.
+    template <typename Operand>
+    unique_ptr<Node> chain(const char* keyword, Node::Kind kind, Operand operand) {
+        auto first = (this->*operand)();
+        if (!first || !isWord(keyword)) return first;
+
+        auto node = make_unique<Node>();
+        node->kind = kind;
+        node->children.push_back(move(first));
+        while (isWord(keyword)) {
+            take();
+            auto next = (this->*operand)();
+            if (!next) return nullptr;
+            node->children.push_back(move(next));
+        }
+        return node;
+    }
+
+    unique_ptr<Node> expr() { return chain("or", Node::OR, &Parser::term); }
+    unique_ptr<Node> term() { return chain("and", Node::AND, &Parser::factor); }
+
+    unique_ptr<Node> factor() {
+        if (isWord("not")) {
+            take();
+            auto child = factor();
+            return child ? notNode(move(child)) : nullptr;
+        }
+        if (peek().type == Token::OPEN) {
+            take();
+            auto inner = expr();
+            if (!inner) return nullptr;
+            if (peek().type != Token::CLOSE) return fail("expected )");
+            take();
+            return inner;
+        }
+        if (isWord("goals")) {
+            take();
+            return goalsComparison();
+        }
+        if (isWord("name")) {
+            take();
+            return nameComparison();
+        }
+        return fail("expected goals, name, not or (");
+    }
+
+    // Every goals comparison becomes a range (or the NOT of one).
+    unique_ptr<Node> goalsComparison() {
+        if (peek().type != Token::OPERATOR) return fail("expected a comparison");
+        string op = take().text;
+        if (peek().type != Token::NUMBER) return fail("expected a number");
+        int64_t value = take().number;
+
+        if (op == "=" || op == "==") return goalsNode(value, value);
+        if (op == "!=") return notNode(goalsNode(value, value));
+        if (op == "<") return goalsNode(INT_MIN, value - 1);
+        if (op == "<=") return goalsNode(INT_MIN, value);
+        if (op == ">") return goalsNode(value + 1, INT_MAX);
+        return goalsNode(value, INT_MAX);   // ">="
+    }
+
+    unique_ptr<Node> nameComparison() {
+        auto node = make_unique<Node>();
+        node->kind = Node::NAME;
+
+        if (peek().type == Token::OPERATOR && (peek().text == "=" || peek().text == "==")) {
+            node->test = NameTest::EQUALS;
+        } else if (peek().type == Token::OPERATOR && peek().text == "!=") {
+            node->test = NameTest::NOT_EQUALS;
+        } else if (isWord("startswith")) {
+            node->test = NameTest::STARTS_WITH;
+        } else if (isWord("endswith")) {
+            node->test = NameTest::ENDS_WITH;
+        } else if (isWord("contains")) {
+            node->test = NameTest::CONTAINS;
+        } else {
+            return fail("expected =, !=, startswith, endswith or contains");
+        }
+        take();
+
+        if (peek().type != Token::STRING) return fail("expected a quoted string");
+        node->text = take().text;
+        return node;
+    }
+};
+
+// ------------------------------------------------------------
+// Helper Function: mergeRanges
+// ------------------------------------------------------------
+// Inside an "and", all goals ranges can be intersected into one:
+//   goals >= 5 and goals < 10  →  5 <= goals <= 9
+// ------------------------------------------------------------
+void mergeRanges(Node& node) {
+    for (auto& child : node.children) mergeRanges(*child);
+    if (node.kind != Node::AND) return;
+
+    Node* range = nullptr;
+    vector<unique_ptr<Node>> kept;
+    for (auto& child : node.children) {
+        if (child->kind != Node::GOALS) {
+            kept.push_back(move(child));
+        } else if (!range) {
+            range = child.get();
+            kept.push_back(move(child));
+        } else {
+            range->low = max(range->low, child->low);
+            range->high = min(range->high, child->high);
+        }
+    }
+    node.children = move(kept);
+}
+
+// ============================================================
+// Kernels
+// ============================================================
+
+using Kernel = PlayerFilter::Kernel;
+
+Kernel rangeKernel(int64_t low, int64_t high) {
+    if (low > high) {
+        return [](const string*, const int*, size_t, size_t count, uint8_t* match) {
+            fill(match, match + count, uint8_t(0));
+        };
+    }
+    // low <= g <= high  ⇔  (g - low) <= (high - low) as unsigned
+    // numbers: one compare per row, no branches.
+    uint32_t start = static_cast<uint32_t>(static_cast<int32_t>(low));
+    uint32_t span = static_cast<uint32_t>(high - low);
+    return [start, span](const string*, const int* goals, size_t begin, size_t count, uint8_t* match) {
+        const int* g = goals + begin;
+        for (size_t i = 0; i < count; ++i) {
+            match[i] = static_cast<uint32_t>(g[i]) - start <= span;
+        }
+    };
+}
+
+template <typename Test>
+Kernel nameKernel(string text, Test test) {
+    return [text = move(text), test](const string* names, const int*, size_t begin, size_t count,
+                                     uint8_t* match) {
+        const string* n = names + begin;
+        for (size_t i = 0; i < count; ++i) {
+            match[i] = test(string_view(n[i]), string_view(text));
+        }
+    };
+}
+
+Kernel compileNode(const Node& node) {
+    switch (node.kind) {
+        case Node::GOALS:
+            return rangeKernel(node.low, node.high);
+
+        case Node::NAME:
+            switch (node.test) {
+                case NameTest::EQUALS:
+                    return nameKernel(node.text, [](string_view n, string_view t) { return n == t; });
+                case NameTest::NOT_EQUALS:
+                    return nameKernel(node.text, [](string_view n, string_view t) { return n != t; });
+                case NameTest::STARTS_WITH:
+                    return nameKernel(node.text, [](string_view n, string_view t) { return n.starts_with(t); });
+                case NameTest::ENDS_WITH:
+                    return nameKernel(node.text, [](string_view n, string_view t) { return n.ends_with(t); });
+                case NameTest::CONTAINS:
+                    return nameKernel(node.text, [](string_view n, string_view t) {
+                        return n.find(t) != string_view::npos;
+                    });
+            }
+            break;
+
+        case Node::NOT: {
+            Kernel child = compileNode(*node.children[0]);
+            return [child](const string* names, const int* goals, size_t begin, size_t count, uint8_t* match) {
+                child(names, goals, begin, count, match);
+                for (size_t i = 0; i < count; ++i) match[i] ^= 1;
+            };
+        }
+
+        case Node::AND:
+        case Node::OR: {
+            if (node.children.size() == 1) return compileNode(*node.children[0]);
+
+            vector<Kernel> children;
+            for (const auto& child : node.children) children.push_back(compileNode(*child));
+            bool isAnd = (node.kind == Node::AND);
+
+            return [children, isAnd](const string* names, const int* goals, size_t begin, size_t count,
+                                     uint8_t* match) {
+                children[0](names, goals, begin, count, match);
+                uint8_t other[PlayerFilter::BATCH_SIZE];
+                for (size_t c = 1; c < children.size(); ++c) {
+                    // Skip the rest once the answer is already known
+                    // for the whole batch (all 0 for and, all 1 for or).
+                    uint8_t decided = isAnd ? 0 : 1;
+                    if (all_of(match, match + count, [decided](uint8_t m) { return m == decided; })) return;
+
+                    children[c](names, goals, begin, count, other);
+                    if (isAnd) {
+                        for (size_t i = 0; i < count; ++i) match[i] &= other[i];
+                    } else {
+                        for (size_t i = 0; i < count; ++i) match[i] |= other[i];
+                    }
+                }
+            };
+        }
+    }
+    return rangeKernel(1, 0);   // Not reached
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+// Function: compile
+// ------------------------------------------------------------
+bool PlayerFilter::compile(string_view text, PlayerFilter& filter, string& error) {
+    vector<Token> tokens;
+    if (!tokenize(text, tokens, error)) return false;
+
+    Parser parser(tokens, error);
+    unique_ptr<Node> tree = parser.parse();
+    if (!tree) return false;
+
+    mergeRanges(*tree);
+    filter.root_ = compileNode(*tree);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: select
+// ------------------------------------------------------------
+vector<uint32_t> PlayerFilter::select(const string* names, const int* goals, size_t n) const {
+    vector<uint32_t> rows;
+    if (!root_) return rows;
+
+    uint8_t match[BATCH_SIZE];
+    for (size_t begin = 0; begin < n; begin += BATCH_SIZE) {
+        size_t count = min(BATCH_SIZE, n - begin);
+        root_(names, goals, begin, count, match);
+        for (size_t i = 0; i < count; ++i) {
+            if (match[i]) rows.push_back(static_cast<uint32_t>(begin + i));
+        }
+    }
+    return rows;
+}
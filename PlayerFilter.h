@@ -0,0 +1,74 @@
+//
+// Module 9 - Streams and Files
+// Header File: PlayerFilter.h
+// ------------------------------------------------------------
+// A small query language for picking players:
+//
+//   goals >= 10 and name startswith 'R'
+//   (goals < 3 or goals > 20) and not name contains "Jr"
+//
+// Grammar (keywords are case-insensitive):
+//
+//   expr       := term ( "or" term )*
+//   term       := factor ( "and" factor )*
+//   factor     := "not" factor | "(" expr ")" | comparison
+//   comparison := "goals" ( = | == | != | < | <= | > | >= ) INTEGER
+//               | "name"  ( = | == | != | startswith | endswith
+//                         | contains ) STRING      ('...' or "...")
+//
+// A filter is parsed ONCE and compiled into a tree of closures,
+// each specialized for its column and operator. The table is then
+// evaluated in batches of 1024 rows: every closure runs one tight
+// loop over its column for the whole batch and writes a 0/1 per
+// row, and "and" / "or" / "not" combine those byte masks. The cost
+// of walking the tree is paid once per batch, not once per row,
+// and the goals loops are simple enough for the compiler to
+// vectorize.
+//
+// While compiling, every goals comparison becomes a range
+// [low, high], and ranges joined by "and" are merged, so
+// "goals >= 5 and goals < 10" is a single range test per row.
+//
+// Example:
+//   PlayerFilter filter;
+//   string error;
+//   if (!PlayerFilter::compile("goals >= 10", filter, error)) { ... }
+//   auto rows = filter.select(names.data(), goals.data(), names.size());
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+class PlayerFilter {
+public:
+    static constexpr size_t BATCH_SIZE = 1024;
+
+    // ------------------------------------------------------------
+    // Function: compile
+    // ------------------------------------------------------------
+    // Parses 'text' into 'filter'. On a syntax error returns false
+    // and describes the problem in 'error'.
+    // ------------------------------------------------------------
+    static bool compile(std::string_view text, PlayerFilter& filter, std::string& error);
+
+    // ------------------------------------------------------------
+    // Function: select
+    // ------------------------------------------------------------
+    // Row numbers (in order) of every row in names[0..n) /
+    // goals[0..n) that matches. An empty filter matches nothing.
+    // ------------------------------------------------------------
+    std::vector<uint32_t> select(const std::string* names, const int* goals, size_t n) const;
+
+    // One compiled node: writes match[i] = 0 or 1 for rows
+    // [begin, begin + count), count <= BATCH_SIZE.
+    using Kernel = std::function<void(const std::string* names, const int* goals,
+                                      size_t begin, size_t count, uint8_t* match)>;
+
+private:
+    Kernel root_;
+};
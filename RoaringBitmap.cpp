@@ -0,0 +1,195 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: RoaringBitmap.cpp
+// ------------------------------------------------------------
+// Compressed row sets (see RoaringBitmap.h).
+// ------------------------------------------------------------
+
+#include "RoaringBitmap.h"
+#include <algorithm>
+using namespace std;
+
+// ============================================================
+// Container
+// ============================================================
+
+bool RoaringBitmap::Container::contains(uint16_t low) const {
+    if (bits.empty()) return binary_search(array.begin(), array.end(), low);
+    return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+void RoaringBitmap::Container::toBitmap() {
+    bits.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : array) bits[low >> 6] |= uint64_t(1) << (low & 63);
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::toArray() {
+    vector<uint16_t> values;
+    values.reserve(cardinality);
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = bits[w];
+        while (word) {
+            values.push_back(uint16_t(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    array = move(values);
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+// ============================================================
+// RoaringBitmap
+// ============================================================
+
+RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) {
+    auto it = lower_bound(containers_.begin(), containers_.end(), key,
+                          [](const Container& c, uint16_t k) { return c.key < k; });
+    return (it != containers_.end() && it->key == key) ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) const {
+    return const_cast<RoaringBitmap*>(this)->find(key);
+}
+
+void RoaringBitmap::add(uint32_t value) {
+    uint16_t key = uint16_t(value >> 16);
+    uint16_t low = uint16_t(value & 0xFFFF);
+
+    auto it = lower_bound(containers_.begin(), containers_.end(), key,
+                          [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) {
+        it = containers_.insert(it, Container());
+        it->key = key;
+    }
+    Container& c = *it;
+
+    if (c.bits.empty()) {
+        auto place = lower_bound(c.array.begin(), c.array.end(), low);
+        if (place != c.array.end() && *place == low) return;
+        c.array.insert(place, low);
+        ++c.cardinality;
+        if (c.cardinality > ARRAY_LIMIT) c.toBitmap();
+    } else {
+        uint64_t& word = c.bits[low >> 6];
+        uint64_t bit = uint64_t(1) << (low & 63);
+        if (word & bit) return;
+        word |= bit;
+        ++c.cardinality;
+    }
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+    uint16_t key = uint16_t(value >> 16);
+    uint16_t low = uint16_t(value & 0xFFFF);
+    Container* c = find(key);
+    if (!c || !c->contains(low)) return;
+
+    if (c->bits.empty()) {
+        c->array.erase(lower_bound(c->array.begin(), c->array.end(), low));
+    } else {
+        c->bits[low >> 6] &= ~(uint64_t(1) << (low & 63));
+    }
+    --c->cardinality;
+
+    if (c->cardinality == 0) {
+        containers_.erase(containers_.begin() + (c - containers_.data()));
+    } else if (!c->bits.empty() && c->cardinality <= ARRAY_LIMIT / 2) {
+        // Only go back to an array well below the limit, so a row
+        // moving in and out at the boundary doesn't convert every time.
+        c->toArray();
+    }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const Container* c = find(uint16_t(value >> 16));
+    return c && c->contains(uint16_t(value & 0xFFFF));
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t total = 0;
+    for (const Container& c : containers_) total += c.cardinality;
+    return total;
+}
+
+// ------------------------------------------------------------
+// Function: andCardinality (per container)
+// ------------------------------------------------------------
+// bitmap & bitmap → AND + popcount, 64 rows per step
+// array & bitmap  → test each array value's bit
+// array & array   → merge the two sorted lists
+// ------------------------------------------------------------
+size_t RoaringBitmap::andCardinality(const Container& a, const Container& b) {
+    if (!a.bits.empty() && !b.bits.empty()) {
+        size_t count = 0;
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            count += __builtin_popcountll(a.bits[w] & b.bits[w]);
+        }
+        return count;
+    }
+    if (a.bits.empty() && !b.bits.empty()) return andCardinality(b, a);
+    if (!a.bits.empty()) {
+        size_t count = 0;
+        for (uint16_t low : b.array) count += (a.bits[low >> 6] >> (low & 63)) & 1;
+        return count;
+    }
+
+    size_t count = 0;
+    auto i = a.array.begin(), j = b.array.begin();
+    while (i != a.array.end() && j != b.array.end()) {
+        if (*i < *j) ++i;
+        else if (*j < *i) ++j;
+        else { ++count; ++i; ++j; }
+    }
+    return count;
+}
+
+size_t RoaringBitmap::andCardinality(const RoaringBitmap& a, const RoaringBitmap& b) {
+    size_t count = 0;
+    auto i = a.containers_.begin(), j = b.containers_.begin();
+    while (i != a.containers_.end() && j != b.containers_.end()) {
+        if (i->key < j->key) ++i;
+        else if (j->key < i->key) ++j;
+        else count += andCardinality(*i++, *j++);
+    }
+    return count;
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b) {
+    Container result;
+    result.key = a.key;
+
+    if (!a.bits.empty() && !b.bits.empty()) {
+        result.bits.resize(BITMAP_WORDS);
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            result.bits[w] = a.bits[w] & b.bits[w];
+            result.cardinality += __builtin_popcountll(result.bits[w]);
+        }
+        if (result.cardinality <= ARRAY_LIMIT) result.toArray();
+        return result;
+    }
+
+    const Container& small = a.bits.empty() ? a : b;
+    const Container& other = a.bits.empty() ? b : a;
+    for (uint16_t low : small.array) {
+        if (other.contains(low)) result.array.push_back(low);
+    }
+    result.cardinality = static_cast<uint32_t>(result.array.size());
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::intersect(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap result;
+    auto i = a.containers_.begin(), j = b.containers_.begin();
+    while (i != a.containers_.end() && j != b.containers_.end()) {
+        if (i->key < j->key) ++i;
+        else if (j->key < i->key) ++j;
+        else {
+            Container c = intersect(*i++, *j++);
+            if (c.cardinality > 0) result.containers_.push_back(move(c));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,91 @@
+//
+// Module 9 - Streams and Files
+// Header File: RoaringBitmap.h
+// ------------------------------------------------------------
+// A compressed set of row numbers in the style of "Roaring"
+// bitmaps, used by the filter indexes (see GoalBracketIndex.h)
+// and for the rows of each team (Soccer::countPlayers).
+//
+// A row number (32 bits) is split in two: the high 16 bits choose
+// a "container", the low 16 bits are stored inside it. Each
+// container covers 65536 rows and picks the cheaper of two forms:
+//
+//   array container   a sorted list of the low 16 bits
+//                     (best while it holds at most 4096 rows:
+//                      2 bytes per row, < 8 KiB)
+//   bitmap container  1024 x 64-bit words, one bit per row
+//                     (always exactly 8 KiB, best when dense)
+//
+// So a sparse set costs ~2 bytes per row and a dense one ~1 bit
+// per row, and set operations can work a whole 64-bit word (64
+// rows) at a time with a single AND + popcount.
+//
+// Example:
+//   RoaringBitmap strikers, scorers;
+//   strikers.add(3);  scorers.add(3);  scorers.add(9);
+//   size_t both = RoaringBitmap::andCardinality(strikers, scorers);   // 1
+// ------------------------------------------------------------
+
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class RoaringBitmap {
+public:
+    void add(uint32_t value);
+    void remove(uint32_t value);
+    bool contains(uint32_t value) const;
+
+    // Number of values in the set. O(number of containers).
+    size_t cardinality() const;
+    bool empty() const { return containers_.empty(); }
+
+    // Size of the intersection, without building it.
+    static size_t andCardinality(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    // The intersection as a new bitmap.
+    static RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    // Calls visit(value) for every value, in increasing order.
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const Container& c : containers_) {
+            uint32_t high = uint32_t(c.key) << 16;
+            if (c.bits.empty()) {
+                for (uint16_t low : c.array) visit(high | low);
+            } else {
+                for (size_t w = 0; w < c.bits.size(); ++w) {
+                    uint64_t word = c.bits[w];
+                    while (word) {
+                        visit(high | uint32_t(w * 64 + __builtin_ctzll(word)));
+                        word &= word - 1;   // Clear the lowest set bit
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr size_t ARRAY_LIMIT = 4096;   // Above this, a bitmap is smaller
+    static constexpr size_t BITMAP_WORDS = 65536 / 64;
+
+    struct Container {
+        uint16_t key = 0;                // High 16 bits of every value inside
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;     // Sorted; used while 'bits' is empty
+        std::vector<uint64_t> bits;      // BITMAP_WORDS words, or empty
+
+        bool contains(uint16_t low) const;
+        void toBitmap();
+        void toArray();
+    };
+
+    std::vector<Container> containers_;   // Sorted by key
+
+    Container* find(uint16_t key);
+    const Container* find(uint16_t key) const;
+
+    static size_t andCardinality(const Container& a, const Container& b);
+    static Container intersect(const Container& a, const Container& b);
+};
@@ -0,0 +1,55 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: ShardRing.cpp
+// ------------------------------------------------------------
+// Consistent hash ring (see ShardRing.h).
+// ------------------------------------------------------------
+
+#include "ShardRing.h"
+#include <algorithm>
+#include <string>
+using namespace std;
+
+ShardRing::ShardRing(size_t shards, size_t virtualNodes) : shards_(max<size_t>(1, shards)) {
+    virtualNodes = max<size_t>(1, virtualNodes);
+    marks_.reserve(shards_ * virtualNodes);
+    for (size_t shard = 0; shard < shards_; ++shard) {
+        for (size_t v = 0; v < virtualNodes; ++v) {
+            string key = "shard-" + to_string(shard) + "#" + to_string(v);
+            marks_.push_back({hash(key), static_cast<uint32_t>(shard)});
+        }
+    }
+    sort(marks_.begin(), marks_.end());
+}
+
+// ------------------------------------------------------------
+// Function: shardFor
+// ------------------------------------------------------------
+// Binary search for the first mark at or after the name's hash.
+// Past the last mark we wrap round to the first one.
+// ------------------------------------------------------------
+size_t ShardRing::shardFor(string_view name) const {
+    uint64_t position = hash(name);
+    auto it = lower_bound(marks_.begin(), marks_.end(), make_pair(position, uint32_t(0)));
+    if (it == marks_.end()) it = marks_.begin();
+    return it->second;
+}
+
+// ------------------------------------------------------------
+// Function: hash
+// ------------------------------------------------------------
+// FNV-1a, then a final mix: plain FNV barely changes the high bits
+// for short keys that differ only in their last character (like
+// "shard-0#1" and "shard-0#2"), which would bunch their marks up.
+// ------------------------------------------------------------
+uint64_t ShardRing::hash(string_view text) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
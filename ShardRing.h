@@ -0,0 +1,54 @@
+//
+// Module 9 - Streams and Files
+// Header File: ShardRing.h
+// ------------------------------------------------------------
+// Decides which shard owns a player, by consistent hashing.
+//
+// Picture a clock face numbered 0 .. 2^64-1. Every shard puts many
+// marks on it ("virtual nodes", at the hashes of "shard-0#0",
+// "shard-0#1", ...). A player belongs to the first mark at or after
+// the hash of its name, going round the clock.
+//
+// Why not simply hash(name) % shards? Because with the ring, adding
+// a shard only moves the players that land on its new marks (about
+// 1/N of them); with '%' nearly every player would move. The many
+// marks per shard keep the shards about equally full.
+//
+// The hash is FNV-1a, written out here, NOT std::hash: every
+// process (and every build) must agree on it, or a router and the
+// shards would disagree about who owns a player.
+//
+// Example:
+//   ShardRing ring(4);
+//   size_t shard = ring.shardFor("Messi");   // 0..3, always the same
+// ------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class ShardRing {
+public:
+    // ------------------------------------------------------------
+    // Constructor
+    // ------------------------------------------------------------
+    // 'shards' must be at least 1. More virtual nodes spread the
+    // players more evenly but make the (tiny) ring bigger.
+    // ------------------------------------------------------------
+    explicit ShardRing(size_t shards, size_t virtualNodes = 128);
+
+    // The shard (0 .. shardCount()-1) that owns 'name'.
+    size_t shardFor(std::string_view name) const;
+
+    size_t shardCount() const { return shards_; }
+
+    // 64-bit FNV-1a of 'text', stable across processes and builds.
+    static uint64_t hash(std::string_view text);
+
+private:
+    size_t shards_;
+    std::vector<std::pair<uint64_t, uint32_t>> marks_;   // (position, shard), sorted
+};
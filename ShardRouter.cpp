@@ -0,0 +1,183 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: ShardRouter.cpp
+// ------------------------------------------------------------
+// Routes requests to the shards of a league (see ShardRouter.h).
+// ------------------------------------------------------------
+
+#include "ShardRouter.h"
+#include "TopMerge.h"
+using namespace std;
+
+namespace {
+
+// ------------------------------------------------------------
+// Helper Function: gather
+// ------------------------------------------------------------
+// The requests are already on their way to the shards. The
+// returned future is "deferred": 'combine' runs on the caller's
+// thread when it asks for the result, after waiting for every
+// shard's reply.
+// ------------------------------------------------------------
+template <typename Combine>
+future<SoccerReply> gather(vector<future<SoccerReply>> replies, Combine combine) {
+    return async(launch::deferred, [replies = move(replies), combine]() mutable {
+        vector<SoccerReply> answers;
+        answers.reserve(replies.size());
+        for (auto& reply : replies) {
+            answers.push_back(reply.get());
+        }
+        for (auto& answer : answers) {
+            if (!answer.ok()) return move(answer);
+        }
+        return combine(answers);
+    });
+}
+
+} // namespace
+
+ShardRouter::ShardRouter(size_t batchSize) : batchSize_(batchSize) {}
+
+// ------------------------------------------------------------
+// Function: connect / disconnect
+// ------------------------------------------------------------
+bool ShardRouter::connect(const vector<string>& socketPaths) {
+    disconnect();
+    if (socketPaths.empty()) return false;
+
+    for (const string& path : socketPaths) {
+        shards_.push_back(make_unique<SoccerClient>(batchSize_));
+        if (!shards_.back()->connect(path)) {
+            disconnect();
+            return false;
+        }
+    }
+    ring_ = make_unique<ShardRing>(shards_.size());
+    return true;
+}
+
+void ShardRouter::disconnect() {
+    shards_.clear();   // Each SoccerClient disconnects in its destructor
+    ring_.reset();
+}
+
+size_t ShardRouter::shardFor(const string& name) const {
+    return ring_ ? ring_->shardFor(name) : 0;
+}
+
+SoccerClient& ShardRouter::owner(const string& name) {
+    return *shards_[shardFor(name)];
+}
+
+// ------------------------------------------------------------
+// Point requests: only the owner is asked
+// ------------------------------------------------------------
+future<SoccerReply> ShardRouter::get(const string& name) {
+    return owner(name).get(name);
+}
+
+future<SoccerReply> ShardRouter::add(const string& name, int goals) {
+    return owner(name).add(name, goals);
+}
+
+future<SoccerReply> ShardRouter::update(const string& name, int goals) {
+    return owner(name).update(name, goals);
+}
+
+void ShardRouter::queueUpdate(const string& name, int goals) {
+    owner(name).queueUpdate(name, goals);
+}
+
+// ------------------------------------------------------------
+// Function: updateBatch
+// ------------------------------------------------------------
+// Split into one batch per shard; shards with nothing to do are
+// not asked at all.
+// ------------------------------------------------------------
+future<SoccerReply> ShardRouter::updateBatch(const vector<pair<string, int>>& updates) {
+    vector<vector<pair<string, int>>> perShard(shards_.size());
+    for (const auto& update : updates) {
+        perShard[shardFor(update.first)].push_back(update);
+    }
+
+    vector<future<SoccerReply>> replies;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        if (!perShard[i].empty()) replies.push_back(shards_[i]->updateBatch(perShard[i]));
+    }
+    return gather(move(replies), [](vector<SoccerReply>&) { return SoccerReply{}; });
+}
+
+future<SoccerReply> ShardRouter::flush() {
+    vector<future<SoccerReply>> replies;
+    for (auto& shard : shards_) {
+        replies.push_back(shard->flush());
+    }
+    return gather(move(replies), [](vector<SoccerReply>&) { return SoccerReply{}; });
+}
+
+// ------------------------------------------------------------
+// Scatter-gather requests: every shard is asked
+// ------------------------------------------------------------
+future<SoccerReply> ShardRouter::view() {
+    vector<future<SoccerReply>> replies;
+    for (auto& shard : shards_) {
+        replies.push_back(shard->view());
+    }
+    return gather(move(replies), [](vector<SoccerReply>& answers) {
+        SoccerReply all;
+        for (auto& answer : answers) {
+            all.players.insert(all.players.end(), make_move_iterator(answer.players.begin()),
+                               make_move_iterator(answer.players.end()));
+        }
+        return all;
+    });
+}
+
+// Each shard sends its own top n, already sorted; the league's top n
+// is among them.
+future<SoccerReply> ShardRouter::top(uint32_t n) {
+    vector<future<SoccerReply>> replies;
+    for (auto& shard : shards_) {
+        replies.push_back(shard->top(n));
+    }
+    return gather(move(replies), [n](vector<SoccerReply>& answers) {
+        vector<vector<pair<string, int>>> lists;
+        lists.reserve(answers.size());
+        for (auto& answer : answers) {
+            lists.push_back(move(answer.players));
+        }
+        SoccerReply best;
+        best.players = TopMerge::merge(lists, n);
+        return best;
+    });
+}
+
+future<SoccerReply> ShardRouter::stats() {
+    vector<future<SoccerReply>> replies;
+    for (auto& shard : shards_) {
+        replies.push_back(shard->stats());
+    }
+    return gather(move(replies), [](vector<SoccerReply>& answers) {
+        SoccerReply all;
+        for (size_t i = 0; i < answers.size(); ++i) {
+            for (auto& counter : answers[i].players) {
+                all.players.push_back({"shard-" + to_string(i) + "." + counter.first, counter.second});
+            }
+        }
+        return all;
+    });
+}
+
+future<SoccerReply> ShardRouter::count(int minGoals, int maxGoals) {
+    vector<future<SoccerReply>> replies;
+    for (auto& shard : shards_) {
+        replies.push_back(shard->count(minGoals, maxGoals));
+    }
+    return gather(move(replies), [](vector<SoccerReply>& answers) {
+        SoccerReply total;
+        for (const auto& answer : answers) {
+            total.count += answer.count;
+        }
+        return total;
+    });
+}
@@ -0,0 +1,92 @@
+//
+// Module 9 - Streams and Files
+// Header File: ShardRouter.h
+// ------------------------------------------------------------
+// One league spread over several SoccerServer processes ("shards").
+//
+// A single server applies every write on one thread, so that is as
+// fast as writes can go. With N shards, each owning only part of
+// the players in its own data file, N writers work at once.
+//
+// ShardRouter looks like a SoccerClient (same calls, same futures)
+// but holds one connection per shard:
+//
+//   - get / add / update   → sent only to the shard that owns the
+//                            player (ShardRing, consistent hashing)
+//   - updateBatch / queueUpdate
+//                          → split by owner, one batch per shard
+//   - view / top / count   → sent to every shard at once ("scatter"),
+//                            and the answers combined ("gather"):
+//                            view concatenates, count adds up, and
+//                            top merges the shards' sorted lists
+//                            (TopMerge::merge)
+//
+// Every shard must be started with the same shard number as its
+// position in connect()'s list, and a player must only ever be
+// written through a router with the same shard count – otherwise
+// the ring sends it to a different shard.
+//
+// Example (three shards started with "Module9_Code_Together cluster 3"):
+//   ShardRouter router;
+//   router.connect({"/tmp/soccer-shard-0.sock",
+//                   "/tmp/soccer-shard-1.sock",
+//                   "/tmp/soccer-shard-2.sock"});
+//   router.update("Messi", 13);              // goes to Messi's shard only
+//   auto best = router.top(10).get();         // asks all three
+// ------------------------------------------------------------
+
+#pragma once
+#include "SoccerClient.h"
+#include "ShardRing.h"
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ShardRouter {
+public:
+    // 'batchSize' is passed on to every shard's SoccerClient.
+    explicit ShardRouter(size_t batchSize = 256);
+
+    // ------------------------------------------------------------
+    // Function: connect / disconnect
+    // ------------------------------------------------------------
+    // Connects to every socket; socketPaths[i] is shard i. Fails
+    // (and stays disconnected) if any shard can't be reached.
+    // ------------------------------------------------------------
+    bool connect(const std::vector<std::string>& socketPaths);
+    void disconnect();
+
+    size_t shardCount() const { return shards_.size(); }
+    size_t shardFor(const std::string& name) const;
+
+    // ------------------------------------------------------------
+    // Requests (see SoccerClient.h)
+    // ------------------------------------------------------------
+    // All of them return at once. The scatter-gather ones send to
+    // every shard first and combine the replies when get() is
+    // called on the returned future. If any shard fails, that
+    // shard's reply is the result.
+    // ------------------------------------------------------------
+    std::future<SoccerReply> view();
+    std::future<SoccerReply> get(const std::string& name);
+    std::future<SoccerReply> add(const std::string& name, int goals);
+    std::future<SoccerReply> update(const std::string& name, int goals);
+    std::future<SoccerReply> top(uint32_t n);
+    std::future<SoccerReply> count(int minGoals, int maxGoals);
+    std::future<SoccerReply> updateBatch(const std::vector<std::pair<std::string, int>>& updates);
+
+    // Every shard's counters, each name prefixed with "shard-<i>.".
+    std::future<SoccerReply> stats();
+
+    void queueUpdate(const std::string& name, int goals);
+    std::future<SoccerReply> flush();
+
+private:
+    size_t batchSize_;
+    std::vector<std::unique_ptr<SoccerClient>> shards_;
+    std::unique_ptr<ShardRing> ring_;
+
+    SoccerClient& owner(const std::string& name);
+};
@@ -7,7 +7,7 @@
 //
 //   1. ifstream  → read data from a file
 //   2. ofstream  → append new data to a file
-//   3. fstream   → read and update a file at the same time
+//   3. ofstream  → rewrite the whole file after an update
 //
 // Each function in this file connects directly to concepts
 // you’ve seen in class: opening files, checking for errors,
@@ -15,71 +15,192 @@
 // ------------------------------------------------------------
 
 #include "Soccer.h"
+#include "SoccerSnapshot.h"
+#include "FormTracker.h"
+#include "CrackedColumn.h"
+#include "TaskScheduler.h"
+#include "FileChecksum.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <utility>  // for std::pair
+#include <algorithm> // for partial_sort
+#include <mutex>    // for unique_lock
+#include <cstdio>   // for rename / remove
+#include <fcntl.h>  // for open (used to fsync a finished file)
+#include <unistd.h> // for fsync / close / access
+#include <filesystem> // for listing a team directory
+#include <glob.h>   // for glob (team file patterns)
+#include <fnmatch.h> // for fnmatch (does a new team file fit the pattern?)
 using namespace std;
 
+namespace {
+
+// True if 'filename' is a glob pattern rather than a path.
+bool hasWildcards(const string& filename) {
+    return filename.find_first_of("*?[") != string::npos;
+}
+
+// The directory a glob pattern searches: everything before the
+// last '/' ahead of the first wildcard ("." if there is none).
+string patternDirectory(const string& pattern) {
+    size_t slash = pattern.rfind('/', pattern.find_first_of("*?["));
+    return (slash == string::npos) ? "." : pattern.substr(0, slash);
+}
+
+// Where the update log and goal history of a league live (see
+// Soccer.h): next to a single file, or inside the team directory.
+string storageBaseFor(const string& filename) {
+    error_code error;
+    if (hasWildcards(filename)) {
+        return (filesystem::path(patternDirectory(filename)) / "league").string();
+    }
+    if (filesystem::is_directory(filename, error)) {
+        return (filesystem::path(filename) / "league").string();
+    }
+    return filename;
+}
+
+// ------------------------------------------------------------
+// Helper Function: readRoster
+// Stream used: ifstream  (input file stream)
+// ------------------------------------------------------------
+// Reads every "Name,Goals" line of one file into 'rows'. Returns
+// false if the file can't be opened. Touches nothing else, so
+// several files can be read at the same time.
+//
+// Lines that aren't "Name,Goals" go to 'unreadable' exactly as
+// they are, so they can be written back (see rewriteFile). Blocks
+// that don't match their checksum (see FileChecksum.h) are only
+// reported: every line in them that still reads is kept.
+// ------------------------------------------------------------
+bool readRoster(const string& path, vector<pair<string, int>>& rows, vector<string>& unreadable) {
+    ifstream in(path); // Open for reading
+
+    if (!in) {
+        return false;
+    }
+
+    string line;
+    while (getline(in, line)) {          // Read each line from the file
+        if (line.empty()) continue;      // Skip blank lines
+
+        // The name runs up to the last comma, the goals come after
+        // it – the same rule the update log uses.
+        string_view name;
+        int goals;
+        if (!SoccerLog::parseRow(line, name, goals)) {
+            unreadable.push_back(line);
+            continue;
+        }
+        rows.push_back({string(name), goals});
+    }
+
+    FileChecksum::Report report = FileChecksum::verifyFile(path);
+    if (!report.ok()) {
+        cerr << "Warning: " << report.damaged.size() << " block(s) of " << path
+             << " don't match their checksum. Run \"repair\" to store new checksums.\n";
+    }
+    if (!unreadable.empty()) {
+        cerr << "Warning: " << unreadable.size() << " line(s) of " << path
+             << " aren't \"Name,Goals\" and are kept as they are. Run \"repair\" to move them to "
+             << path << ".damaged.\n";
+    }
+    return true;
+
+    // File closes automatically here when 'in' goes out of scope.
+}
+
+// SoccerLog::validName(), with an error message if it isn't.
+bool checkName(const string& name) {
+    if (SoccerLog::validName(name)) return true;
+    cerr << "Error: A player name can't be empty or contain ',' or a line break.\n";
+    return false;
+}
+
+} // namespace
+
 // ------------------------------------------------------------
 // Constructor
 // ------------------------------------------------------------
-// The constructor saves the filename in 'filename_' and makes sure
-// the file exists before any other function tries to open it.
+// The constructor saves the filename in 'filename_', finds the
+// team files (just the one file, unless it's a directory or a
+// pattern), makes sure the file exists, and then reads it into
+// memory once (plus any goal events still waiting in the update log).
 //
 // The 'explicit' keyword in the header prevents accidental conversions
 // like: Soccer league = "file.csv";
 // ------------------------------------------------------------
-Soccer::Soccer(const string& filename) : filename_(filename) {
+Soccer::Soccer(const string& filename)
+    : filename_(filename), storageBase_(storageBaseFor(filename)), log_(storageBase_ + ".log") {
+    findTeamFiles();
+    recoverCheckpoint();
     ensureFileExists();
+    loadPlayers();
+    replayLog();
+
+    // The goal history is only kept if it was turned on before
+    // (by the first recordGoals() call).
+    string eventsPath = storageBase_ + ".events";
+    if (GoalEventStore::exists(eventsPath)) {
+        events_ = make_unique<GoalEventStore>(eventsPath);
+        if (!events_->open()) {
+            events_.reset();
+        }
+    }
 }
 
+// The destructor lives here (not in the header) because unique_ptr
+// needs the full SoccerSnapshotWriter and FormTracker types to delete them.
+Soccer::~Soccer() = default;
+
 // ------------------------------------------------------------
 // Function: displayPlayers
-// Stream used: ifstream  (input file stream)
 // ------------------------------------------------------------
 // Purpose:
-//   Reads each line from the file and displays it in a
+//   Displays every record in the in-memory table in a
 //   readable format.
 //
-//   This demonstrates opening a file for **reading only**.
-//
 // Notes:
-//   - Always check if the file opened successfully.
-//   - Each line is expected to be in "Name,Goals" format.
+//   - The table was read from the file by loadPlayers(), so this
+//     function does not need to open the file again.
+//   - players() holds a shared lock while it runs, so several
+//     threads can display at the same time.
 // ------------------------------------------------------------
 void Soccer::displayPlayers() {
-    ifstream in(filename_); // Open for reading
-
-    if (!in) {
-        cerr << "Error: Could not open " << filename_ << " for reading.\n";
-        return;
-    }
-
     cout << "\nCurrent Soccer Stats:\n";
     cout << "----------------------------\n";
 
-    string line;
-    while (getline(in, line)) {          // Read each line from the file
-        if (line.empty()) continue;      // Skip blank lines
-
-        // 'ss' lets us treat the string like a stream (just like cin).
-        // getline() reads up to the comma (storing "Messi" into name),
-        // and then 'ss >> goals' reads the remaining number (12) into goals.
-
-
-        stringstream ss(line);           // Convert the line into a stream
-        string name;
-        int goals;
-
-        getline(ss, name, ',');  // Read characters up to the comma into 'name'
-        ss >> goals;                        // Read the number after the comma into 'goals'
+    for (const PlayerRecord& p : players()) {
+        cout << "Player: " << p.name << " | Goals: " << p.goals << '\n';
+    }
+    cout.flush();
+}
 
-        cout << "Player: " << name << " | Goals: " << goals << endl;
+// ------------------------------------------------------------
+// Function: players
+// ------------------------------------------------------------
+// The lock is a local variable of the coroutine, so it lives in the
+// coroutine frame: taken when the loop asks for the first record,
+// released when the generator is destroyed (even after a break).
+// ------------------------------------------------------------
+Generator<PlayerRecord> Soccer::players() const {
+    shared_lock<shared_mutex> lock(mutex_);
+    for (size_t i = 0; i < names_.size(); ++i) {
+        co_yield PlayerRecord{names_[i], goals_[i]};
     }
+}
 
-    // File closes automatically here when 'in' goes out of scope.
+// ------------------------------------------------------------
+// Function: records
+// ------------------------------------------------------------
+SoccerViews::RecordView Soccer::records() const {
+    shared_lock<shared_mutex> lock(mutex_);
+    const string* names = names_.data();
+    const int* goals = goals_.data();
+    size_t size = names_.size();
+    return SoccerViews::RecordView(move(lock), names, goals, size);
 }
 
 // ------------------------------------------------------------
@@ -93,108 +214,1404 @@ void Soccer::displayPlayers() {
 // Notes:
 //   - ios::app ensures existing data is not erased.
 //   - Each new record is added as "Name,Goals" on a new line.
+//   - The in-memory table is only changed if the write succeeded.
 // ------------------------------------------------------------
 
 // 'name' is passed by const reference to avoid copying a large string.
 // 'goals' is passed by value because ints are small and cheap to copy.
-void Soccer::addPlayer(const string& name, int goals) {
-    ofstream out(filename_, ios::app); // Open for writing in append mode
+bool Soccer::addPlayer(const string& name, int goals) {
+    return addPlayer(name, goals, string());   // "" = the first team
+}
+
+bool Soccer::addPlayer(const string& name, int goals, const string& team) {
+    if (!checkName(name)) return false;
+
+    lock_guard<mutex> logLock(logMutex_);
+    unique_lock<shared_mutex> lock(mutex_);
+
+    int t = teamIndex(team);
+    if (t < 0) {
+        if (team.empty()) {
+            cerr << "Error: " << filename_ << " has no team file for new players.\n";
+        } else {
+            cerr << "Error: " << filename_ << " has no team named " << team << ".\n";
+        }
+        return false;
+    }
+
+    // Logged batches must reach the table first, so that logDirty_
+    // says whether the log holds anything.
+    loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+
+    // While the update log holds records, the log is replayed AFTER
+    // the file is read, so a row appended to the file now would be
+    // changed by records from before it existed. The row goes to
+    // the log instead ("Name,#N"), after them. Replay can only put
+    // such rows in the first team, so other teams rewrite their
+    // file (which folds the log in first). So does a first team
+    // whose file doesn't exist yet: replay wouldn't find it.
+    //
+    // The goal history (if any) is written first, like logDeltas().
+    // If the row then can't be written, the correction is taken
+    // back (and rebuildFromEvents() skips a name whose events add
+    // up to nothing), so the history never adds a player the table
+    // doesn't have.
+    bool isNew = (index_.find(name) == index_.end());
+    if (isNew && !recordCorrection(name, 0, goals)) {
+        return false;
+    }
+    auto fail = [&](const string& what) {
+        cerr << "Error: Could not open " << what << " for writing.\n";
+        if (isNew) recordCorrection(name, goals, 0);
+        return false;
+    };
+
+    if (logDirty_) {
+        error_code existsError;
+        bool fileExists = filesystem::exists(teamFiles_[t], existsError);
+        bool saved = true;
+        if (t == teamIndex("") && fileExists) {
+            string records;
+            SoccerLog::formatAdd(records, name, goals);
+            if (!logAhead(records)) {
+                return fail(filename_);
+            }
+            appendRow(name, goals, static_cast<uint16_t>(t));
+            dirtyTeams_[t] = true;
+            compactLog(lock);
+        } else {
+            // The rewrite writes the table, so the row goes in first.
+            // If it fails the row stays (the table and the history
+            // agree) and the next rewrite saves it.
+            appendRow(name, goals, static_cast<uint16_t>(t));
+            dirtyTeams_[t] = true;
+            saved = rewriteFile(lock);
+        }
+        feedAdd(name, goals);
+        if (isNew) {
+            refreshSnapshot(nullptr);
+        }
+        if (!saved) {
+            cerr << "Error: Could not open " << filename_ << " for writing.\n";
+            return false;
+        }
+        if (verbose_) {
+            cout << "Added " << name << " with " << goals << " goals.\n";
+        }
+        return true;
+    }
+
+    error_code sizeError;
+    uintmax_t offset = filesystem::file_size(teamFiles_[t], sizeError);   // Where the new line starts
+
+    ofstream out(teamFiles_[t], ios::app); // Open for writing in append mode
 
     if (!out) {
-        cerr << "Error: Could not open " << filename_ << " for writing.\n";
-        return;
+        return fail(teamFiles_[t]);
+    }
+
+    string line = name + "," + to_string(goals) + "\n";
+    if (!(out << line) || !out.flush()) {   // Write to the file
+        // Cut off whatever part of the line got there.
+        error_code resizeError;
+        if (!sizeError) filesystem::resize_file(teamFiles_[t], offset, resizeError);
+        return fail(teamFiles_[t]);
+    }
+
+    // The new line gets a checksum block of its own (now that it is
+    // really in the file).
+    if (!sizeError &&
+        !FileChecksum::appendBlock(FileChecksum::sidecarPath(teamFiles_[t]), FileChecksum::makeBlock(offset, line))) {
+        cerr << "Error: Could not update " << FileChecksum::sidecarPath(teamFiles_[t]) << ".\n";
+    }
+
+    // Only now, with the line in the file, does the table change.
+    // A repeated name doesn't change the snapshot (the first row wins).
+    appendRow(name, goals, static_cast<uint16_t>(t));
+    feedAdd(name, goals);
+    if (isNew) {
+        refreshSnapshot(nullptr);
     }
 
-    out << name << "," << goals << "\n"; // Write to the file
-    cout << "Added " << name << " with " << goals << " goals.\n";
+    if (verbose_) {
+        cout << "Added " << name << " with " << goals << " goals.\n";
+    }
+    return true;
 
     // No need to call out.close(); it closes automatically.
 }
 
 // ------------------------------------------------------------
 // Function: updatePlayer
-// Stream used: fstream (read/write file stream)
 // ------------------------------------------------------------
 // Purpose:
 //   Updates an existing player's goals, or adds them if they
 //   don’t already exist.
 //
-//   Demonstrates the use of ios::in | ios::out for both reading
-//   and writing in the same file.
-//
 // Steps:
-//   1. Read all lines into a vector (memory).
-//   2. Modify or add the target player.
-//   3. Clear and seek to the start of the file.
-//   4. Rewrite the entire file with updated data.
+//   1. Append a "Name,=N" record to the update log.
+//   2. Look the player up in the name index (no file reading needed).
+//   3. Modify or add the target player in memory.
+//
+// Returns false, with the table unchanged, if the change can't be
+// written.
+//
+// Notes:
+//   - Every row with a matching name is updated, the same as
+//     when the file was scanned line by line.
+//   - The file itself is rewritten only once the log has grown
+//     too big (see compactLog), so an update writes one short
+//     line instead of the whole file.
+// ------------------------------------------------------------
+bool Soccer::updatePlayer(const string& name, int newGoals) {
+    if (!checkName(name)) return false;
+
+    lock_guard<mutex> logLock(logMutex_);
+    unique_lock<shared_mutex> lock(mutex_);
+
+    // The "=" record must come after every logged batch in the log,
+    // and (with a goal history) the correction is worked out from
+    // the current total, which must include those batches too.
+    loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+    int oldGoals = 0;
+    if (events_) {
+        auto it = index_.find(name);
+        if (it != index_.end()) oldGoals = goals_[it->second.front()];
+    }
+
+    // Nothing changes unless the history took the correction.
+    if (!recordCorrection(name, oldGoals, newGoals)) {
+        return false;
+    }
+
+    // Step 1: Record the change
+    string records;
+    SoccerLog::formatSet(records, name, newGoals);
+    if (!logAhead(records)) {
+        cerr << "Error: Could not open " << filename_ << " for updating.\n";
+        recordCorrection(name, newGoals, oldGoals);   // Take it back
+        return false;
+    }
+
+    // Step 2 + 3: Modify or add the player
+    bool found = setGoals(name, newGoals);
+    if (changeFeed_) changeFeed_(records);
+    refreshSnapshot(found ? &name : nullptr);
+    compactLog(lock);
+
+    if (verbose_) {
+        if (!found) {
+            cout << name << " not found — adding as a new player.\n";
+        } else {
+            cout << "Updated " << name << "'s goals to " << newGoals << ".\n";
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: updatePlayers
+// ------------------------------------------------------------
+// Purpose:
+//   Applies a whole batch of updates and logs all of them with a
+//   single append.
+//
+// Notes:
+//   - Later entries for the same name win, exactly as if
+//     updatePlayer() had been called for each one in order.
+//   - Like updatePlayer(), the batch is logged before the table
+//     changes: it is applied completely or not at all.
+// ------------------------------------------------------------
+bool Soccer::updatePlayers(const vector<pair<string, int>>& updates) {
+    if (updates.empty()) return true;
+    for (const auto& u : updates) {
+        if (!checkName(u.first)) return false;   // None of the batch is applied
+    }
+
+    lock_guard<mutex> logLock(logMutex_);
+    unique_lock<shared_mutex> lock(mutex_);
+    loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+
+    // With a goal history, each change is also recorded as a
+    // correction; all of them go to disk in one append, before the
+    // table is touched. If that fails, none of the batch is applied.
+    vector<GoalEvent> corrections;
+    if (events_) {
+        unordered_map<string, int> batchGoals;   // Set by earlier entries of this batch
+        for (const auto& u : updates) {
+            int oldGoals = 0;
+            auto seen = batchGoals.find(u.first);
+            if (seen != batchGoals.end()) {
+                oldGoals = seen->second;
+            } else {
+                auto it = index_.find(u.first);
+                if (it != index_.end()) oldGoals = goals_[it->second.front()];
+            }
+            if (oldGoals != u.second) {
+                corrections.push_back({u.first, 0, 0, u.second - oldGoals});
+            }
+            batchGoals[u.first] = u.second;
+        }
+        if (!events_->append(corrections)) {
+            cerr << "Error: Could not record the updates in the goal history.\n";
+            return false;
+        }
+    }
+
+    string records;
+    records.reserve(updates.size() * 16);
+    for (const auto& u : updates) SoccerLog::formatSet(records, u.first, u.second);
+    if (!logAhead(records)) {
+        cerr << "Error: Could not open " << filename_ << " for updating.\n";
+        for (GoalEvent& c : corrections) c.delta = -c.delta;   // Take them back
+        if (!corrections.empty()) events_->append(corrections);
+        return false;
+    }
+
+    for (const auto& u : updates) {
+        setGoals(u.first, u.second);
+    }
+    if (changeFeed_) changeFeed_(records);
+    refreshSnapshot(nullptr);
+    compactLog(lock);
+
+    if (verbose_) {
+        cout << "Applied " << updates.size() << " updates.\n";
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: applyGoalEvents
+// ------------------------------------------------------------
+// Purpose:
+//   Applies a batch of goal deltas. The log is written first
+//   ("write-ahead"), then the in-memory table is changed.
+//
+// Notes:
+//   - soccer.csv itself is not touched; see SoccerLog.h.
+// ------------------------------------------------------------
+bool Soccer::applyGoalEvents(const vector<pair<string, int>>& deltas) {
+    if (!logGoalEvents(deltas)) {
+        return false;
+    }
+    applyLoggedGoalEvents(deltas);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: applyRecords
+// ------------------------------------------------------------
+// Purpose:
+//   Replays shipped update records on this table: '+' adds goals,
+//   '=' sets them, '#' appends a row – the same changes that
+//   applyGoalEvents, updatePlayer and addPlayer made on the other
+//   side. The batch is appended to this league's own update log
+//   as it is.
 //
 // Notes:
-//   - file.clear() removes EOF flags after reading.
-//   - file.seekp(0) moves the write pointer to the beginning.
+//   - The records are not added to the goal history.
 // ------------------------------------------------------------
-void Soccer::updatePlayer(const string& name, int newGoals) {
-    fstream file(filename_, ios::in | ios::out);
+size_t Soccer::applyRecords(string_view records) {
+    lock_guard<mutex> logLock(logMutex_);
+    unique_lock<shared_mutex> lock(mutex_);
+    loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+
+    size_t applied = 0;
+    string_view rest = records;
+    while (!rest.empty()) {
+        size_t end = rest.find('\n');
+        string_view line = rest.substr(0, end);
+        rest.remove_prefix(end == string_view::npos ? rest.size() : end + 1);
 
-    if (!file) {
+        string_view name;
+        char op;
+        int value;
+        if (!SoccerLog::parseRecord(line, name, op, value)) continue;
+
+        if (op == '+') {
+            addGoals(name, value);
+        } else if (op == '=') {
+            setGoals(string(name), value);
+        } else {
+            int team = teamIndex("");
+            if (team < 0) {                        // Nowhere to put new players
+                cerr << "Error: No team file for new player " << name << ".\n";
+                continue;
+            }
+            appendRow(string(name), value, static_cast<uint16_t>(team));
+            dirtyTeams_[team] = true;
+        }
+        ++applied;
+    }
+    if (applied == 0) return 0;
+
+    if (changeFeed_) changeFeed_(records);
+    refreshSnapshot(nullptr);
+
+    // A batch always ends with a newline, or the next append would
+    // run on from its last record.
+    string logged(records);
+    if (logged.back() != '\n') logged += '\n';
+    if (!persistRecords(logged, lock)) {
         cerr << "Error: Could not open " << filename_ << " for updating.\n";
-        return;
+    }
+    return applied;
+}
+
+// ------------------------------------------------------------
+// Function: logGoalEvents
+// ------------------------------------------------------------
+// Purpose:
+//   The first half of applyGoalEvents(): append the batch to the
+//   update log (and fdatasync it).
+//
+// Notes:
+//   - Only logMutex_ is held during the write, so readers and
+//     other writers of the table are not blocked by the disk.
+//   - loggedBatches_ is raised BEFORE the write. rewriteFile()
+//     waits for it to reach zero, so a checkpoint can never empty
+//     the log while it holds events the table doesn't include yet.
+// ------------------------------------------------------------
+bool Soccer::logGoalEvents(const vector<pair<string, int>>& deltas) {
+    return logDeltas(deltas, nullptr);
+}
+
+// ------------------------------------------------------------
+// Helper Function: logDeltas
+// ------------------------------------------------------------
+// The goal history is written before the update log: if the
+// program stops in between, the history has an event the table
+// doesn't, and rebuildFromEvents() puts it back. The other order
+// would lose it from the history for good.
+// ------------------------------------------------------------
+bool Soccer::logDeltas(const vector<pair<string, int>>& deltas, const vector<GoalEvent>* history) {
+    string records;
+    records.reserve(deltas.size() * 16);
+    for (const auto& d : deltas) {
+        SoccerLog::formatDelta(records, d.first, d.second);
+    }
+
+    lock_guard<mutex> logLock(logMutex_);
+    {
+        unique_lock<shared_mutex> lock(mutex_);
+        ++loggedBatches_;
+    }
+
+    bool ok = true;
+    if (events_) {
+        if (history) {
+            ok = events_->append(*history);
+
+            // Keep the form leaderboards in step with the history.
+            lock_guard<mutex> formLock(formMutex_);
+            if (ok && form_) {
+                uint32_t today = currentDay();
+                for (const GoalEvent& event : *history) {
+                    form_->add(event.player, event.match, event.day ? event.day : today, event.delta);
+                }
+            }
+        } else {
+            vector<GoalEvent> corrections;
+            corrections.reserve(deltas.size());
+            for (const auto& d : deltas) {
+                corrections.push_back({d.first, 0, 0, d.second});
+            }
+            ok = events_->append(corrections);
+        }
+    }
+
+    if (ok && log_.append(records)) {
+        return true;
     }
 
+    // Nothing was logged, so there is nothing to apply either.
+    {
+        unique_lock<shared_mutex> lock(mutex_);
+        --loggedBatches_;
+    }
+    loggedBatchesDone_.notify_all();
+    return false;
+}
+
+// ------------------------------------------------------------
+// Function: applyLoggedGoalEvents
+// ------------------------------------------------------------
+// Purpose:
+//   The second half of applyGoalEvents(): add the deltas to the
+//   in-memory table. Must be called exactly once for every
+//   successful logGoalEvents() call.
+// ------------------------------------------------------------
+void Soccer::applyLoggedGoalEvents(const vector<pair<string, int>>& deltas) {
+    {
+        unique_lock<shared_mutex> lock(mutex_);
+        logDirty_ = true;
+
+        bool allExisted = true;
+        for (const auto& d : deltas) {
+            allExisted = addGoals(d.first, d.second) && allExisted;
+        }
+        if (changeFeed_) {
+            string records;
+            for (const auto& d : deltas) SoccerLog::formatDelta(records, d.first, d.second);
+            changeFeed_(records);
+        }
+
+        // Existing players can be patched in place in the snapshot.
+        if (allExisted) {
+            for (const auto& d : deltas) {
+                refreshSnapshot(&d.first);
+            }
+        } else {
+            refreshSnapshot(nullptr);
+        }
+
+        --loggedBatches_;
+
+        // The last batch in flight checks whether the log needs
+        // folding into the file. Nobody can be appending: logDeltas
+        // raises loggedBatches_ first, and the other writers hold
+        // this lock while they append.
+        if (loggedBatches_ == 0 && logOutgrown() && !rewriteFile(lock)) {
+            cerr << "Error: Could not open " << filename_ << " for updating.\n";
+        }
+    }
+    loggedBatchesDone_.notify_all();
+}
+
+void Soccer::setLogSync(bool sync) {
+    lock_guard<mutex> logLock(logMutex_);
+    log_.setSyncOnAppend(sync);
+    if (events_) {
+        events_->setSyncOnAppend(sync);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: recordGoals
+// ------------------------------------------------------------
+// Purpose:
+//   Stores the events, then folds them into the totals as one
+//   batch of per-player deltas (the same path as live goal events).
+// ------------------------------------------------------------
+bool Soccer::recordGoals(const vector<GoalEvent>& events) {
+    if (events.empty()) return true;
+    for (const GoalEvent& event : events) {
+        if (!checkName(event.player)) return false;
+    }
+
+    // First use: create the history with an opening balance per
+    // player, so it adds up to the table from the start.
+    {
+        lock_guard<mutex> logLock(logMutex_);
+        unique_lock<shared_mutex> lock(mutex_);
+        if (!events_) {
+            loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+
+            auto store = make_unique<GoalEventStore>(storageBase_ + ".events");
+            if (!store->open()) {
+                return false;
+            }
+            store->setSyncOnAppend(log_.syncOnAppend());
+
+            vector<GoalEvent> opening;
+            for (const auto& entry : index_) {
+                opening.push_back({entry.first, 0, 0, goals_[entry.second.front()]});
+            }
+            if (store->eventCount() == 0 && !store->append(opening)) {
+                return false;
+            }
+            events_ = move(store);
+        }
+    }
+
+    // Add the deltas up per player, keeping first-seen order.
+    vector<pair<string, int>> deltas;
+    unordered_map<string_view, size_t> position;
+    for (const GoalEvent& event : events) {
+        auto it = position.find(event.player);
+        if (it == position.end()) {
+            position.emplace(event.player, deltas.size());
+            deltas.push_back({event.player, event.delta});
+        } else {
+            deltas[it->second].second += event.delta;
+        }
+    }
+
+    if (!logDeltas(deltas, &events)) {
+        return false;
+    }
+    applyLoggedGoalEvents(deltas);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: rebuildFromEvents
+// ------------------------------------------------------------
+// Purpose:
+//   Throws the materialized totals away and recomputes them from
+//   the goal history. Players that never appear in the history
+//   keep their current total.
+//
+// Notes:
+//   - Holding logMutex_ stops new goal events from being logged,
+//     and waiting for loggedBatches_ makes sure every event
+//     already in the history has reached the table too.
+// ------------------------------------------------------------
+bool Soccer::rebuildFromEvents(unsigned threads) {
+    lock_guard<mutex> logLock(logMutex_);
+    unique_lock<shared_mutex> lock(mutex_);
+    if (!events_) {
+        cerr << "Error: No goal history (" << storageBase_ << ".events) to rebuild from.\n";
+        return false;
+    }
+    loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+
+    string records;
+    for (const auto& total : events_->rebuildTotals(threads)) {
+        // A name whose events cancel out and that has no row was
+        // never really added (see addPlayer): it stays out.
+        if (total.second == 0 && index_.find(total.first) == index_.end()) continue;
+        setGoals(total.first, total.second);
+        if (changeFeed_) SoccerLog::formatSet(records, total.first, total.second);
+    }
+    if (changeFeed_) changeFeed_(records);
+    refreshSnapshot(nullptr);
+
+    if (!rewriteFile(lock)) {
+        cerr << "Error: Could not open " << filename_ << " for updating.\n";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: formLeaderboard
+// ------------------------------------------------------------
+// Notes:
+//   - The leaderboards are built while holding logMutex_, so no
+//     goal can be appended to the history between reading it and
+//     logDeltas() starting to update form_ directly.
+// ------------------------------------------------------------
+vector<pair<string, int>> Soccer::formLeaderboard(FormWindow window, size_t n) {
+    {
+        lock_guard<mutex> formLock(formMutex_);
+        if (form_) {
+            return form_->top(window, n, currentDay());
+        }
+    }
+
+    lock_guard<mutex> logLock(logMutex_);
+    lock_guard<mutex> formLock(formMutex_);
+    if (!form_) {
+        if (!events_) return {};
+
+        auto form = make_unique<FormTracker>();
+        events_->replay([&form](const string& player, uint32_t match, uint32_t day, int delta) {
+            form->add(player, match, day, delta);
+        });
+        form_ = move(form);
+    }
+    return form_->top(window, n, currentDay());
+}
+
+// ------------------------------------------------------------
+// Function: goalHistory
+// ------------------------------------------------------------
+vector<GoalEvent> Soccer::goalHistory(const string& name) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    if (!events_) return {};
+    return events_->history(name);
+}
+
+// ------------------------------------------------------------
+// Function: findPlayer
+// ------------------------------------------------------------
+// Purpose:
+//   Looks up one player by name using the index (no scanning).
+//   If the name appears on several rows, the first one wins.
+// ------------------------------------------------------------
+bool Soccer::findPlayer(const string& name, int& goals) const {
+    shared_lock<shared_mutex> lock(mutex_);
+
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+        return false;
+    }
+    goals = goals_[it->second.front()];
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: getPlayers
+// ------------------------------------------------------------
+// Purpose:
+//   Copies every record (in file order) into a vector of pairs.
+// ------------------------------------------------------------
+vector<pair<string, int>> Soccer::getPlayers() const {
+    shared_lock<shared_mutex> lock(mutex_);
 
-    // 'vector' = dynamic list
-    // 'pair<string, int>' = one player's data (name + goals)
-    // Together: a list of player records read from the file
     vector<pair<string, int>> players;
-    string line;
+    players.reserve(names_.size());
+    for (size_t i = 0; i < names_.size(); ++i) {
+        players.push_back({names_[i], goals_[i]});
+    }
+    return players;
+}
 
-    // Step 1: Read all players into memory
-    while (getline(file, line)) {
-        if (line.empty()) continue;
-        stringstream ss(line);
-        string player;
-        int goals;
-        getline(ss, player, ',');
-        ss >> goals;
-        players.push_back({player, goals});
+// ------------------------------------------------------------
+// Function: topPlayers
+// ------------------------------------------------------------
+// Purpose:
+//   Returns the 'n' highest scorers.
+//
+// Notes:
+//   - One pass over records() that keeps only the best 'n' seen so
+//     far, so neither the rows nor their names are copied – only
+//     the 'n' winners are turned into strings at the end.
+// ------------------------------------------------------------
+vector<pair<string, int>> Soccer::topPlayers(size_t n) const {
+    return SoccerViews::topScorers(records(), n);
+}
+
+// ------------------------------------------------------------
+// Function: goalSummary / goalHistogram / goalPercentiles
+// ------------------------------------------------------------
+// goals_ is one contiguous array, so it can be handed to the
+// aggregate kernels as-is; the shared lock keeps it from changing
+// underneath them.
+// ------------------------------------------------------------
+GoalSummary Soccer::goalSummary() const {
+    shared_lock<shared_mutex> lock(mutex_);
+    return GoalAggregates::summarize(goals_.data(), goals_.size());
+}
+
+GoalHistogram Soccer::goalHistogram() const {
+    shared_lock<shared_mutex> lock(mutex_);
+    GoalHistogram result;
+    GoalAggregates::histogram(goals_.data(), goals_.size(), result);
+    return result;
+}
+
+vector<int> Soccer::goalPercentiles(const vector<double>& ps) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    return GoalAggregates::percentiles(goals_.data(), goals_.size(), ps);
+}
+
+// ------------------------------------------------------------
+// Function: countPlayers
+// ------------------------------------------------------------
+size_t Soccer::countPlayers(int minGoals, int maxGoals) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    return goalIndex_.count(minGoals, maxGoals, goals_);
+}
+
+size_t Soccer::countPlayers(int minGoals, int maxGoals, const string& team) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    auto it = find(teamNames_.begin(), teamNames_.end(), team);
+    size_t t = static_cast<size_t>(it - teamNames_.begin());
+    if (t >= teamRows_.size()) {
+        return 0;               // No such team, or one without rows yet
+    }
+    return goalIndex_.count(minGoals, maxGoals, goals_, &teamRows_[t]);
+}
+
+// ------------------------------------------------------------
+// Function: playersInRange
+// ------------------------------------------------------------
+// Notes:
+//   - The cracked column returns rows in whatever order the
+//     cracking left them; they are sorted back into file order
+//     so the answer doesn't depend on earlier queries.
+// ------------------------------------------------------------
+vector<pair<string, int>> Soccer::playersInRange(int minGoals, int maxGoals) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    vector<uint32_t> rows;
+    {
+        lock_guard<mutex> crackLock(crackMutex_);
+        if (!cracked_) {
+            cracked_ = make_unique<CrackedColumn>();
+            cracked_->reset(goals_);
+        }
+        rows = cracked_->rows(minGoals, maxGoals);
+    }
+    sort(rows.begin(), rows.end());
+
+    vector<pair<string, int>> players;
+    players.reserve(rows.size());
+    for (uint32_t row : rows) {
+        players.push_back({names_[row], goals_[row]});
+    }
+    return players;
+}
+
+// ------------------------------------------------------------
+// Function: queryPlayers
+// ------------------------------------------------------------
+vector<pair<string, int>> Soccer::queryPlayers(const PlayerFilter& filter) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    vector<pair<string, int>> players;
+    for (uint32_t row : filter.select(names_.data(), goals_.data(), names_.size())) {
+        players.push_back({names_[row], goals_[row]});
     }
+    return players;
+}
+
+// ------------------------------------------------------------
+// Function: teams / teamPlayers
+// ------------------------------------------------------------
+vector<pair<string, int>> Soccer::teams() const {
+    shared_lock<shared_mutex> lock(mutex_);
+    vector<int> counts(teamNames_.size(), 0);
+    for (uint16_t team : teams_) ++counts[team];
 
-    // Step 2: Modify or add the player
-    bool found = false;                         // Flag to track whether the player was found in the list
+    vector<pair<string, int>> result;
+    for (size_t t = 0; t < teamNames_.size(); ++t) {
+        result.push_back({teamNames_[t], counts[t]});
+    }
+    return result;
+}
 
-    // Range-based for loop to go through each player in the vector.
-    // 'auto' automatically figures out the correct type (pair<string, int>)
-    // '&' means we’re working with a reference to the actual element
-    // so we can modify it (not just a copy).
-    for (auto& p : players) {
-        // Each 'p' represents one record in the vector
-        // p.first  = player's name
-        // p.second = player's goal count
+vector<pair<string, int>> Soccer::teamPlayers(const string& team) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    auto found = find(teamNames_.begin(), teamNames_.end(), team);
+    if (found == teamNames_.end()) return {};
+    uint16_t t = static_cast<uint16_t>(found - teamNames_.begin());
+
+    vector<pair<string, int>> players;
+    for (size_t i = 0; i < names_.size(); ++i) {
+        if (teams_[i] == t) players.push_back({names_[i], goals_[i]});
+    }
+    return players;
+}
+
+// ------------------------------------------------------------
+// Async API
+// ------------------------------------------------------------
+// Each write is the blocking call, moved to the I/O thread. The
+// lambdas capture the coroutine's own copies of the arguments by
+// reference; they stay alive because the coroutine is suspended
+// until the job is done.
+// ------------------------------------------------------------
+Task<bool> Soccer::addPlayerAsync(string name, int goals) {
+    IoLoop& io = io_ ? *io_ : defaultIoLoop();
+    Executor& executor = executor_ ? *executor_ : defaultExecutor();
+    co_return co_await io.run(executor, [&] { return addPlayer(name, goals); });
+}
+
+Task<bool> Soccer::updatePlayerAsync(string name, int newGoals) {
+    IoLoop& io = io_ ? *io_ : defaultIoLoop();
+    Executor& executor = executor_ ? *executor_ : defaultExecutor();
+    co_return co_await io.run(executor, [&] { return updatePlayer(name, newGoals); });
+}
+
+Task<bool> Soccer::updatePlayersAsync(vector<pair<string, int>> updates) {
+    IoLoop& io = io_ ? *io_ : defaultIoLoop();
+    Executor& executor = executor_ ? *executor_ : defaultExecutor();
+    co_return co_await io.run(executor, [&] { return updatePlayers(updates); });
+}
+
+Task<bool> Soccer::recordGoalsAsync(vector<GoalEvent> events) {
+    IoLoop& io = io_ ? *io_ : defaultIoLoop();
+    Executor& executor = executor_ ? *executor_ : defaultExecutor();
+    co_return co_await io.run(executor, [&] { return recordGoals(events); });
+}
 
-        if (p.first == name) {      // Check if this player's name matches
-            p.second = newGoals;    // Update their goals
-            found = true;           // Mark that we found them
+Task<optional<int>> Soccer::findPlayerAsync(string name) const {
+    int goals;
+    if (!findPlayer(name, goals)) co_return nullopt;
+    co_return goals;
+}
+
+Task<vector<pair<string, int>>> Soccer::topPlayersAsync(size_t n) const {
+    co_return topPlayers(n);
+}
+
+// ------------------------------------------------------------
+// Function: setAsyncContext
+// ------------------------------------------------------------
+void Soccer::setAsyncContext(Executor& executor, IoLoop& io) {
+    unique_lock<shared_mutex> lock(mutex_);
+    executor_ = &executor;
+    io_ = &io;
+}
+
+// ------------------------------------------------------------
+// Function: setVerbose
+// ------------------------------------------------------------
+void Soccer::setVerbose(bool verbose) {
+    unique_lock<shared_mutex> lock(mutex_);
+    verbose_ = verbose;
+}
+
+// ------------------------------------------------------------
+// Function: publishSnapshot
+// ------------------------------------------------------------
+bool Soccer::publishSnapshot(const string& shmName) {
+    unique_lock<shared_mutex> lock(mutex_);
+
+    auto writer = make_unique<SoccerSnapshotWriter>();
+    if (!writer->open(shmName)) {
+        return false;
+    }
+    snapshot_ = move(writer);
+    refreshSnapshot(nullptr);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: setChangeFeed
+// ------------------------------------------------------------
+void Soccer::setChangeFeed(function<void(string_view)> feed) {
+    unique_lock<shared_mutex> lock(mutex_);
+    changeFeed_ = move(feed);
+}
+
+// ------------------------------------------------------------
+// Function: checkpoint
+// ------------------------------------------------------------
+bool Soccer::checkpoint() {
+    unique_lock<shared_mutex> lock(mutex_);
+    if (!logDirty_ && loggedBatches_ == 0) return true;
+
+    if (!rewriteFile(lock)) {
+        cerr << "Error: Could not open " << filename_ << " for updating.\n";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: repair
+// Stream used: ofstream (output file stream)
+// ------------------------------------------------------------
+bool Soccer::repair(size_t& moved) {
+    lock_guard<mutex> logLock(logMutex_);
+    unique_lock<shared_mutex> lock(mutex_);
+    moved = 0;
+
+    // The lines are saved before the files lose them; if the
+    // rewrite fails they are in both places, never in neither.
+    for (size_t t = 0; t < teamFiles_.size(); ++t) {
+        if (!unreadable_[t].empty()) {
+            ofstream out(teamFiles_[t] + ".damaged", ios::app);
+            for (const string& line : unreadable_[t]) {
+                out << line << '\n';
+            }
+            if (!out.flush()) {
+                cerr << "Error: Could not open " << teamFiles_[t] << ".damaged for writing.\n";
+                return false;
+            }
         }
+        dirtyTeams_[t] = true;
+    }
+
+    vector<vector<string>> kept(teamFiles_.size());
+    kept.swap(unreadable_);
+    if (!rewriteFile(lock)) {
+        kept.swap(unreadable_);
+        cerr << "Error: Could not open " << filename_ << " for updating.\n";
+        return false;
+    }
+    for (const auto& lines : kept) moved += lines.size();
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: memoryUsage
+// ------------------------------------------------------------
+// Notes:
+//   - Names short enough for the string's own buffer ("small
+//     string optimization") cost nothing extra; longer ones own a
+//     heap block.
+//   - Each index_ entry is counted as a hash node (key, row list
+//     and pointers) plus one row number; the bracket bitmaps and
+//     the cracked column as a few bytes per row.
+// ------------------------------------------------------------
+size_t Soccer::memoryUsage() const {
+    shared_lock<shared_mutex> lock(mutex_);
+
+    size_t bytes = names_.capacity() * sizeof(string) + goals_.capacity() * sizeof(int) +
+                   teams_.capacity() * sizeof(uint16_t);
+    for (const string& name : names_) {
+        if (name.capacity() >= sizeof(string)) bytes += name.capacity() + 1;
+    }
+
+    bytes += index_.bucket_count() * sizeof(void*);
+    bytes += index_.size() * (sizeof(string) + sizeof(vector<size_t>) + 2 * sizeof(void*));
+    bytes += names_.size() * sizeof(size_t);
+
+    bytes += names_.size() * sizeof(uint16_t);   // Bracket bitmaps (array containers)
+    {
+        lock_guard<mutex> crackLock(crackMutex_);
+        if (cracked_) bytes += names_.size() * (sizeof(int) + 2 * sizeof(uint32_t));
     }
+    return bytes;
+}
+
+// ------------------------------------------------------------
+// Helper Function: findTeamFiles
+// ------------------------------------------------------------
+void Soccer::findTeamFiles() {
+    vector<string> files;
+    error_code error;
 
-    if (!found) {
-        cout << name << " not found — adding as a new player.\n";
-        players.push_back({name, newGoals});
+    if (hasWildcards(filename_)) {
+        teamDirectory_ = patternDirectory(filename_);
+        glob_t matches{};
+        if (glob(filename_.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; ++i) {
+                files.push_back(matches.gl_pathv[i]);   // glob() sorts them
+            }
+        }
+        globfree(&matches);
+    } else if (filesystem::is_directory(filename_, error)) {
+        teamDirectory_ = filename_;
+        for (const auto& entry : filesystem::directory_iterator(filename_, error)) {
+            if (entry.path().extension() == ".csv") files.push_back(entry.path().string());
+        }
+        sort(files.begin(), files.end());
     } else {
-        cout << "Updated " << name << "'s goals to " << newGoals << ".\n";
+        files.push_back(filename_);   // A single file: one team
+    }
+
+    for (const string& file : files) {
+        // Only *.csv files are teams, so a pattern like "teams/*"
+        // skips the league's own files (league.log, *.crc, ...).
+        if (!teamDirectory_.empty() &&
+            (filesystem::path(file).extension() != ".csv" || !filesystem::is_regular_file(file, error))) {
+            continue;
+        }
+        if (teamFiles_.size() > UINT16_MAX) {
+            cerr << "Warning: Too many team files in " << filename_ << "; skipping " << file << ".\n";
+            continue;
+        }
+        teamFiles_.push_back(file);
+        teamNames_.push_back(filesystem::path(file).stem().string());
+    }
+    dirtyTeams_.assign(teamFiles_.size(), false);
+    unreadable_.assign(teamFiles_.size(), {});
+
+    string firstFile = (filesystem::path(teamDirectory_) / "players.csv").string();
+    if (teamFiles_.empty() && hasWildcards(filename_) &&
+        fnmatch(filename_.c_str(), firstFile.c_str(), FNM_PATHNAME) != 0) {
+        cerr << "Warning: No file matches " << filename_ << ", and new players can't be saved: "
+             << firstFile << " wouldn't match it either.\n";
+    }
+}
+
+// ------------------------------------------------------------
+// Helper Function: teamIndex
+// ------------------------------------------------------------
+// A new team is only created in a team directory or pattern, and
+// (for a pattern) only if its file would be found again on the
+// next start. The first team is created as "players" if there
+// isn't one yet – with the same check, so -1 for "" means new
+// players have nowhere to go.
+// ------------------------------------------------------------
+int Soccer::teamIndex(const string& team) {
+    if (team.empty() && !teamFiles_.empty()) return 0;
+    for (size_t t = 0; t < teamNames_.size(); ++t) {
+        if (teamNames_[t] == team) return static_cast<int>(t);
+    }
+
+    string name = team.empty() ? "players" : team;
+    if (teamDirectory_.empty() || name.find('/') != string::npos || teamFiles_.size() > UINT16_MAX) {
+        return -1;
+    }
+    string file = (filesystem::path(teamDirectory_) / (name + ".csv")).string();
+    if (hasWildcards(filename_) &&
+        fnmatch(filename_.c_str(), file.c_str(), FNM_PATHNAME) != 0) {
+        return -1;
+    }
+
+    teamFiles_.push_back(file);
+    teamNames_.push_back(name);
+    dirtyTeams_.push_back(false);
+    unreadable_.emplace_back();
+    return static_cast<int>(teamFiles_.size() - 1);
+}
+
+// ------------------------------------------------------------
+// Helper Function: loadPlayers
+// ------------------------------------------------------------
+// Purpose:
+//   Reads every team file into the in-memory table.
+//
+// Notes:
+//   - Reading and parsing the files is the slow part, so each
+//     file is read by its own task on the shared worker pool (see
+//     TaskScheduler.h) into a private list of rows.
+//   - The lists are then added to the table one file after the
+//     other, so rows keep the same order as a serial load.
+// ------------------------------------------------------------
+void Soccer::loadPlayers() {
+    vector<vector<pair<string, int>>> rosters(teamFiles_.size());
+    vector<char> opened(teamFiles_.size(), 0);
+
+    TaskScheduler::shared().parallelFor(0, teamFiles_.size(), 1, [&](size_t first, size_t last) {
+        for (size_t t = first; t < last; ++t) {
+            opened[t] = readRoster(teamFiles_[t], rosters[t], unreadable_[t]);
+        }
+    });
+
+    size_t total = 0;
+    for (const auto& roster : rosters) total += roster.size();
+    names_.reserve(total);
+    goals_.reserve(total);
+    teams_.reserve(total);
+    index_.reserve(total);
+
+    for (size_t t = 0; t < rosters.size(); ++t) {
+        if (!opened[t]) {
+            cerr << "Error: Could not open " << teamFiles_[t] << " for reading.\n";
+            continue;
+        }
+        for (const auto& row : rosters[t]) {
+            appendRow(row.first, row.second, static_cast<uint16_t>(t));
+        }
+        vector<pair<string, int>>().swap(rosters[t]);   // Free each list once it's copied
+    }
+}
+
+// ------------------------------------------------------------
+// Helper Function: replayLog
+// ------------------------------------------------------------
+void Soccer::replayLog() {
+    bool replayedAny = false;
+    log_.replay([this, &replayedAny](string_view name, char op, int value) {
+        if (op == '+') {
+            addGoals(name, value);
+        } else if (op == '=') {
+            setGoals(string(name), value);
+        } else {                                   // '#': a row added by addPlayer()
+            int team = teamIndex("");
+            if (team < 0) {                        // Nowhere to put new players
+                cerr << "Error: No team file for new player " << name << ".\n";
+                return;
+            }
+            appendRow(string(name), value, static_cast<uint16_t>(team));
+            dirtyTeams_[team] = true;
+        }
+        replayedAny = true;
+    });
+    logDirty_ = replayedAny;
+}
+
+// ------------------------------------------------------------
+// Helper Function: recoverCheckpoint
+// ------------------------------------------------------------
+// rewriteFile() goes through these steps:
+//
+//   1. write soccer.csv.tmp          (may be incomplete after a crash)
+//   2. rename .tmp → soccer.csv.new  (now it is known to be complete)
+//      and write its checksums to soccer.csv.crc.new
+//   3. empty soccer.csv.log
+//   4. remove soccer.csv.crc, rename .new → soccer.csv and
+//      .crc.new → soccer.csv.crc
+//
+// With several team files, every rewritten file finishes step 2
+// before the (shared) log is emptied, and each file is recovered
+// the same way.
+//
+// A leftover .tmp is always thrown away. A leftover .new (and
+// .crc.new) is used only if the log is already empty (step 3
+// happened); otherwise soccer.csv + the log are still the correct
+// data. The old checksums never stay next to a new file: without
+// a .crc.new, the file is simply unchecked until its next rewrite.
+// ------------------------------------------------------------
+void Soccer::recoverCheckpoint() {
+    bool logEmpty = log_.empty();
+
+    for (const string& file : teamFiles_) {
+        string finished = file + ".new";
+        string checksums = FileChecksum::sidecarPath(file);
+        string finishedChecksums = checksums + ".new";
+        remove((file + ".tmp").c_str());
+
+        if (!logEmpty) {
+            remove(finished.c_str());
+            remove(finishedChecksums.c_str());
+            continue;
+        }
+        if (access(finished.c_str(), F_OK) == 0) {
+            remove(checksums.c_str());
+            rename(finished.c_str(), file.c_str());
+        }
+        if (access(finishedChecksums.c_str(), F_OK) == 0) {
+            rename(finishedChecksums.c_str(), checksums.c_str());
+        }
     }
+}
 
-    // Step 3: Clear EOF/fail flags so we can write again
-    file.clear();
+// ------------------------------------------------------------
+// Helper Function: appendRow
+// ------------------------------------------------------------
+void Soccer::appendRow(const string& name, int goals, uint16_t team) {
+    index_[name].push_back(names_.size());
+    goalIndex_.insert(static_cast<uint32_t>(names_.size()), goals);
+    if (cracked_) cracked_->append(static_cast<uint32_t>(names_.size()), goals);
+    if (team >= teamRows_.size()) teamRows_.resize(team + 1);
+    teamRows_[team].add(static_cast<uint32_t>(names_.size()));
+    names_.push_back(name);
+    goals_.push_back(goals);
+    teams_.push_back(team);
+    fileBytes_ += name.size() + 4;   // "Name,NN\n", give or take a digit
+}
 
-    // Step 4: Move the write pointer back to the start
-    file.seekp(0, ios::beg);
+// ------------------------------------------------------------
+// Helper Function: setGoals
+// ------------------------------------------------------------
+// Sets every row named 'name' to 'goals', or appends a new row
+// to the first team. Returns true if the player was already in
+// the table. Every team it touches is marked dirty.
+// ------------------------------------------------------------
+bool Soccer::setGoals(const string& name, int goals) {
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+        int team = teamIndex("");
+        if (team < 0) {               // Nowhere to put new players
+            cerr << "Error: No team file for new player " << name << ".\n";
+            return false;
+        }
+        appendRow(name, goals, static_cast<uint16_t>(team));
+        dirtyTeams_[team] = true;
+        return false;
+    }
 
-    // Step 5: Rewrite the updated data
-    for (auto& p : players) {
-        file << p.first << "," << p.second << "\n";
+    for (size_t row : it->second) {
+        goalIndex_.update(static_cast<uint32_t>(row), goals_[row], goals);
+        if (cracked_) cracked_->update(static_cast<uint32_t>(row), goals_[row], goals);
+        goals_[row] = goals;
+        dirtyTeams_[teams_[row]] = true;
     }
+    return true;
+}
 
-    // File closes automatically here (RAII)
+// ------------------------------------------------------------
+// Helper Function: addGoals
+// ------------------------------------------------------------
+bool Soccer::addGoals(string_view name, int delta) {
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+        int team = teamIndex("");
+        if (team < 0) {               // Nowhere to put new players
+            cerr << "Error: No team file for new player " << name << ".\n";
+            return false;
+        }
+        appendRow(string(name), delta, static_cast<uint16_t>(team));
+        dirtyTeams_[team] = true;
+        return false;
+    }
+
+    for (size_t row : it->second) {
+        goalIndex_.update(static_cast<uint32_t>(row), goals_[row], goals_[row] + delta);
+        if (cracked_) cracked_->update(static_cast<uint32_t>(row), goals_[row], goals_[row] + delta);
+        goals_[row] += delta;
+        dirtyTeams_[teams_[row]] = true;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Helper Function: feedAdd
+// ------------------------------------------------------------
+void Soccer::feedAdd(const string& name, int goals) {
+    if (!changeFeed_) return;
+    string records;
+    SoccerLog::formatAdd(records, name, goals);
+    changeFeed_(records);
+}
+
+// ------------------------------------------------------------
+// Helper Function: recordCorrection
+// ------------------------------------------------------------
+bool Soccer::recordCorrection(const string& name, int oldGoals, int newGoals) {
+    if (!events_ || oldGoals == newGoals) return true;
+    if (!events_->append({{name, 0, 0, newGoals - oldGoals}})) {
+        cerr << "Error: Could not record the change for " << name << " in the goal history.\n";
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Helper Function: refreshSnapshot
+// ------------------------------------------------------------
+void Soccer::refreshSnapshot(const string* changedName) {
+    if (!snapshot_) return;
+
+    if (changedName) {
+        auto it = index_.find(*changedName);
+        if (it != index_.end() &&
+            snapshot_->updateGoals(*changedName, goals_[it->second.front()])) {
+            return;
+        }
+    }
+
+    vector<pair<string, int>> players;
+    players.reserve(names_.size());
+    for (size_t i = 0; i < names_.size(); ++i) {
+        players.push_back({names_[i], goals_[i]});
+    }
+    snapshot_->publish(players);
+}
+
+// ------------------------------------------------------------
+// Helper Function: persistRecords
+// ------------------------------------------------------------
+// Purpose:
+//   Makes a change that is already in the table durable by
+//   appending its records to the update log – a few bytes per
+//   change, however big the file is.
+//
+// Notes:
+//   - The caller holds logMutex_ and 'lock', and no logged batch
+//     is waiting to be applied (so the records land after them).
+//   - Once the log has outgrown the file (logOutgrown), or if the
+//     append fails, the dirty files are rewritten instead, which
+//     also empties the log. Each rewrite therefore follows at
+//     least half a file's worth of log records, so the bytes
+//     written stay proportional to the number of changes.
+// ------------------------------------------------------------
+bool Soccer::persistRecords(string_view records, unique_lock<shared_mutex>& lock) {
+    if (log_.append(records)) {
+        logDirty_ = true;
+        if (!logOutgrown()) return true;
+    }
+    return rewriteFile(lock);
+}
+
+// ------------------------------------------------------------
+// Helper Function: logAhead / compactLog
+// ------------------------------------------------------------
+// Unlike persistRecords(), a failed append is not covered by a
+// rewrite: the table doesn't have the change yet, so the caller
+// just reports the failure. Once the records are in the log, a
+// failed rewrite loses nothing (replay applies them), so
+// compactLog() only warns.
+// ------------------------------------------------------------
+bool Soccer::logAhead(string_view records) {
+    if (!log_.append(records)) return false;
+    logDirty_ = true;
+    return true;
+}
+
+void Soccer::compactLog(unique_lock<shared_mutex>& lock) {
+    if (logOutgrown() && !rewriteFile(lock)) {
+        cerr << "Warning: Could not rewrite " << filename_ << "; its changes stay in the update log.\n";
+    }
+}
+
+// True once replaying the log would cost more than reading the
+// data files again: it is over half their size (and over 64 KB,
+// so a small league isn't rewritten every few updates).
+bool Soccer::logOutgrown() const {
+    constexpr size_t kMinCompactBytes = 64 * 1024;
+    return logDirty_ && log_.size() > max(kMinCompactBytes, fileBytes_ / 2);
+}
+
+// ------------------------------------------------------------
+// Helper Function: rewriteFile
+// Stream used: ofstream (output file stream)
+// ------------------------------------------------------------
+// Purpose:
+//   Replaces the contents of every dirty team file with that
+//   team's rows from the in-memory table and empties the update
+//   log, which the table now includes.
+//
+// Notes:
+//   - Teams whose rows didn't change keep their file as it is, so
+//     an update in a league of many team files rewrites only one.
+//   - The data is written to a temporary file first and renamed
+//     over the real file at the end (see recoverCheckpoint() for
+//     why each step is safe if the program stops half way).
+//   - fsync() makes sure the new files are really on disk before
+//     the log, which still describes the old data, is emptied.
+//   - Each file is written in checksummed blocks, and the
+//     checksums replace the old ones (see FileChecksum.h).
+//   - Lines that couldn't be read when the file was loaded are
+//     written back unchanged, after the rows.
+//   - First waits (briefly releasing 'lock') until every logged
+//     batch of goal events has also been applied to the table.
+// ------------------------------------------------------------
+bool Soccer::rewriteFile(unique_lock<shared_mutex>& lock) {
+    loggedBatchesDone_.wait(lock, [this] { return loggedBatches_ == 0; });
+
+    // The dirty teams, and each one's rows in file order (found
+    // in a single pass over the table).
+    vector<size_t> dirty;
+    vector<int> slot(teamFiles_.size(), -1);
+    for (size_t t = 0; t < teamFiles_.size(); ++t) {
+        if (dirtyTeams_[t]) {
+            slot[t] = static_cast<int>(dirty.size());
+            dirty.push_back(t);
+        }
+    }
+    if (dirty.empty() && !logDirty_) {
+        return true;   // Every file already matches the table
+    }
+
+    vector<vector<uint32_t>> rows(dirty.size());
+    for (size_t i = 0; i < teams_.size(); ++i) {
+        if (slot[teams_[i]] >= 0) rows[slot[teams_[i]]].push_back(static_cast<uint32_t>(i));
+    }
+
+    for (size_t d = 0; d < dirty.size(); ++d) {
+        const string& file = teamFiles_[dirty[d]];
+        string temporary = file + ".tmp";
+        vector<FileChecksum::Block> blocks;
+        {
+            ofstream out(temporary, ios::trunc);
+            if (!out) {
+                return false;
+            }
+            FileChecksum::BlockWriter writer(out);
+            string line;
+            for (uint32_t row : rows[d]) {
+                line = names_[row];
+                line += ',';
+                line += to_string(goals_[row]);
+                writer.addLine(line);
+            }
+            for (const string& kept : unreadable_[dirty[d]]) {
+                writer.addLine(kept);   // Only repair() drops these
+            }
+            if (!writer.finish() || !out.flush()) {
+                return false;
+            }
+            blocks = writer.blocks();
+        }   // 'out' closes here
+
+        int fd = open(temporary.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+        if (rename(temporary.c_str(), (file + ".new").c_str()) != 0) {
+            return false;
+        }
+        if (!FileChecksum::saveBlocks(FileChecksum::sidecarPath(file) + ".new", blocks)) {
+            return false;
+        }
+    }
+
+    if (!log_.truncate()) {
+        return false;
+    }
+    for (size_t t : dirty) {
+        const string& file = teamFiles_[t];
+        string checksums = FileChecksum::sidecarPath(file);
+        remove(checksums.c_str());
+        if (rename((file + ".new").c_str(), file.c_str()) != 0 ||
+            rename((checksums + ".new").c_str(), checksums.c_str()) != 0) {
+            return false;
+        }
+        dirtyTeams_[t] = false;
+    }
+
+    logDirty_ = false;
+    return true;
 }
 
 // ------------------------------------------------------------
@@ -208,6 +1625,9 @@ void Soccer::updatePlayer(const string& name, int newGoals) {
 //   Demonstrates creating a file using ofstream if it’s missing.
 // ------------------------------------------------------------
 void Soccer::ensureFileExists() {
+    // A team directory or pattern creates its files as teams are added.
+    if (!teamDirectory_.empty()) return;
+
     // Check if the data file exists by trying to open it for reading.
 
     ifstream check(filename_);   // Try opening the file for reading
@@ -226,7 +1646,9 @@ void Soccer::ensureFileExists() {
             create << "Messi,12\n";
             create << "Rapinoe,9\n";
             create << "Ronaldo,10\n";
-            cout << "(Created new file: " << filename_ << ")\n";
+            // clog (standard error) keeps this note out of data
+            // that scripts read from standard output.
+            clog << "(Created new file: " << filename_ << ")\n";
         }
     }
 }
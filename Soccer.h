@@ -17,12 +17,84 @@
 //
 //   1. ifstream  → Reading from an existing file
 //   2. ofstream  → Writing new data (append mode)
-//   3. fstream   → Reading and updating data in the same file
+//   3. ofstream  → Rewriting the whole file after an update
 //
+// The file is read once when the object is created and then kept
+// in memory, so a long-running program (like the socket server in
+// SoccerServer.h) can answer many questions without re-reading it.
+//
+// Changes are not written to soccer.csv straight away. They are
+// appended to an update log next to it (soccer.csv.log, see
+// SoccerLog.h) and folded into soccer.csv the next time the whole
+// file is rewritten.
+//
+// Every rewrite also stores block checksums (soccer.csv.crc, see
+// FileChecksum.h). Blocks that don't match and lines that aren't
+// "Name,Goals" are reported when the file is read. Unreadable
+// lines are left in the file until repair() moves them to
+// soccer.csv.damaged.
+//
+// Optionally, every change is also recorded as an event
+// (player, match, minute, delta) in a binary goal history
+// (soccer.csv.events, see GoalEventStore.h). The totals in the
+// table are then a "materialized view" of that history: kept up
+// to date one event at a time, and recomputable from scratch
+// with rebuildFromEvents().
+//
+// A league can also be split over one file per team: give the
+// constructor a directory ("teams/") or a glob pattern
+// ("teams/*.csv") instead of a file. Every file is read in
+// parallel into the same table, each row remembers its team, and
+// changes are written back to the team's own file.
 // ------------------------------------------------------------
 
 #pragma once   // Prevents multiple inclusions of this header file
-#include <string>   // Needed for std::string
+#include <string>         // Needed for std::string
+#include <string_view>    // Look names up without copying them
+#include <functional>     // for std::equal_to<>
+#include <vector>         // In-memory player table
+#include <unordered_map>  // Name → row lookup
+#include <shared_mutex>   // Many readers OR one writer at a time
+#include <mutex>
+#include <condition_variable>
+#include <utility>        // for std::pair
+#include <memory>         // for std::unique_ptr
+#include "SoccerLog.h"    // Append-only update log (soccer.csv.log)
+#include "GoalEventStore.h" // Binary goal history (soccer.csv.events)
+#include "GoalAggregates.h" // Sum / mean / percentiles over the goals column
+#include "GoalBracketIndex.h" // Fast "players with A..B goals" counts
+#include "PlayerFilter.h"     // Compiled "goals >= 10 and ..." filters
+#include "Generator.h"        // Coroutine generator for players()
+#include "SoccerViews.h"      // The table as a std::ranges view
+#include "Executor.h"         // Task<T>, executors and the I/O thread
+#include <optional>
+#include <climits>        // for INT_MAX
+#include <cstdint>        // for uint16_t (team numbers)
+
+class SoccerSnapshotWriter;   // Defined in SoccerSnapshot.h
+class FormTracker;            // Defined in FormTracker.h
+class CrackedColumn;          // Defined in CrackedColumn.h
+
+// The two "form" leaderboards (see FormTracker.h).
+enum class FormWindow {
+    MATCHES,   // Goals in the league's last 5 matches
+    DAYS       // Goals in the last 30 days
+};
+
+// ------------------------------------------------------------
+// Struct: NameHash
+// ------------------------------------------------------------
+// Hashes names given as std::string OR std::string_view the same
+// way. Together with std::equal_to<> it lets an unordered_map keyed
+// by std::string be searched with a string_view, without first
+// building a temporary std::string ("heterogeneous lookup").
+// ------------------------------------------------------------
+struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+        return std::hash<std::string_view>{}(name);
+    }
+};
 
 // The Soccer class manages file operations for player statistics
 class Soccer {
@@ -38,18 +110,28 @@ public:
     //
     //
     //
+    // If 'filename' is a directory, every *.csv file in it is one
+    // team (named after the file); a pattern with * ? or [ ] picks
+    // the team files the same way the shell would, keeping only the
+    // *.csv ones. New teams (and "players" for new players) are
+    // only created if their file matches the pattern. The update log
+    // and goal history are then kept as "league.log" and
+    // "league.events" in that directory.
+    //
     // Example:
     //    Soccer league;                 // uses soccer.csv
     //    Soccer league("players.csv");  // uses a custom file
+    //    Soccer league("teams/");       // teams/arsenal.csv, teams/chelsea.csv, ...
     // ------------------------------------------------------------
     explicit Soccer(const std::string& filename = "soccer.csv");
+    ~Soccer();
 
     // ------------------------------------------------------------
     // Function: displayPlayers
     // ------------------------------------------------------------
     // Purpose:
-    //   - Demonstrates reading data from a file using ifstream.
-    //   - Displays each player’s name and goals.
+    //   - Displays each player’s name and goals from the
+    //     in-memory table (loaded from the file with ifstream).
     //
     // Example Output:
     //   Player: Messi | Goals: 12
@@ -57,6 +139,48 @@ public:
     // ------------------------------------------------------------
     void displayPlayers();
 
+    // ------------------------------------------------------------
+    // Function: players
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Yields every record in file order, one at a time, straight
+    //     from the table (see Generator.h). Nothing is copied, and a
+    //     loop that stops early never looks at the remaining rows.
+    //
+    // Notes:
+    //   - The generator holds the shared (reader) lock from its
+    //     first value until it is destroyed, so each name stays
+    //     valid for the whole loop. Don't change the league from
+    //     inside the loop: the writer would wait for the lock
+    //     forever.
+    //
+    // Example:
+    //   for (const PlayerRecord& p : league.players()) {
+    //       if (p.goals > 20) { cout << p.name << '\n'; break; }
+    //   }
+    // ------------------------------------------------------------
+    Generator<PlayerRecord> players() const;
+
+    // ------------------------------------------------------------
+    // Function: records
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - The table as a random-access std::ranges view over the
+    //     name and goals columns (see SoccerViews.h), ready for
+    //     std::views::filter / transform / take and
+    //     SoccerViews::chunk. A whole pipeline is one lazy pass
+    //     with no intermediate vectors.
+    //   - Holds the reader lock for as long as the view (or any
+    //     pipeline built on it) exists; the same rule as players()
+    //     applies.
+    //
+    // Example:
+    //   auto m = league.records()
+    //          | std::views::filter([](PlayerRecord p) { return p.name.starts_with("M"); });
+    //   auto best = SoccerViews::topScorers(m, 10);
+    // ------------------------------------------------------------
+    SoccerViews::RecordView records() const;
+
     // ------------------------------------------------------------
     // Function: addPlayer
     // ------------------------------------------------------------
@@ -71,23 +195,414 @@ public:
     // Example:
     //   addPlayer("Alex Morgan", 8);
     //   → Adds "Alex Morgan,8" to the end of soccer.csv
+    //
+    // Returns false (after printing why) if the player could not be
+    // added or the change could not be written.
     // ------------------------------------------------------------
-    void addPlayer(const std::string& name, int goals);
+    bool addPlayer(const std::string& name, int goals);
+
+    // ------------------------------------------------------------
+    // Function: addPlayer (with a team)
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Same as above, but appends to the given team's file. In a
+    //     team directory, an unknown team gets a new file
+    //     ("teams/<team>.csv").
+    //   - Without a team (or with ""), new players – including
+    //     those added by updatePlayer() – join the first team.
+    //   - A name that SoccerLog::validName() refuses (empty, or
+    //     with ',' or a line break) is reported and not added; the
+    //     update functions below refuse it the same way.
+    //   - Like the update functions below, returns false if the
+    //     name is refused, there is no such team (file), the goal
+    //     history refuses the change, or the file or update log
+    //     can't be written.
+    //
+    // Example:
+    //   if (!league.addPlayer("Saka", 14, "arsenal")) return 1;
+    // ------------------------------------------------------------
+    bool addPlayer(const std::string& name, int goals, const std::string& team);
 
     // ------------------------------------------------------------
     // Function: updatePlayer
     // ------------------------------------------------------------
     // Purpose:
-    //   - Demonstrates reading and writing to the same file
-    //     using fstream (ios::in | ios::out).
     //   - Finds the player and updates their goal count.
     //   - If the player doesn’t exist, adds them as new.
+    //   - Appends the change to the update log ("Name,=N"); the file
+    //     is rewritten only once the log has grown to half its size.
+    //   - Returns false, and changes nothing, if the change can't
+    //     be logged.
     //
     // Example:
     //   updatePlayer("Rapinoe", 11);
     //   → Finds "Rapinoe" and updates their goals to 11.
     // ------------------------------------------------------------
-    void updatePlayer(const std::string& name, int newGoals);
+    bool updatePlayer(const std::string& name, int newGoals);
+
+    // ------------------------------------------------------------
+    // Function: updatePlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Same as calling updatePlayer() once per entry, but the
+    //     whole batch is logged with one append.
+    //   - One invalid name refuses the whole batch.
+    //
+    // Example:
+    //   updatePlayers({{"Messi", 13}, {"Rapinoe", 10}});
+    // ------------------------------------------------------------
+    bool updatePlayers(const std::vector<std::pair<std::string, int>>& updates);
+
+    // ------------------------------------------------------------
+    // Function: applyGoalEvents
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Adds a batch of goal "deltas" (e.g. {"Messi", +1}) to the
+    //     table. A player who isn't in the table yet is added with
+    //     the delta as their total.
+    //   - The whole batch is appended to the update log with one
+    //     write (and synced to disk) BEFORE the table changes, so an
+    //     event that was applied is never lost.
+    //   - Returns false if the log could not be written; the table
+    //     is then left unchanged.
+    //
+    // Example:
+    //   applyGoalEvents({{"Messi", 1}, {"Rapinoe", 2}});
+    // ------------------------------------------------------------
+    bool applyGoalEvents(const std::vector<std::pair<std::string, int>>& deltas);
+
+    // ------------------------------------------------------------
+    // Function: applyRecords
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Applies newline-separated update records ("Messi,+1",
+    //     "Messi,=13", "Messi,#13", see SoccerLog.h) in order, then
+    //     appends them to the update log. Used by replicas to replay
+    //     what the primary's change feed sent them.
+    //   - Returns the number of records applied; damaged lines are
+    //     skipped.
+    // ------------------------------------------------------------
+    size_t applyRecords(std::string_view records);
+
+    // ------------------------------------------------------------
+    // Function: logGoalEvents / applyLoggedGoalEvents
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - The two halves of applyGoalEvents(), for callers that run
+    //     them on different threads (see IngestPipeline.h).
+    //   - logGoalEvents() only writes the log; applyLoggedGoalEvents()
+    //     only changes the table. Every batch that was logged
+    //     successfully MUST be applied exactly once afterwards.
+    // ------------------------------------------------------------
+    bool logGoalEvents(const std::vector<std::pair<std::string, int>>& deltas);
+    void applyLoggedGoalEvents(const std::vector<std::pair<std::string, int>>& deltas);
+
+    // ------------------------------------------------------------
+    // Function: setLogSync
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Turns the fdatasync after each log append on (default) or
+    //     off. Off is faster but a power cut may lose recent events.
+    // ------------------------------------------------------------
+    void setLogSync(bool sync);
+
+    // ------------------------------------------------------------
+    // Function: recordGoals
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Stores each event (player, match, minute, delta) in the
+    //     goal history, then adds the deltas to the totals – one
+    //     step per batch, without recounting anything.
+    //   - The first call creates the history, starting with every
+    //     player's current total as an "opening balance" (match 0).
+    //     From then on, addPlayer/updatePlayer and goal events
+    //     without a match are recorded as match 0 corrections, so
+    //     the history always adds up to the table.
+    //   - Returns false if the history could not be written, or
+    //     if a player name isn't valid (nothing is recorded then).
+    //
+    // Example:
+    //   league.recordGoals({{"Messi", 7, 63, 1}});   // match 7, minute 63
+    // ------------------------------------------------------------
+    bool recordGoals(const std::vector<GoalEvent>& events);
+
+    // ------------------------------------------------------------
+    // Function: rebuildFromEvents
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Recomputes every total from the goal history in parallel
+    //     ('threads' = 0 uses one per CPU) and saves the result.
+    //   - A name without a row whose events add up to 0 (a change
+    //     that was taken back after a failed write) isn't added.
+    //   - Returns false if there is no history or it can't be read.
+    // ------------------------------------------------------------
+    bool rebuildFromEvents(unsigned threads = 0);
+
+    // ------------------------------------------------------------
+    // Function: goalHistory
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns every recorded event for one player, oldest first
+    //     (empty if there is no history).
+    // ------------------------------------------------------------
+    std::vector<GoalEvent> goalHistory(const std::string& name) const;
+
+    // ------------------------------------------------------------
+    // Function: formLeaderboard
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns the 'n' players with the most goals in the last
+    //     5 matches (FormWindow::MATCHES) or in the last 30 days
+    //     (FormWindow::DAYS), highest first.
+    //   - Based on the goal history, so only goals recorded with
+    //     recordGoals() count. The first call reads the history
+    //     once; after that the leaderboards are kept up to date as
+    //     goals are recorded, and a query costs O(n).
+    //
+    // Example:
+    //   auto hot = league.formLeaderboard(FormWindow::MATCHES, 5);
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> formLeaderboard(FormWindow window, size_t n);
+
+    // ------------------------------------------------------------
+    // Function: findPlayer
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Looks up one player by name without printing anything.
+    //   - Returns true and stores the goal count in 'goals'
+    //     if the player exists.
+    //
+    // Example:
+    //   int goals;
+    //   if (league.findPlayer("Messi", goals)) { ... }
+    // ------------------------------------------------------------
+    bool findPlayer(const std::string& name, int& goals) const;
+
+    // ------------------------------------------------------------
+    // Function: getPlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns a copy of every record in file order.
+    //   - Useful when a caller needs the data instead of console output.
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> getPlayers() const;
+
+    // ------------------------------------------------------------
+    // Function: topPlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns the 'n' players with the most goals, highest first.
+    //   - Ties are broken by name so the order is always the same.
+    //
+    // Example:
+    //   auto best = league.topPlayers(3);
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> topPlayers(size_t n) const;
+
+    // ------------------------------------------------------------
+    // Function: goalSummary / goalHistogram / goalPercentiles
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Statistics over every row's goals (see GoalAggregates.h):
+    //     count, sum, min, max, mean and variance; players per goal
+    //     count; and goal counts at percentiles (0-100).
+    //   - Computed straight from the goals column, using SIMD and
+    //     (for big tables) several threads.
+    //
+    // Example:
+    //   GoalSummary s = league.goalSummary();
+    //   auto median = league.goalPercentiles({50})[0];
+    // ------------------------------------------------------------
+    GoalSummary goalSummary() const;
+    GoalHistogram goalHistogram() const;
+    std::vector<int> goalPercentiles(const std::vector<double>& ps) const;
+
+    // ------------------------------------------------------------
+    // Function: countPlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns how many rows have between 'minGoals' and
+    //     'maxGoals' goals (both included).
+    //   - Answered from bitmap indexes over goal brackets (see
+    //     GoalBracketIndex.h), so most of the table is never read.
+    //
+    //   - The team version counts only that team's rows (0 for a
+    //     team that doesn't exist), by ANDing each bracket with
+    //     the team's bitmap.
+    //
+    // Example:
+    //   size_t scorers = league.countPlayers(10);       // 10 or more
+    //   size_t few = league.countPlayers(1, 4);
+    //   size_t strikers = league.countPlayers(10, INT_MAX, "strikers");
+    // ------------------------------------------------------------
+    size_t countPlayers(int minGoals, int maxGoals = INT_MAX) const;
+    size_t countPlayers(int minGoals, int maxGoals, const std::string& team) const;
+
+    // ------------------------------------------------------------
+    // Function: playersInRange
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns every player with between 'minGoals' and
+    //     'maxGoals' goals (both included), in file order.
+    //   - Uses an adaptive index (see CrackedColumn.h): the first
+    //     call copies the goals column, and every call sorts just
+    //     enough of that copy to answer it. No index has to be
+    //     built up front, and repeated queries get faster.
+    //
+    // Example:
+    //   auto midfield = league.playersInRange(5, 9);
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> playersInRange(int minGoals, int maxGoals) const;
+
+    // ------------------------------------------------------------
+    // Function: queryPlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns every player matching a compiled filter (see
+    //     PlayerFilter.h), in file order.
+    //
+    // Example:
+    //   PlayerFilter filter;
+    //   string error;
+    //   if (PlayerFilter::compile("goals >= 10 and name startswith 'R'", filter, error)) {
+    //       auto players = league.queryPlayers(filter);
+    //   }
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> queryPlayers(const PlayerFilter& filter) const;
+
+    // ------------------------------------------------------------
+    // Function: teams / teamPlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - teams() returns every team with its number of rows, in
+    //     file order (a single-file league is one team, named
+    //     after the file).
+    //   - teamPlayers() returns the rows of one team, in file order.
+    //
+    // Example:
+    //   for (const auto& t : league.teams()) cout << t.first << '\n';
+    //   auto squad = league.teamPlayers("arsenal");
+    // ------------------------------------------------------------
+    std::vector<std::pair<std::string, int>> teams() const;
+    std::vector<std::pair<std::string, int>> teamPlayers(const std::string& team) const;
+
+    // ------------------------------------------------------------
+    // Async API
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Coroutine versions of the calls above, for servers with
+    //     many clients (see Task.h and Executor.h):
+    //
+    //       co_await league.updatePlayerAsync("Messi", 13);
+    //       auto goals = co_await league.findPlayerAsync("Messi");
+    //
+    //   - Calls that write files (add / update / recordGoals) run
+    //     on the I/O thread; the caller is suspended meanwhile and
+    //     resumed on the executor, so no executor thread waits on
+    //     the disk.
+    //   - Reads only touch memory, so they run straight away on the
+    //     caller's thread.
+    //   - Arguments are taken by value: the coroutine keeps its own
+    //     copy while it is suspended.
+    // ------------------------------------------------------------
+    Task<bool> addPlayerAsync(std::string name, int goals);
+    Task<bool> updatePlayerAsync(std::string name, int newGoals);
+    Task<bool> updatePlayersAsync(std::vector<std::pair<std::string, int>> updates);
+    Task<bool> recordGoalsAsync(std::vector<GoalEvent> events);
+    Task<std::optional<int>> findPlayerAsync(std::string name) const;
+    Task<std::vector<std::pair<std::string, int>>> topPlayersAsync(size_t n) const;
+
+    // ------------------------------------------------------------
+    // Function: setAsyncContext
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Chooses the executor the async calls resume on and the
+    //     I/O thread that does their file writes. Without it they
+    //     use defaultExecutor() and defaultIoLoop().
+    //   - Call before the first async call; both must outlive the
+    //     league.
+    // ------------------------------------------------------------
+    void setAsyncContext(Executor& executor, IoLoop& io);
+
+    // ------------------------------------------------------------
+    // Function: setVerbose
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Turns the "Added ..." / "Updated ..." console messages on or off.
+    //   - Servers and scripts turn them off; the interactive menu keeps them.
+    // ------------------------------------------------------------
+    void setVerbose(bool verbose);
+
+    // ------------------------------------------------------------
+    // Function: publishSnapshot
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Copies the table into a POSIX shared memory segment
+    //     (see SoccerSnapshot.h) and keeps it up to date after
+    //     every add or update.
+    //   - Other processes can then read players straight from
+    //     memory with SoccerSnapshotReader.
+    //
+    // Example:
+    //   league.publishSnapshot("/soccer_snapshot");
+    // ------------------------------------------------------------
+    bool publishSnapshot(const std::string& shmName);
+
+    // ------------------------------------------------------------
+    // Function: setChangeFeed
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - After every change, 'feed' is called with the change as
+    //     update records (see SoccerLog.h) – e.g. to ship them to
+    //     replicas (SoccerReplication.h). Pass nullptr to stop.
+    //
+    // Notes:
+    //   - 'feed' runs while the table's writer lock is held, so the
+    //     records arrive in exactly the order the changes were made
+    //     and no reader can see a change before it was fed. It must
+    //     be quick (queue the records, don't send them) and must not
+    //     call back into the league.
+    // ------------------------------------------------------------
+    void setChangeFeed(std::function<void(std::string_view records)> feed);
+
+    // ------------------------------------------------------------
+    // Function: checkpoint
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Folds any goal events still waiting in the update log
+    //     into the data file (one rewrite), so the next Soccer
+    //     built on this file loads it without a replay.
+    //   - Does nothing if the log is already empty.
+    // ------------------------------------------------------------
+    bool checkpoint();
+
+    // ------------------------------------------------------------
+    // Function: repair
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Moves every line that couldn't be read at load time to
+    //     "<file>.damaged" and rewrites every team file, which also
+    //     stores fresh block checksums (see FileChecksum.h).
+    //   - Loading never does this by itself: a checksum mismatch
+    //     may just be a hand edit, and the lines stay in the file
+    //     until someone asks for the repair.
+    //   - Returns false if a file couldn't be written; 'moved' is
+    //     the number of lines moved.
+    // ------------------------------------------------------------
+    bool repair(size_t& moved);
+
+    // ------------------------------------------------------------
+    // Function: memoryUsage
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - A rough count of the bytes held by the in-memory table
+    //     and its indexes (used by LeagueManager to keep many
+    //     leagues within one memory budget).
+    //   - Walks every name, so call it now and then, not per request.
+    // ------------------------------------------------------------
+    size_t memoryUsage() const;
+
+    const std::string& filename() const { return filename_; }
 
 private:
     // ------------------------------------------------------------
@@ -99,6 +614,122 @@ private:
     // The underscore shows this is a private class member (not a local variable)
     std::string filename_;
 
+    // ------------------------------------------------------------
+    // Team files
+    // ------------------------------------------------------------
+    // Every row belongs to one team, and each team has its own file
+    // (a single-file league is just one team):
+    //
+    //   teamFiles_[t], teamNames_[t]  file and name of team t
+    //   teams_[row]                   team of each row (a third column)
+    //   dirtyTeams_[t]                the table has changes that
+    //                                 team t's file doesn't have yet
+    //
+    // rewriteFile() only rewrites the dirty teams' files.
+    //
+    // storageBase_ is where the update log and goal history live:
+    // the data file itself, or "<directory>/league".
+    // ------------------------------------------------------------
+    std::string storageBase_;
+    std::string teamDirectory_;   // New teams' files go here ("" = none allowed)
+    std::vector<std::string> teamFiles_;
+    std::vector<std::string> teamNames_;
+    std::vector<uint16_t> teams_;
+    std::vector<bool> dirtyTeams_;
+    std::vector<std::vector<std::string>> unreadable_;   // Per team: lines kept as they were read
+
+    // ------------------------------------------------------------
+    // In-memory player table
+    // ------------------------------------------------------------
+    // names_[i] and goals_[i] describe the same record (row i), in the
+    // same order as the lines of the file. Keeping each column in its
+    // own vector keeps all goal counts next to each other in memory.
+    //
+    // index_ maps a name to every row that holds it. addPlayer() appends
+    // without checking for duplicates (just like the file), so one name
+    // can appear on more than one row.
+    // ------------------------------------------------------------
+    std::vector<std::string> names_;
+    std::vector<int> goals_;
+    std::unordered_map<std::string, std::vector<size_t>, NameHash, std::equal_to<>> index_;
+
+    // Row numbers per goal bracket, for filtered counts. Kept in
+    // step with goals_ by appendRow / setGoals / addGoals, which are
+    // the only places that change a goal count.
+    GoalBracketIndex goalIndex_;
+
+    // Row numbers of each team (teamRows_[t] ↔ teams_[row] == t).
+    // A row never changes team, so appendRow keeps it current.
+    std::vector<RoaringBitmap> teamRows_;
+
+    // Adaptive range index (nullptr until the first playersInRange
+    // call). Queries reorganize it, so readers – who only hold the
+    // shared table lock – take crackMutex_ as well; writers hold
+    // the unique table lock and need nothing more.
+    mutable std::unique_ptr<CrackedColumn> cracked_;
+    mutable std::mutex crackMutex_;
+
+    // Readers take a shared lock, writers take a unique lock, so the
+    // table can be used safely from several threads at once.
+    mutable std::shared_mutex mutex_;
+
+    bool verbose_ = true;   // Print "Added ..." / "Updated ..." messages
+
+    // Update log next to the data file, and whether it holds records
+    // that soccer.csv doesn't include yet.
+    //
+    // log_ is protected by logMutex_ (not mutex_), so a slow disk
+    // write never blocks readers of the table. loggedBatches_ counts
+    // batches that are in the log but not yet in the table.
+    SoccerLog log_;
+    std::mutex logMutex_;
+    bool logDirty_ = false;
+    int loggedBatches_ = 0;
+    size_t fileBytes_ = 0;   // Roughly how big the data files are once rewritten
+    std::condition_variable_any loggedBatchesDone_;
+
+    // Goal history (nullptr until recordGoals() creates it, or if
+    // soccer.csv.events didn't exist at start-up). Changed only
+    // while holding BOTH logMutex_ and mutex_, so holding either
+    // one is enough to use the pointer.
+    std::unique_ptr<GoalEventStore> events_;
+
+    // Form leaderboards, built from events_ on first use (nullptr
+    // until then) and protected by formMutex_. Always locked after
+    // logMutex_ when both are needed.
+    std::unique_ptr<FormTracker> form_;
+    std::mutex formMutex_;
+
+    // Where async calls run (nullptr = the shared defaults).
+    Executor* executor_ = nullptr;
+    IoLoop* io_ = nullptr;
+
+    // Shared memory copy of the table (nullptr until publishSnapshot()).
+    std::unique_ptr<SoccerSnapshotWriter> snapshot_;
+
+    // Called with every change (see setChangeFeed); protected by mutex_.
+    std::function<void(std::string_view)> changeFeed_;
+
+    // ------------------------------------------------------------
+    // Helper Function: findTeamFiles
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Fills teamFiles_ / teamNames_ from filename_: the file
+    //     itself, every *.csv in a directory, or every match of a
+    //     glob pattern. Called first by the constructor.
+    // ------------------------------------------------------------
+    void findTeamFiles();
+
+    // ------------------------------------------------------------
+    // Helper Function: teamIndex
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Returns the number of team 'team' ("" = the first team),
+    //     creating it if that is allowed, or -1.
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    int teamIndex(const std::string& team);
+
     // ------------------------------------------------------------
     // Helper Function: ensureFileExists
     // ------------------------------------------------------------
@@ -110,4 +741,149 @@ private:
     // This helps avoid errors when trying to open a missing file.
     // ------------------------------------------------------------
     void ensureFileExists();
+
+    // ------------------------------------------------------------
+    // Helper Function: loadPlayers
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Reads every "Name,Goals" line of every team file into the
+    //     in-memory table, reading the files in parallel.
+    //   - Lines that aren't "Name,Goals" are kept in unreadable_
+    //     instead of the table.
+    //   - Called once by the constructor.
+    // ------------------------------------------------------------
+    void loadPlayers();
+
+    // ------------------------------------------------------------
+    // Helper Function: replayLog
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Applies every record in the update log on top of the
+    //     table read by loadPlayers(). Called once by the constructor.
+    // ------------------------------------------------------------
+    void replayLog();
+
+    // ------------------------------------------------------------
+    // Helper Function: recoverCheckpoint
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Finishes or throws away a rewriteFile() that was cut short
+    //     (for example by a crash). Called first by the constructor.
+    // ------------------------------------------------------------
+    void recoverCheckpoint();
+
+    // ------------------------------------------------------------
+    // Helper Function: appendRow
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Adds one record to the in-memory table and its indexes.
+    //   - Doesn't mark the team dirty: the caller knows whether the
+    //     row is already in the team's file.
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    void appendRow(const std::string& name, int goals, uint16_t team);
+
+    // ------------------------------------------------------------
+    // Helper Function: setGoals
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Updates every row with this name, or appends a new row.
+    //   - Returns true if the player already existed.
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    bool setGoals(const std::string& name, int goals);
+
+    // ------------------------------------------------------------
+    // Helper Function: addGoals
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Adds 'delta' to every row with this name, or appends a
+    //     new row with 'delta' goals.
+    //   - Returns true if the player already existed.
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    bool addGoals(std::string_view name, int delta);
+
+    // ------------------------------------------------------------
+    // Helper Function: rewriteFile
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Writes the in-memory table back to every team file that
+    //     is behind it and empties the update log (a "checkpoint").
+    //   - The new file is written next to the old one and renamed
+    //     over it, so a crash never leaves a half-written soccer.csv.
+    //   - The caller must already hold the lock.
+    // ------------------------------------------------------------
+    bool rewriteFile(std::unique_lock<std::shared_mutex>& lock);
+
+    // ------------------------------------------------------------
+    // Helper Function: persistRecords / logOutgrown
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Appends the records of a change already made in the table
+    //     to the update log, and rewrites the dirty files only once
+    //     the log has outgrown them (or the append failed).
+    //   - The caller holds logMutex_ and the unique lock.
+    // ------------------------------------------------------------
+    bool persistRecords(std::string_view records, std::unique_lock<std::shared_mutex>& lock);
+    bool logOutgrown() const;
+
+    // ------------------------------------------------------------
+    // Helper Function: logAhead / compactLog
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - The write-ahead way to do the same: logAhead() appends
+    //     the records of a change that is NOT in the table yet, and
+    //     returns false (nothing written) if it can't. The caller
+    //     changes the table only after that, then calls
+    //     compactLog(), which rewrites the files if the log has
+    //     outgrown them.
+    //   - The caller holds logMutex_ and the unique lock.
+    // ------------------------------------------------------------
+    bool logAhead(std::string_view records);
+    void compactLog(std::unique_lock<std::shared_mutex>& lock);
+
+    // ------------------------------------------------------------
+    // Helper Function: logDeltas
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - logGoalEvents() with the events to put in the goal
+    //     history: 'history' if given, otherwise one match 0
+    //     event per delta (only if the history is enabled).
+    // ------------------------------------------------------------
+    bool logDeltas(const std::vector<std::pair<std::string, int>>& deltas,
+                   const std::vector<GoalEvent>* history);
+
+    // ------------------------------------------------------------
+    // Helper Function: feedAdd
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Passes a new row to the change feed, if there is one.
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    void feedAdd(const std::string& name, int goals);
+
+    // ------------------------------------------------------------
+    // Helper Function: recordCorrection
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - If the goal history is enabled, records that 'name' went
+    //     from 'oldGoals' to 'newGoals' outside of a match.
+    //   - Returns false if the history couldn't be written; the
+    //     caller then leaves the table alone, as logDeltas() does.
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    bool recordCorrection(const std::string& name, int oldGoals, int newGoals);
+
+    // ------------------------------------------------------------
+    // Helper Function: refreshSnapshot
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Brings the shared memory snapshot up to date (if enabled).
+    //   - 'changedName' names the only player whose goals changed,
+    //     which allows a cheap in-place update; nullptr means
+    //     "republish everything".
+    //   - The caller must already hold the unique lock.
+    // ------------------------------------------------------------
+    void refreshSnapshot(const std::string* changedName);
 };
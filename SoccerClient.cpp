@@ -0,0 +1,319 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerClient.cpp
+// ------------------------------------------------------------
+// Pipelined client for SoccerServer. Sending happens on the
+// caller's thread; replies are read on a background thread.
+// ------------------------------------------------------------
+
+#include "SoccerClient.h"
+#include "SoccerProtocol.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+SoccerClient::SoccerClient(size_t batchSize) : batchSize_(max<size_t>(1, batchSize)) {}
+
+SoccerClient::~SoccerClient() {
+    disconnect();
+}
+
+// ------------------------------------------------------------
+// Function: connect
+// ------------------------------------------------------------
+bool SoccerClient::connect(const string& socketPath) {
+    disconnect();
+
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        cerr << "Error: Socket path is too long: " << socketPath << "\n";
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        cerr << "Error: Could not connect to " << socketPath << ": " << strerror(errno) << "\n";
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    connected_ = true;
+    reader_ = thread(&SoccerClient::readLoop, this);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: disconnect
+// ------------------------------------------------------------
+// shutdown() wakes the reader thread (its read() returns 0), and
+// then every request still waiting gets a "not connected" reply.
+// ------------------------------------------------------------
+void SoccerClient::disconnect() {
+    if (fd_ < 0) return;
+
+    connected_ = false;
+    shutdown(fd_, SHUT_RDWR);
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    close(fd_);
+    fd_ = -1;
+    failPending();
+}
+
+// ------------------------------------------------------------
+// Function: send (template helper)
+// ------------------------------------------------------------
+// 1. Reserve a requestId and register a promise for it.
+// 2. Build the frame ('encode' writes the payload).
+// 3. Write the whole frame while holding sendMutex_, so frames
+//    from different threads never interleave on the socket.
+//
+// The promise is registered BEFORE sending, so a very fast reply
+// can never arrive for an id the reader doesn't know yet.
+// ------------------------------------------------------------
+template <typename Encode>
+future<SoccerReply> SoccerClient::send(uint8_t opcode, Encode encode) {
+    promise<SoccerReply> reply;
+    future<SoccerReply> result = reply.get_future();
+
+    lock_guard<mutex> sendLock(sendMutex_);
+    uint32_t id = nextId_++;
+    {
+        // Checked under pendingMutex_: failPending() clears connected_
+        // under the same lock, so a request can't slip in after it.
+        lock_guard<mutex> lock(pendingMutex_);
+        if (!connected_) {
+            SoccerReply lost;
+            lost.connected = false;
+            reply.set_value(lost);
+            return result;
+        }
+        pending_.emplace(id, make_pair(opcode, move(reply)));
+    }
+
+    SoccerProtocol::FrameWriter frame(opcode, id);
+    encode(frame);
+    const vector<char>& bytes = frame.finish();
+
+    size_t sent = 0;
+    while (sent < bytes.size()) {
+        ssize_t n = ::send(fd_, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            // The reader thread will notice the broken socket and
+            // fail this request along with every other pending one.
+            connected_ = false;
+            shutdown(fd_, SHUT_RDWR);
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return result;
+}
+
+future<SoccerReply> SoccerClient::view() {
+    return send(SoccerProtocol::VIEW, [](SoccerProtocol::FrameWriter&) {});
+}
+
+future<SoccerReply> SoccerClient::get(const string& name) {
+    return send(SoccerProtocol::GET, [&](SoccerProtocol::FrameWriter& f) {
+        f.putString(name);
+    });
+}
+
+future<SoccerReply> SoccerClient::add(const string& name, int goals) {
+    return send(SoccerProtocol::ADD, [&](SoccerProtocol::FrameWriter& f) {
+        f.putString(name);
+        f.putI32(goals);
+    });
+}
+
+future<SoccerReply> SoccerClient::update(const string& name, int goals) {
+    return send(SoccerProtocol::UPDATE, [&](SoccerProtocol::FrameWriter& f) {
+        f.putString(name);
+        f.putI32(goals);
+    });
+}
+
+future<SoccerReply> SoccerClient::top(uint32_t n) {
+    return send(SoccerProtocol::TOP, [&](SoccerProtocol::FrameWriter& f) {
+        f.putU32(n);
+    });
+}
+
+future<SoccerReply> SoccerClient::count(int minGoals, int maxGoals) {
+    return send(SoccerProtocol::COUNT, [&](SoccerProtocol::FrameWriter& f) {
+        f.putI32(minGoals);
+        f.putI32(maxGoals);
+    });
+}
+
+future<SoccerReply> SoccerClient::stats() {
+    return send(SoccerProtocol::STATS, [](SoccerProtocol::FrameWriter&) {});
+}
+
+future<SoccerReply> SoccerClient::updateBatch(const vector<pair<string, int>>& updates) {
+    return send(SoccerProtocol::UPDATE_BATCH, [&](SoccerProtocol::FrameWriter& f) {
+        f.putPlayers(updates);
+    });
+}
+
+// ------------------------------------------------------------
+// Function: queueUpdate / flush
+// ------------------------------------------------------------
+// The queue is swapped out under its lock, then sent without it,
+// so other threads can keep queueing while a batch is on its way.
+//
+// The future of every batch is kept until flush() has seen its
+// answer. Answers that are already in are checked each time a
+// batch is sent, so a long load only keeps the batches still in
+// flight (plus the first failure).
+// ------------------------------------------------------------
+void SoccerClient::queueUpdate(const string& name, int goals) {
+    vector<pair<string, int>> batch;
+    {
+        lock_guard<mutex> lock(queueMutex_);
+        queued_.push_back({name, goals});
+        if (queued_.size() < batchSize_) return;
+        batch.swap(queued_);
+    }
+    future<SoccerReply> sent = updateBatch(batch);
+
+    lock_guard<mutex> lock(queueMutex_);
+    batches_.push_back(move(sent));
+    checkBatches();
+}
+
+void SoccerClient::checkBatches() {
+    size_t kept = 0;
+    for (auto& batch : batches_) {
+        if (batch.wait_for(chrono::seconds(0)) != future_status::ready) {
+            batches_[kept++] = move(batch);
+            continue;
+        }
+        SoccerReply reply = batch.get();
+        if (!reply.ok() && !batchFailure_) batchFailure_ = move(reply);
+    }
+    batches_.resize(kept);
+}
+
+// Returned "deferred", like ShardRouter's gathered replies: the
+// waiting happens on the caller's thread when it asks for the result.
+future<SoccerReply> SoccerClient::flush() {
+    vector<pair<string, int>> batch;
+    vector<future<SoccerReply>> sent;
+    optional<SoccerReply> failure;
+    {
+        lock_guard<mutex> lock(queueMutex_);
+        batch.swap(queued_);
+        sent.swap(batches_);
+        failure.swap(batchFailure_);
+    }
+    if (!batch.empty()) {
+        sent.push_back(updateBatch(batch));
+    }
+
+    SoccerReply ok;
+    ok.connected = connected_;
+    return async(launch::deferred, [sent = move(sent), failure = move(failure), ok]() mutable {
+        for (auto& reply : sent) {
+            SoccerReply answer = reply.get();
+            if (!answer.ok() && !failure) failure = move(answer);
+        }
+        return failure ? move(*failure) : ok;
+    });
+}
+
+size_t SoccerClient::inFlight() const {
+    lock_guard<mutex> lock(pendingMutex_);
+    return pending_.size();
+}
+
+// ------------------------------------------------------------
+// Function: readLoop
+// ------------------------------------------------------------
+// Runs on the background thread. Reads as many bytes as are
+// available, decodes every complete reply frame and completes
+// the promise that is waiting for its requestId.
+// ------------------------------------------------------------
+void SoccerClient::readLoop() {
+    vector<char> input;
+    char chunk[64 * 1024];
+
+    while (true) {
+        ssize_t n = read(fd_, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        input.insert(input.end(), chunk, chunk + n);
+
+        size_t offset = 0;
+        while (true) {
+            long frameSize = SoccerProtocol::nextFrame(input.data() + offset, input.size() - offset);
+            if (frameSize < 0) {
+                connected_ = false;
+                failPending();
+                return;
+            }
+            if (frameSize == 0) break;
+
+            SoccerProtocol::FrameReader in(input.data() + offset + 4, static_cast<size_t>(frameSize) - 4);
+            offset += static_cast<size_t>(frameSize);
+
+            pair<uint8_t, promise<SoccerReply>> waiting;
+            {
+                lock_guard<mutex> lock(pendingMutex_);
+                auto it = pending_.find(in.requestId());
+                if (it == pending_.end()) continue;     // Nobody is waiting for this id
+                waiting = move(it->second);
+                pending_.erase(it);
+            }
+
+            // The payload shape depends on which request this answers.
+            SoccerReply reply;
+            reply.status = in.code();
+            if (reply.status == SoccerProtocol::OK) {
+                if (waiting.first == SoccerProtocol::GET) {
+                    int32_t goals = 0;
+                    in.getI32(goals);
+                    reply.goals = goals;
+                } else if (waiting.first == SoccerProtocol::VIEW || waiting.first == SoccerProtocol::TOP ||
+                           waiting.first == SoccerProtocol::STATS) {
+                    in.getPlayers(reply.players);
+                } else if (waiting.first == SoccerProtocol::COUNT) {
+                    in.getU32(reply.count);
+                }
+            }
+            waiting.second.set_value(move(reply));
+        }
+        input.erase(input.begin(), input.begin() + offset);
+    }
+
+    connected_ = false;
+    failPending();
+}
+
+// ------------------------------------------------------------
+// Function: failPending
+// ------------------------------------------------------------
+// Completes every waiting request with connected = false, so no
+// caller is left blocked on a future that can never finish.
+// ------------------------------------------------------------
+void SoccerClient::failPending() {
+    lock_guard<mutex> lock(pendingMutex_);
+    connected_ = false;
+    for (auto& entry : pending_) {
+        SoccerReply lost;
+        lost.connected = false;
+        entry.second.second.set_value(lost);
+    }
+    pending_.clear();
+}
@@ -0,0 +1,144 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerClient.h
+// ------------------------------------------------------------
+// A small client library for SoccerServer.
+//
+// Every call sends its request and returns a std::future right
+// away – it does NOT wait for the answer. Many requests can be
+// "in flight" on one connection at the same time (pipelining),
+// so a script is limited by how fast the server works, not by
+// the round trip of each single call.
+//
+// A background thread reads replies and completes the matching
+// future (replies are matched by requestId, see SoccerProtocol.h).
+//
+// Small updates can also be collected with queueUpdate() and
+// sent together in a single UPDATE_BATCH frame.
+//
+// Example:
+//   SoccerClient client;
+//   if (!client.connect("/tmp/soccer.sock")) return 1;
+//
+//   auto a = client.update("Messi", 13);     // sent, not waited for
+//   auto b = client.top(3);                  // sent, not waited for
+//   a.get();                                 // wait for the first answer
+//   for (auto& p : b.get().players) { ... }
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <future>
+#include <optional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Struct: SoccerReply
+// ------------------------------------------------------------
+// The decoded answer to one request.
+//   status  → SoccerProtocol::Status (OK, NOT_FOUND, BAD_REQUEST, ...)
+//   goals   → filled in by get()
+//   count   → filled in by count()
+//   players → filled in by view() and top() (and stats())
+//
+// If the connection is lost, 'connected' is false.
+// ------------------------------------------------------------
+struct SoccerReply {
+    uint8_t status = 0;
+    bool connected = true;
+    int goals = 0;
+    uint32_t count = 0;
+    std::vector<std::pair<std::string, int>> players;
+
+    bool ok() const { return connected && status == 0; }
+};
+
+class SoccerClient {
+public:
+    // ------------------------------------------------------------
+    // Constructor
+    // ------------------------------------------------------------
+    // 'batchSize' is how many queued updates trigger an automatic
+    // UPDATE_BATCH frame (see queueUpdate()).
+    // ------------------------------------------------------------
+    explicit SoccerClient(size_t batchSize = 256);
+    ~SoccerClient();
+
+    SoccerClient(const SoccerClient&) = delete;
+    SoccerClient& operator=(const SoccerClient&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: connect / disconnect
+    // ------------------------------------------------------------
+    // connect() opens the socket and starts the reply thread.
+    // disconnect() closes it; futures still waiting are completed
+    // with connected = false.
+    // ------------------------------------------------------------
+    bool connect(const std::string& socketPath);
+    void disconnect();
+
+    // ------------------------------------------------------------
+    // Pipelined requests
+    // ------------------------------------------------------------
+    // Each function sends one frame and returns immediately.
+    // ------------------------------------------------------------
+    std::future<SoccerReply> view();
+    std::future<SoccerReply> get(const std::string& name);
+    std::future<SoccerReply> add(const std::string& name, int goals);
+    std::future<SoccerReply> update(const std::string& name, int goals);
+    std::future<SoccerReply> top(uint32_t n);
+    std::future<SoccerReply> count(int minGoals, int maxGoals);
+    std::future<SoccerReply> updateBatch(const std::vector<std::pair<std::string, int>>& updates);
+
+    // The server's counters (e.g. replication lag) in 'players',
+    // as (name, value) pairs.
+    std::future<SoccerReply> stats();
+
+    // ------------------------------------------------------------
+    // Function: queueUpdate / flush
+    // ------------------------------------------------------------
+    // queueUpdate() only stores the update. When 'batchSize' updates
+    // are waiting they are sent as one UPDATE_BATCH frame. flush()
+    // sends whatever is left and returns a future that waits for the
+    // answer to every batch sent since the last flush(): the first
+    // failed one (e.g. READ_ONLY, BAD_REQUEST, WRITE_FAILED) if any,
+    // otherwise OK (also if nothing was queued).
+    // ------------------------------------------------------------
+    void queueUpdate(const std::string& name, int goals);
+    std::future<SoccerReply> flush();
+
+    // Number of requests sent but not yet answered.
+    size_t inFlight() const;
+
+private:
+    int fd_ = -1;
+    size_t batchSize_;
+
+    std::mutex sendMutex_;               // One frame at a time on the socket
+    uint32_t nextId_ = 1;
+
+    mutable std::mutex pendingMutex_;    // Protects pending_
+    std::unordered_map<uint32_t, std::pair<uint8_t, std::promise<SoccerReply>>> pending_;
+
+    std::mutex queueMutex_;              // Protects the three fields below
+    std::vector<std::pair<std::string, int>> queued_;
+    std::vector<std::future<SoccerReply>> batches_;   // Sent by queueUpdate(), answer not seen yet
+    std::optional<SoccerReply> batchFailure_;         // First failed batch since the last flush()
+
+    std::thread reader_;
+    std::atomic<bool> connected_{false};
+
+    // Registers a promise, assigns the requestId and sends the frame.
+    template <typename Encode>
+    std::future<SoccerReply> send(uint8_t opcode, Encode encode);
+
+    void readLoop();
+    void failPending();
+    void checkBatches();                 // Caller holds queueMutex_
+};
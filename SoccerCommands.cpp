@@ -0,0 +1,578 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerCommands.cpp
+// ------------------------------------------------------------
+// Parsing and running the script-friendly commands described
+// in SoccerCommands.h.
+//
+// Output is written with '\n' (never endl), so nothing is flushed
+// until the stream's buffer is full or the program ends.
+// ------------------------------------------------------------
+
+#include "SoccerCommands.h"
+#include <fstream>
+#include <sstream>
+#include <charconv>   // for from_chars (fast, strict number parsing)
+#include <utility>
+#include <cmath>      // for sqrt
+#include "TaskScheduler.h"
+using namespace std;
+
+namespace SoccerCommands {
+
+namespace {
+
+// One parsed command, whichever way it was written.
+struct Command {
+    string verb;
+    string name;      // get / add / update
+    int goals = 0;    // add / update
+    size_t count = 0; // top
+    string path;      // import
+    uint32_t match = 0;   // goal
+    uint16_t minute = 0;  // goal
+    FormWindow window = FormWindow::MATCHES;   // form
+    vector<double> percents;                   // percentiles
+    int minGoals = 0;                          // count / range
+    int maxGoals = INT_MAX;                    // count / range
+    string query;                              // query
+    string team;                               // add / count (optional) / team
+};
+
+// Parses the whole string as a number; "12abc" or "" fail.
+template <typename Number>
+bool parseNumber(const string& text, Number& value) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    auto result = from_chars(first, last, value);
+    return result.ec == errc() && result.ptr == last;
+}
+
+// Shortest text that reads back as the same number ("2.5", "10").
+string formatDouble(double value) {
+    char text[32];
+    auto result = to_chars(text, text + sizeof(text), value);
+    return string(text, result.ptr);
+}
+
+// Splits "Name,Goals" the way the data file is read (at the LAST
+// comma, see SoccerLog::parseRow), but both parts must be there.
+bool parseRecord(const string& text, string& name, int& goals) {
+    size_t comma = text.rfind(',');
+    if (comma == string::npos || comma == 0 || comma + 1 == text.size()) return false;
+
+    string_view found;
+    if (!SoccerLog::parseRow(text, found, goals)) return false;
+    name = string(found);
+    return true;
+}
+
+// Splits "Name,Match,Minute,Delta", taking the numbers from the
+// right, so a name with a comma reaches execute() and is refused
+// there with a proper message.
+bool parseGoal(const string& text, Command& cmd) {
+    string rest = text;
+    string fields[3];
+    for (int i = 2; i >= 0; --i) {
+        size_t comma = rest.rfind(',');
+        if (comma == string::npos || comma == 0) return false;
+        fields[i] = rest.substr(comma + 1);
+        rest.resize(comma);
+    }
+    cmd.name = rest;
+    return parseNumber(fields[0], cmd.match) && parseNumber(fields[1], cmd.minute) &&
+           parseNumber(fields[2], cmd.goals);
+}
+
+// "matches" or "days".
+bool parseWindow(const string& text, FormWindow& window) {
+    if (text == "matches") window = FormWindow::MATCHES;
+    else if (text == "days") window = FormWindow::DAYS;
+    else return false;
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: parseArgs
+// ------------------------------------------------------------
+// Command-line form: every value is its own argv word.
+// ------------------------------------------------------------
+bool parseArgs(const vector<string>& args, Command& cmd) {
+    if (args.empty()) return false;
+    cmd.verb = args[0];
+    size_t extra = args.size() - 1;
+
+    if (cmd.verb == "view") return extra == 0;
+    if (cmd.verb == "get" && extra == 1) {
+        cmd.name = args[1];
+        return true;
+    }
+    if ((cmd.verb == "add" || cmd.verb == "update") && extra == 2) {
+        cmd.name = args[1];
+        return parseNumber(args[2], cmd.goals);
+    }
+    if (cmd.verb == "add" && extra == 3) {
+        cmd.name = args[1];
+        cmd.team = args[3];
+        return parseNumber(args[2], cmd.goals);
+    }
+    if (cmd.verb == "team" && extra == 1) {
+        cmd.team = args[1];
+        return true;
+    }
+    if (cmd.verb == "teams") return extra == 0;
+    if (cmd.verb == "top" && extra == 1) return parseNumber(args[1], cmd.count);
+    if (cmd.verb == "import" && extra == 1) {
+        cmd.path = args[1];
+        return true;
+    }
+    if (cmd.verb == "goal" && (extra == 3 || extra == 4)) {
+        cmd.name = args[1];
+        cmd.goals = 1;
+        return parseNumber(args[2], cmd.match) && parseNumber(args[3], cmd.minute) &&
+               (extra == 3 || parseNumber(args[4], cmd.goals));
+    }
+    if (cmd.verb == "history" && extra == 1) {
+        cmd.name = args[1];
+        return true;
+    }
+    if (cmd.verb == "rebuild" || cmd.verb == "repair") return extra == 0;
+    if (cmd.verb == "form" && extra == 2) {
+        return parseWindow(args[1], cmd.window) && parseNumber(args[2], cmd.count);
+    }
+    if (cmd.verb == "stats" || cmd.verb == "histogram" || cmd.verb == "scheduler") return extra == 0;
+    if (cmd.verb == "query" && extra >= 1) {
+        // The filter may be one quoted argument or several words.
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (i > 1) cmd.query += ' ';
+            cmd.query += args[i];
+        }
+        return true;
+    }
+    if (cmd.verb == "range" && extra == 2) {
+        return parseNumber(args[1], cmd.minGoals) && parseNumber(args[2], cmd.maxGoals);
+    }
+    if (cmd.verb == "count" && extra >= 1 && extra <= 3) {
+        if (extra == 3) cmd.team = args[3];
+        return parseNumber(args[1], cmd.minGoals) &&
+               (extra == 1 || parseNumber(args[2], cmd.maxGoals));
+    }
+    if (cmd.verb == "percentiles" && extra >= 1) {
+        for (size_t i = 1; i < args.size(); ++i) {
+            double p;
+            if (!parseNumber(args[i], p) || p < 0 || p > 100) return false;
+            cmd.percents.push_back(p);
+        }
+        return true;
+    }
+    return false;
+}
+
+// ------------------------------------------------------------
+// Function: parseLine
+// ------------------------------------------------------------
+// Batch form: "verb rest-of-line", where rest-of-line is
+// "Name,Goals" for add/update so names can contain spaces.
+// ------------------------------------------------------------
+bool parseLine(const string& line, Command& cmd) {
+    size_t space = line.find(' ');
+    cmd.verb = line.substr(0, space);
+    string rest = (space == string::npos) ? "" : line.substr(space + 1);
+
+    if (cmd.verb == "view") return rest.empty();
+    if (cmd.verb == "get") {
+        cmd.name = rest;
+        return !rest.empty();
+    }
+    if (cmd.verb == "add" || cmd.verb == "update") return parseRecord(rest, cmd.name, cmd.goals);
+    if (cmd.verb == "top") return parseNumber(rest, cmd.count);
+    if (cmd.verb == "import") {
+        cmd.path = rest;
+        return !rest.empty();
+    }
+    if (cmd.verb == "goal") return parseGoal(rest, cmd);
+    if (cmd.verb == "history") {
+        cmd.name = rest;
+        return !rest.empty();
+    }
+    if (cmd.verb == "rebuild" || cmd.verb == "repair" || cmd.verb == "teams") return rest.empty();
+    if (cmd.verb == "team") {
+        cmd.team = rest;
+        return !rest.empty();
+    }
+    if (cmd.verb == "stats" || cmd.verb == "histogram" || cmd.verb == "scheduler") return rest.empty();
+    if (cmd.verb == "percentiles") {
+        vector<string> words;
+        size_t start = 0;
+        while (start < rest.size()) {
+            size_t end = rest.find(' ', start);
+            if (end == string::npos) end = rest.size();
+            if (end > start) words.push_back(rest.substr(start, end - start));
+            start = end + 1;
+        }
+        for (const string& word : words) {
+            double p;
+            if (!parseNumber(word, p) || p < 0 || p > 100) return false;
+            cmd.percents.push_back(p);
+        }
+        return !cmd.percents.empty();
+    }
+    if (cmd.verb == "query") {
+        cmd.query = rest;
+        return !rest.empty();
+    }
+    if (cmd.verb == "range") {
+        size_t space2 = rest.find(' ');
+        if (space2 == string::npos) return false;
+        return parseNumber(rest.substr(0, space2), cmd.minGoals) &&
+               parseNumber(rest.substr(space2 + 1), cmd.maxGoals);
+    }
+    if (cmd.verb == "count") {
+        size_t space2 = rest.find(' ');
+        if (space2 == string::npos) return parseNumber(rest, cmd.minGoals);
+        string tail = rest.substr(space2 + 1);
+        size_t space3 = tail.find(' ');
+        if (space3 != string::npos) {
+            cmd.team = tail.substr(space3 + 1);
+            tail.resize(space3);
+        }
+        return parseNumber(rest.substr(0, space2), cmd.minGoals) &&
+               parseNumber(tail, cmd.maxGoals);
+    }
+    if (cmd.verb == "form") {
+        size_t space2 = rest.find(' ');
+        if (space2 == string::npos) return false;
+        return parseWindow(rest.substr(0, space2), cmd.window) &&
+               parseNumber(rest.substr(space2 + 1), cmd.count);
+    }
+    return false;
+}
+
+// ------------------------------------------------------------
+// Function: importFile
+// ------------------------------------------------------------
+// Reads every "Name,Goals" line and applies them as one batch.
+// ------------------------------------------------------------
+bool importFile(Soccer& league, const string& path, string& error, ostream& err) {
+    ifstream in(path);
+    if (!in) {
+        error = "could not open " + path;
+        return false;
+    }
+
+    vector<pair<string, int>> updates;
+    string line;
+    size_t lineNumber = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        if (line.empty()) continue;
+
+        string name;
+        int goals;
+        if (!parseRecord(line, name, goals) || !SoccerLog::validName(name)) {
+            err << "warning: " << path << ":" << lineNumber << ": skipped bad line\n";
+            continue;
+        }
+        updates.push_back({move(name), goals});
+    }
+
+    if (!league.updatePlayers(updates)) {
+        error = "could not apply the updates from " + path;
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: execute
+// ------------------------------------------------------------
+// Runs one parsed command. Any output rows are stored in 'rows'
+// ("Name,Goals") or, for statistics, in 'lines' ("key,value").
+// ------------------------------------------------------------
+bool execute(Soccer& league, const Command& cmd, vector<pair<string, int>>& rows,
+             vector<string>& lines, string& error, ostream& err) {
+    rows.clear();
+    lines.clear();
+
+    // Names that are stored must fit one "Name,Goals" record.
+    if ((cmd.verb == "add" || cmd.verb == "update" || cmd.verb == "goal") &&
+        !SoccerLog::validName(cmd.name)) {
+        error = "bad name (it can't be empty or contain ',' or a line break): " + cmd.name;
+        return false;
+    }
+
+    if (cmd.verb == "view") {
+        rows = league.getPlayers();
+    } else if (cmd.verb == "get") {
+        int goals;
+        if (!league.findPlayer(cmd.name, goals)) {
+            error = "not found: " + cmd.name;
+            return false;
+        }
+        rows.push_back({cmd.name, goals});
+    } else if (cmd.verb == "add") {
+        if (!league.addPlayer(cmd.name, cmd.goals, cmd.team)) {
+            error = "could not add " + cmd.name;
+            return false;
+        }
+    } else if (cmd.verb == "update") {
+        if (!league.updatePlayer(cmd.name, cmd.goals)) {
+            error = "could not update " + cmd.name;
+            return false;
+        }
+    } else if (cmd.verb == "top") {
+        rows = league.topPlayers(cmd.count);
+    } else if (cmd.verb == "import") {
+        return importFile(league, cmd.path, error, err);
+    } else if (cmd.verb == "goal") {
+        if (!league.recordGoals({{cmd.name, cmd.match, cmd.minute, cmd.goals}})) {
+            error = "could not record the goal";
+            return false;
+        }
+    } else if (cmd.verb == "history") {
+        // Printed as "Match,Minute" + "," + delta, like any other row.
+        for (const GoalEvent& event : league.goalHistory(cmd.name)) {
+            rows.push_back({to_string(event.match) + "," + to_string(event.minute), event.delta});
+        }
+    } else if (cmd.verb == "form") {
+        rows = league.formLeaderboard(cmd.window, cmd.count);
+    } else if (cmd.verb == "stats") {
+        GoalSummary s = league.goalSummary();
+        lines.push_back("count," + to_string(s.count));
+        lines.push_back("sum," + to_string(s.sum));
+        lines.push_back("min," + to_string(s.min));
+        lines.push_back("max," + to_string(s.max));
+        lines.push_back("mean," + formatDouble(s.mean));
+        lines.push_back("variance," + formatDouble(s.variance));
+        lines.push_back("stddev," + formatDouble(sqrt(s.variance)));
+    } else if (cmd.verb == "percentiles") {
+        vector<int> values = league.goalPercentiles(cmd.percents);
+        for (size_t i = 0; i < values.size(); ++i) {
+            lines.push_back("p" + formatDouble(cmd.percents[i]) + "," + to_string(values[i]));
+        }
+    } else if (cmd.verb == "query") {
+        PlayerFilter filter;
+        string problem;
+        if (!PlayerFilter::compile(cmd.query, filter, problem)) {
+            error = "bad query: " + problem;
+            return false;
+        }
+        rows = league.queryPlayers(filter);
+    } else if (cmd.verb == "teams") {
+        rows = league.teams();
+    } else if (cmd.verb == "team") {
+        rows = league.teamPlayers(cmd.team);
+    } else if (cmd.verb == "range") {
+        rows = league.playersInRange(cmd.minGoals, cmd.maxGoals);
+    } else if (cmd.verb == "scheduler") {
+        SchedulerMetrics m = TaskScheduler::shared().metrics();
+        lines.push_back("workers," + to_string(m.workers));
+        lines.push_back("tasks," + to_string(m.tasksRun));
+        lines.push_back("steals," + to_string(m.steals));
+        lines.push_back("idle_seconds," + formatDouble(m.idleSeconds));
+        lines.push_back("queue_depth," + to_string(m.queueDepth));
+    } else if (cmd.verb == "count") {
+        size_t n = cmd.team.empty() ? league.countPlayers(cmd.minGoals, cmd.maxGoals)
+                                    : league.countPlayers(cmd.minGoals, cmd.maxGoals, cmd.team);
+        lines.push_back("count," + to_string(n));
+    } else if (cmd.verb == "histogram") {
+        // "Goals,Players" for every goal count that occurs.
+        GoalHistogram h = league.goalHistogram();
+        for (size_t i = 0; i < h.counts.size(); ++i) {
+            if (h.counts[i] > 0) {
+                lines.push_back(to_string(h.min + int(i)) + "," + to_string(h.counts[i]));
+            }
+        }
+    } else if (cmd.verb == "rebuild") {
+        if (!league.rebuildFromEvents()) {
+            error = "could not rebuild from the goal history";
+            return false;
+        }
+    } else if (cmd.verb == "repair") {
+        size_t moved = 0;
+        if (!league.repair(moved)) {
+            error = "could not rewrite the data files";
+            return false;
+        }
+        lines.push_back("moved," + to_string(moved));
+    }
+    return true;
+}
+
+void printRows(ostream& out, const vector<pair<string, int>>& rows, const vector<string>& lines) {
+    for (const auto& row : rows) {
+        out << row.first << ',' << row.second << '\n';
+    }
+    for (const string& line : lines) {
+        out << line << '\n';
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+// Function: runCommand
+// ------------------------------------------------------------
+int runCommand(Soccer& league, const vector<string>& args, ostream& out, ostream& err) {
+    Command cmd;
+    if (!parseArgs(args, cmd)) {
+        err << "error: bad command (expected view | get NAME | add NAME GOALS |"
+               " update NAME GOALS | top N | import FILE | goal NAME MATCH MINUTE [DELTA] |"
+               " history NAME | rebuild | repair | form matches|days N | stats | percentiles P... |"
+               " histogram | count MIN [MAX [TEAM]] | range MIN MAX | query FILTER | scheduler |"
+               " teams | team NAME | batch)\n";
+        return 2;
+    }
+
+    // A single "view" streams the table instead of copying it first,
+    // so exporting a huge league needs no extra memory.
+    if (cmd.verb == "view") {
+        for (const PlayerRecord& p : league.players()) {
+            out << p.name << ',' << p.goals << '\n';
+        }
+        return 0;
+    }
+
+    vector<pair<string, int>> rows;
+    vector<string> lines;
+    string error;
+    if (!execute(league, cmd, rows, lines, error, err)) {
+        err << "error: " << error << '\n';
+        return 1;
+    }
+    printRows(out, rows, lines);
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Function: runBatch
+// ------------------------------------------------------------
+// Update commands are not run one at a time: they are collected
+// until a different kind of command (or the end of input) shows
+// up, then applied with a single updatePlayers() call. Their
+// "ok 0" answers – or, if the batch couldn't be applied, one
+// "error" answer each – are printed at that moment, so the
+// answers still come out in the same order as the commands.
+// ------------------------------------------------------------
+int runBatch(Soccer& league, istream& in, ostream& out, ostream& err) {
+    vector<pair<string, int>> pendingUpdates;
+    vector<pair<string, int>> rows;
+    vector<string> lines;
+    int status = 0;
+
+    auto flushUpdates = [&]() {
+        if (pendingUpdates.empty()) return;
+        bool applied = league.updatePlayers(pendingUpdates);
+        for (size_t i = 0; i < pendingUpdates.size(); ++i) {
+            if (applied) {
+                out << "ok 0\n";
+            } else {
+                out << "error could not update " << pendingUpdates[i].first << '\n';
+            }
+        }
+        if (!applied) status = 1;
+        pendingUpdates.clear();
+    };
+
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();   // Windows line endings
+        if (line.empty()) continue;
+
+        Command cmd;
+        if (!parseLine(line, cmd)) {
+            flushUpdates();
+            out << "error bad command: " << line << '\n';
+            status = 1;
+            continue;
+        }
+
+        // A bad name goes through execute(), which answers with the error.
+        if (cmd.verb == "update" && SoccerLog::validName(cmd.name)) {
+            pendingUpdates.push_back({move(cmd.name), cmd.goals});
+            continue;
+        }
+        flushUpdates();
+
+        string error;
+        if (!execute(league, cmd, rows, lines, error, err)) {
+            out << "error " << error << '\n';
+            status = 1;
+            continue;
+        }
+        out << "ok " << rows.size() + lines.size() << '\n';
+        printRows(out, rows, lines);
+    }
+
+    flushUpdates();
+    return status;
+}
+
+// ------------------------------------------------------------
+// Function: runLeagueBatch
+// ------------------------------------------------------------
+// The lines for one league are collected first and then handed to
+// runBatch() in one go, so consecutive updates are still applied
+// with a single log append. The league is only held (and so can't be
+// evicted) while its batch runs.
+// ------------------------------------------------------------
+int runLeagueBatch(LeagueManager& leagues, istream& in, ostream& out, ostream& err) {
+    string current;
+    string pending;   // Commands for 'current' not run yet
+    int status = 0;
+
+    auto flushPending = [&]() {
+        if (pending.empty()) return;
+        istringstream commands(pending);
+        pending.clear();
+
+        // "use" checked the name, and leagues are never unregistered.
+        shared_ptr<Soccer> league = leagues.league(current);
+        if (runBatch(*league, commands, out, err) != 0) status = 1;
+    };
+
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();   // Windows line endings
+        if (line.empty()) continue;
+
+        if (line.rfind("use ", 0) == 0) {
+            flushPending();
+            current = line.substr(4);
+            if (!leagues.league(current)) {
+                out << "error unknown league: " << current << '\n';
+                current.clear();
+                status = 1;
+                continue;
+            }
+            out << "ok 0\n";
+        } else if (line == "leagues") {
+            flushPending();
+            vector<string> names = leagues.leagueNames();
+            out << "ok " << names.size() << '\n';
+            for (const string& name : names) out << name << '\n';
+        } else if (line == "leaguestats") {
+            flushPending();
+            LeagueManagerStats s = leagues.stats();
+            out << "ok 7\n";
+            out << "hosted," << s.hosted << '\n';
+            out << "loaded," << s.loaded << '\n';
+            out << "memory_bytes," << s.memoryBytes << '\n';
+            out << "memory_budget," << s.memoryBudget << '\n';
+            out << "hits," << s.hits << '\n';
+            out << "loads," << s.loads << '\n';
+            out << "evictions," << s.evictions << '\n';
+        } else if (current.empty()) {
+            out << "error no league selected (use NAME first)\n";
+            status = 1;
+        } else {
+            pending += line;
+            pending += '\n';
+        }
+    }
+
+    flushPending();
+    return status;
+}
+
+} // namespace SoccerCommands
@@ -0,0 +1,133 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerCommands.h
+// ------------------------------------------------------------
+// Non-interactive commands for scripts, cron jobs and pipelines.
+//
+// The interactive menu prints a banner and a prompt for every
+// operation, which is friendly for people but slow and awkward
+// for programs. These commands print ONLY data, in the same
+// "Name,Goals" format as soccer.csv, and never prompt.
+//
+// Commands (the same names are used on the command line and in
+// batch mode):
+//
+//   view                  → every player, one "Name,Goals" per line
+//   get NAME              → one "Name,Goals" line
+//   add NAME GOALS [TEAM] → append a player (to TEAM's file in a
+//                           team directory; TEAM is command line only)
+//   update NAME GOALS     → set a player's goals (adds if missing)
+//   top N                 → the N best scorers
+//   import FILE           → apply every "Name,Goals" line of FILE
+//                           as an update (one log append in total)
+//   goal NAME MATCH MINUTE [DELTA]
+//                         → record a goal (DELTA defaults to 1) in
+//                           the goal history (see GoalEventStore.h)
+//   history NAME          → that player's goals, one
+//                           "Match,Minute,Delta" line each
+//   rebuild               → recompute every total from the history
+//   repair                → move unreadable lines to FILE.damaged and
+//                           rewrite the files with new checksums
+//                           ("moved,N")
+//   form matches N        → the N best scorers over the league's
+//                           last 5 matches (from the history)
+//   form days N           → the N best scorers of the last 30 days
+//   stats                 → count, sum, min, max, mean, variance and
+//                           stddev of all goal counts ("key,value")
+//   percentiles P...      → goal count at each percentile ("p90,14")
+//   histogram             → players per goal count ("Goals,Players")
+//   count MIN [MAX]       → how many players have MIN..MAX goals
+//                           ("count,N"; no MAX = no upper limit)
+//   count MIN MAX TEAM    → the same, counting only TEAM's players
+//   range MIN MAX         → every player with MIN..MAX goals
+//   query FILTER          → every player matching FILTER, e.g.
+//                           "goals >= 10 and name startswith 'R'"
+//                           (see PlayerFilter.h for the syntax)
+//   teams                 → every team with its number of players
+//                           ("Team,Players"; see Soccer.h)
+//   team NAME             → every player of one team
+//   scheduler             → metrics of the shared worker pool
+//                           (workers, tasks, steals, idle_seconds,
+//                           queue_depth; see TaskScheduler.h)
+//
+// Command line example:
+//   ./Module9_Code_Together add "Alex Morgan" 8
+//   ./Module9_Code_Together -f league.csv top 3
+//   ./Module9_Code_Together -f teams/ add Saka 14 arsenal
+//
+// Batch mode ("./Module9_Code_Together batch < commands.txt")
+// reads one command per line from standard input.
+// Because names may contain spaces, add/update/get take the rest
+// of the line as "Name,Goals" (or just "Name" for get):
+//
+//   update Alex Morgan,9
+//   goal Alex Morgan,7,63,1      (Name,Match,Minute,Delta)
+//   get Alex Morgan
+//   top 2
+//
+// A name that is stored (add, update, goal) can't be empty or
+// contain ',' or a line break; such a command fails with an error.
+//
+// and every command is answered with a header line followed by
+// the data lines:
+//
+//   ok 0
+//   ok 1
+//   Alex Morgan,9
+//   ok 2
+//   Messi,12
+//   Ronaldo,10
+//
+// or with "error <message>" if the command failed.
+//
+// League batch mode ("./Module9_Code_Together leagues DIR < commands.txt",
+// see LeagueManager.h) hosts every league file in DIR at once. Two
+// more commands pick which league the others go to:
+//
+//   use NAME              → the following commands run on DIR/NAME.csv
+//   leagues               → every league name, one per line
+//   leaguestats           → hosted, loaded, memory and cache counters
+//                           ("key,value")
+// ------------------------------------------------------------
+
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Soccer.h"
+#include "LeagueManager.h"
+
+namespace SoccerCommands {
+
+// ------------------------------------------------------------
+// Function: runCommand
+// ------------------------------------------------------------
+// Runs one command given as separate words (e.g. from argv).
+// Data goes to 'out', errors to 'err'. Returns a process exit
+// code: 0 = success, 1 = failed, 2 = bad usage.
+// ------------------------------------------------------------
+int runCommand(Soccer& league, const std::vector<std::string>& args,
+               std::ostream& out, std::ostream& err);
+
+// ------------------------------------------------------------
+// Function: runBatch
+// ------------------------------------------------------------
+// Reads newline-delimited commands from 'in' until end of input.
+// Consecutive update commands are applied together with one log
+// append. Warnings (such as skipped import lines) go to 'err'.
+// Returns 0 if every command succeeded, 1 otherwise.
+// ------------------------------------------------------------
+int runBatch(Soccer& league, std::istream& in, std::ostream& out, std::ostream& err);
+
+// ------------------------------------------------------------
+// Function: runLeagueBatch
+// ------------------------------------------------------------
+// runBatch() over many leagues: the commands after "use NAME" are
+// run as one batch on that league (loaded on demand, see
+// LeagueManager.h). Their answers are printed when the next "use"
+// (or the end of input) arrives. Returns 0 if every command
+// succeeded, 1 otherwise.
+// ------------------------------------------------------------
+int runLeagueBatch(LeagueManager& leagues, std::istream& in, std::ostream& out, std::ostream& err);
+
+} // namespace SoccerCommands
@@ -0,0 +1,256 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerLog.cpp
+// ------------------------------------------------------------
+// The log uses POSIX open()/write() instead of ofstream because
+// it needs two things streams can't do: one write() call per
+// batch (so a batch is never split by buffering) and fdatasync()
+// (so "written" really means "on disk").
+// ------------------------------------------------------------
+
+#include "SoccerLog.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+SoccerLog::SoccerLog(const string& path) : path_(path) {}
+
+SoccerLog::~SoccerLog() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+void SoccerLog::formatDelta(string& out, string_view name, int delta) {
+    char number[16];
+    auto result = to_chars(number, number + sizeof(number), delta);
+
+    out.append(name);
+    out += ',';
+    if (delta >= 0) out += '+';
+    out.append(number, result.ptr);
+    out += '\n';
+}
+
+namespace {
+
+void formatValue(string& out, string_view name, char op, int value) {
+    char number[16];
+    auto result = to_chars(number, number + sizeof(number), value);
+
+    out.append(name);
+    out += ',';
+    out += op;
+    out.append(number, result.ptr);
+    out += '\n';
+}
+
+} // namespace
+
+void SoccerLog::formatSet(string& out, string_view name, int goals) {
+    formatValue(out, name, '=', goals);
+}
+
+void SoccerLog::formatAdd(string& out, string_view name, int goals) {
+    formatValue(out, name, '#', goals);
+}
+
+// ------------------------------------------------------------
+// Function: parseRecord
+// ------------------------------------------------------------
+// The LAST comma separates the name from the value, so records
+// written before validName() refused commas still read back.
+// ------------------------------------------------------------
+bool SoccerLog::parseRecord(string_view line, string_view& name, char& op, int& value) {
+    size_t comma = line.rfind(',');
+    if (comma == string_view::npos || comma + 2 > line.size()) return false;
+
+    op = line[comma + 1];
+    const char* first = line.data() + comma + 2;
+    const char* last = line.data() + line.size();
+    if (op == '-') {
+        --first;                 // from_chars understands "-3" but not "+3"
+        op = '+';                // Either way the result is a delta
+    } else if (op != '+' && op != '=' && op != '#') {
+        return false;
+    }
+
+    auto result = from_chars(first, last, value);
+    if (result.ec != errc() || result.ptr != last) return false;
+
+    name = line.substr(0, comma);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: parseRow
+// ------------------------------------------------------------
+// Accepts what 'stream >> goals' used to: spaces around the
+// number and a leading '+'.
+// ------------------------------------------------------------
+bool SoccerLog::parseRow(string_view line, string_view& name, int& goals) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; };
+
+    size_t comma = line.rfind(',');
+    name = line.substr(0, comma);
+    goals = 0;
+    if (comma == string_view::npos) return true;
+
+    const char* first = line.data() + comma + 1;
+    const char* last = line.data() + line.size();
+    while (first < last && isSpace(*first)) ++first;
+    if (first == last) return true;
+    if (*first == '+' && last - first > 1 && first[1] != '-') ++first;
+
+    auto result = from_chars(first, last, goals);
+    if (result.ec != errc()) return false;
+    for (const char* p = result.ptr; p < last; ++p) {
+        if (!isSpace(*p)) return false;
+    }
+    return true;
+}
+
+bool SoccerLog::validName(string_view name) {
+    return !name.empty() && name.find_first_of(",\n\r") == string_view::npos;
+}
+
+// ------------------------------------------------------------
+// Helper Function: openForAppend
+// ------------------------------------------------------------
+// A crash in the middle of an append can leave a record without
+// its newline at the end of the log. It is cut off here (replay()
+// already ignores it), or the next record would be glued to it.
+// ------------------------------------------------------------
+bool SoccerLog::openForAppend() {
+    if (fd_ >= 0) return true;
+
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        cerr << "Error: Could not open " << path_ << " for appending: " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // Look backwards for the last '\n', one 4 KB piece at a time.
+    struct stat info;
+    if (fstat(fd_, &info) < 0) return true;
+    off_t end = info.st_size;
+    off_t keep = 0;
+    char piece[4096];
+    while (end > 0 && keep == 0) {
+        off_t start = max<off_t>(0, end - off_t(sizeof(piece)));
+        ssize_t got = pread(fd_, piece, size_t(end - start), start);
+        if (got != end - start) return true;   // Leave the log alone if it can't be read
+        for (off_t i = got - 1; i >= 0; --i) {
+            if (piece[i] == '\n') {
+                keep = start + i + 1;
+                break;
+            }
+        }
+        end = start;
+    }
+    if (keep < info.st_size && ftruncate(fd_, keep) < 0) {
+        cerr << "Error: Could not repair " << path_ << ": " << strerror(errno) << "\n";
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: append
+// ------------------------------------------------------------
+// write() may accept fewer bytes than asked (rare for regular
+// files, but allowed), so keep going until everything is written.
+// If that fails, the log is cut back to its old size: the caller
+// doesn't apply the batch, so no part of it may be replayed.
+// ------------------------------------------------------------
+bool SoccerLog::append(string_view records) {
+    if (records.empty()) return true;
+    if (!openForAppend()) return false;
+
+    struct stat info;
+    if (fstat(fd_, &info) < 0) {
+        cerr << "Error: Could not read the size of " << path_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    size_t written = 0;
+    bool ok = true;
+    while (ok && written < records.size()) {
+        ssize_t n = write(fd_, records.data() + written, records.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            cerr << "Error: Could not write to " << path_ << ": " << strerror(errno) << "\n";
+            ok = false;
+        } else {
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    if (ok && syncOnAppend_ && fdatasync(fd_) < 0) {
+        cerr << "Error: Could not sync " << path_ << ": " << strerror(errno) << "\n";
+        ok = false;
+    }
+    if (!ok && ftruncate(fd_, info.st_size) < 0) {
+        cerr << "Error: Could not undo the failed append to " << path_ << ": " << strerror(errno) << "\n";
+    }
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Function: replay
+// Stream used: ifstream (input file stream)
+// ------------------------------------------------------------
+bool SoccerLog::replay(const function<void(string_view, char, int)>& apply) {
+    if (access(path_.c_str(), F_OK) != 0) {
+        return true;            // No log yet: nothing to replay
+    }
+
+    ifstream in(path_);
+    if (!in) {
+        cerr << "Error: Could not open " << path_ << " for reading.\n";
+        return false;
+    }
+
+    string line;
+    while (getline(in, line)) {
+        // A last line without its '\n' is a record that was cut
+        // short; openForAppend() removes it.
+        if (in.eof()) break;
+
+        string_view name;
+        char op;
+        int value;
+        if (!parseRecord(line, name, op, value)) continue;
+
+        apply(name, op, value);
+    }
+    return true;
+}
+
+bool SoccerLog::truncate() {
+    if (::truncate(path_.c_str(), 0) < 0 && errno != ENOENT) {
+        cerr << "Error: Could not empty " << path_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool SoccerLog::empty() const {
+    struct stat info;
+    return stat(path_.c_str(), &info) < 0 || info.st_size == 0;
+}
+
+size_t SoccerLog::size() const {
+    struct stat info;
+    if (stat(path_.c_str(), &info) < 0) return 0;
+    return static_cast<size_t>(info.st_size);
+}
@@ -0,0 +1,132 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerLog.h
+// ------------------------------------------------------------
+// An append-only "update log" that sits next to the data file
+// (soccer.csv → soccer.csv.log).
+//
+// Rewriting all of soccer.csv for every change would be far too
+// slow for a live match feed. Instead, changes are appended to
+// the log as small text records, and the log is replayed on top
+// of soccer.csv when the file is loaded again. A full rewrite of
+// soccer.csv (a "checkpoint") makes the log empty again; Soccer
+// does one once the log is half as big as the file.
+//
+// Record format (one per line, readable with any text editor):
+//
+//     Messi,+2      → Messi scored 2 more goals (a "delta")
+//     Messi,-1      → one goal was taken away
+//     Messi,=13     → Messi's goals were set to 13 (updatePlayer)
+//     Messi,#13     → a new row "Messi,13" was added (addPlayer)
+//
+// Replication (SoccerReplication.h) ships the same records to other
+// processes.
+//
+// Example:
+//   SoccerLog log("soccer.csv.log");
+//   std::string batch;
+//   SoccerLog::formatDelta(batch, "Messi", 1);
+//   log.append(batch);          // one write() for the whole batch
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <functional>
+
+class SoccerLog {
+public:
+    explicit SoccerLog(const std::string& path);
+    ~SoccerLog();
+
+    SoccerLog(const SoccerLog&) = delete;
+    SoccerLog& operator=(const SoccerLog&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: formatDelta
+    // ------------------------------------------------------------
+    // Appends one "Name,+N" record (with its newline) to 'out'.
+    // Build a whole batch this way, then append() it once.
+    // ------------------------------------------------------------
+    static void formatDelta(std::string& out, std::string_view name, int delta);
+
+    // "Name,=N" (set) and "Name,#N" (new row) records, the same way.
+    static void formatSet(std::string& out, std::string_view name, int goals);
+    static void formatAdd(std::string& out, std::string_view name, int goals);
+
+    // ------------------------------------------------------------
+    // Function: parseRecord
+    // ------------------------------------------------------------
+    // Splits one record (without its newline) into the name, the
+    // operation ('+' for a delta, '=' or '#') and the value.
+    // Returns false for a damaged line.
+    // ------------------------------------------------------------
+    static bool parseRecord(std::string_view line, std::string_view& name, char& op, int& value);
+
+    // ------------------------------------------------------------
+    // Function: parseRow
+    // ------------------------------------------------------------
+    // Splits one "Name,Goals" line of a data file the same way:
+    // at the LAST comma, since the number can't contain one. That
+    // keeps older rows with a comma in the name ("Smith, John,5")
+    // readable, but such a name can't be written any more (see
+    // validName), so changing that player fails. No comma, or
+    // nothing after it, means 0 goals. Returns false if anything
+    // other than a number (and spaces) follows the comma.
+    // ------------------------------------------------------------
+    static bool parseRow(std::string_view line, std::string_view& name, int& goals);
+
+    // ------------------------------------------------------------
+    // Function: validName
+    // ------------------------------------------------------------
+    // True if 'name' can be stored: not empty, and no ',' or line
+    // break, which would split it across fields or records (a
+    // record line starting with '!' is a control line for the
+    // replicas, see SoccerReplication.h).
+    // ------------------------------------------------------------
+    static bool validName(std::string_view name);
+
+    // ------------------------------------------------------------
+    // Function: append
+    // ------------------------------------------------------------
+    // Writes already-formatted records to the end of the log with a
+    // single write(). If sync is on (the default) the data is also
+    // flushed to disk (fdatasync) before append() returns. On
+    // failure the log is cut back to where it was.
+    // ------------------------------------------------------------
+    bool append(std::string_view records);
+
+    // ------------------------------------------------------------
+    // Function: replay
+    // ------------------------------------------------------------
+    // Reads the log from the start and calls 'apply' once per
+    // record with the player name, the operation character
+    // ('+', '=' or '#') and the value. Damaged lines are skipped,
+    // and so is a last line without its newline (a record cut
+    // short by a crash; the next append removes it first).
+    // Returns false only if the log exists but can't be read.
+    // ------------------------------------------------------------
+    bool replay(const std::function<void(std::string_view name, char op, int value)>& apply);
+
+    // Empties the log (after a checkpoint made it unnecessary).
+    bool truncate();
+
+    // True if the log has no records (or doesn't exist).
+    bool empty() const;
+
+    // Size of the log in bytes (0 if it doesn't exist).
+    size_t size() const;
+
+    // Turns the fdatasync after each append() on or off.
+    void setSyncOnAppend(bool sync) { syncOnAppend_ = sync; }
+    bool syncOnAppend() const { return syncOnAppend_; }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    int fd_ = -1;
+    bool syncOnAppend_ = true;
+
+    bool openForAppend();
+};
@@ -0,0 +1,133 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerProtocol.cpp
+// ------------------------------------------------------------
+// Encoding and decoding helpers for the binary frame format
+// described in SoccerProtocol.h.
+// ------------------------------------------------------------
+
+#include "SoccerProtocol.h"
+#include <cstring>   // for memcpy
+#include <algorithm> // for min
+using namespace std;
+
+namespace SoccerProtocol {
+
+// ------------------------------------------------------------
+// FrameWriter
+// ------------------------------------------------------------
+// The first 4 bytes are reserved for the length field, then the
+// code and requestId are written straight away.
+// ------------------------------------------------------------
+FrameWriter::FrameWriter(uint8_t code, uint32_t requestId) {
+    buffer_.reserve(64);
+    buffer_.resize(4);
+    putBytes(&code, 1);
+    putU32(requestId);
+}
+
+void FrameWriter::putBytes(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void FrameWriter::putU16(uint16_t value) { putBytes(&value, sizeof(value)); }
+void FrameWriter::putU32(uint32_t value) { putBytes(&value, sizeof(value)); }
+void FrameWriter::putI32(int32_t value) { putBytes(&value, sizeof(value)); }
+
+// Names longer than 65535 bytes are cut short; the u16 length
+// field can't describe anything bigger.
+void FrameWriter::putString(const string& value) {
+    uint16_t size = static_cast<uint16_t>(min<size_t>(value.size(), UINT16_MAX));
+    putU16(size);
+    putBytes(value.data(), size);
+}
+
+void FrameWriter::putPlayers(const vector<pair<string, int>>& players) {
+    putU32(static_cast<uint32_t>(players.size()));
+    for (const auto& p : players) {
+        putString(p.first);
+        putI32(p.second);
+    }
+}
+
+const vector<char>& FrameWriter::finish() {
+    uint32_t length = static_cast<uint32_t>(buffer_.size() - 4);
+    memcpy(buffer_.data(), &length, sizeof(length));
+    return buffer_;
+}
+
+// ------------------------------------------------------------
+// FrameReader
+// ------------------------------------------------------------
+// 'body' points just past the length field. The header is read
+// in the constructor; valid() tells whether it was complete.
+// ------------------------------------------------------------
+FrameReader::FrameReader(const char* body, size_t size) : body_(body), size_(size) {
+    valid_ = getBytes(&code_, 1) && getU32(requestId_);
+}
+
+bool FrameReader::getBytes(void* out, size_t size) {
+    if (size_ - pos_ < size) {
+        return false;
+    }
+    memcpy(out, body_ + pos_, size);
+    pos_ += size;
+    return true;
+}
+
+bool FrameReader::getU16(uint16_t& value) { return getBytes(&value, sizeof(value)); }
+bool FrameReader::getU32(uint32_t& value) { return getBytes(&value, sizeof(value)); }
+bool FrameReader::getI32(int32_t& value) { return getBytes(&value, sizeof(value)); }
+
+bool FrameReader::getString(string& value) {
+    uint16_t size;
+    if (!getU16(size) || size_ - pos_ < size) {
+        return false;
+    }
+    value.assign(body_ + pos_, size);
+    pos_ += size;
+    return true;
+}
+
+bool FrameReader::getPlayers(vector<pair<string, int>>& players) {
+    uint32_t count;
+    if (!getU32(count)) {
+        return false;
+    }
+
+    // Each entry needs at least 6 bytes (u16 + i32), which gives an
+    // upper bound for reserve() that a bad count can't blow past.
+    players.clear();
+    players.reserve(min<size_t>(count, (size_ - pos_) / 6));
+    for (uint32_t i = 0; i < count; ++i) {
+        string name;
+        int32_t goals;
+        if (!getString(name) || !getI32(goals)) {
+            return false;
+        }
+        players.push_back({move(name), goals});
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: nextFrame
+// ------------------------------------------------------------
+long nextFrame(const char* data, size_t size) {
+    if (size < 4) {
+        return 0;
+    }
+
+    uint32_t length;
+    memcpy(&length, data, sizeof(length));
+    if (length < HEADER_SIZE || length > MAX_FRAME_SIZE) {
+        return -1;
+    }
+    if (size - 4 < length) {
+        return 0;
+    }
+    return static_cast<long>(length) + 4;
+}
+
+} // namespace SoccerProtocol
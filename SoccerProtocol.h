@@ -0,0 +1,162 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerProtocol.h
+// ------------------------------------------------------------
+// The binary message format spoken between the Soccer server
+// (SoccerServer.h) and its clients.
+//
+// Every message is one "frame":
+//
+//     +------------+----------+---------------+-----------+
+//     | u32 length | u8 code  | u32 requestId |  payload  |
+//     +------------+----------+---------------+-----------+
+//
+//   - length    → number of bytes AFTER the length field
+//   - code      → an Opcode (requests) or a Status (responses)
+//   - requestId → chosen by the client and copied into the reply,
+//                 so replies can be matched to requests even when
+//                 they come back in a different order
+//
+// Payload building blocks:
+//   - string → u16 byte count followed by the bytes (no '\0')
+//   - int    → i32
+//   - list   → u32 count followed by (string name, i32 goals) pairs
+//
+// Numbers are sent in the machine's own byte order. Both ends of
+// a Unix domain socket are always on the same machine, so there
+// is nothing to convert.
+// ------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace SoccerProtocol {
+
+// Header size after the length field: code + requestId
+constexpr uint32_t HEADER_SIZE = 1 + 4;
+
+// Frames bigger than this are treated as a broken connection.
+constexpr uint32_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+// ------------------------------------------------------------
+// Request codes and their payloads
+// ------------------------------------------------------------
+//   VIEW   → (none)              reply: list of every player
+//   GET    → string name         reply: i32 goals (or NOT_FOUND)
+//   ADD    → string name, i32    reply: (none)
+//   UPDATE → string name, i32    reply: (none)
+//   TOP    → u32 n               reply: list of the n best scorers
+//   UPDATE_BATCH → list          reply: (none)
+//                 (many updates in one frame, one log append)
+//   COUNT  → i32 min, i32 max    reply: u32 players with min..max goals
+//   STATS  → (none)              reply: list of (counter name, value)
+//                 (e.g. replication lag, see SoccerReplication.h)
+//
+// A read-only server (a replica) answers ADD, UPDATE and
+// UPDATE_BATCH with READ_ONLY.
+// A name that SoccerLog::validName() refuses (empty, or with ','
+// or a line break) gets BAD_REQUEST; a batch with one such name
+// is refused as a whole. A write the server could not make (no
+// team file, or the file or update log can't be written) gets
+// WRITE_FAILED.
+// ------------------------------------------------------------
+enum Opcode : uint8_t {
+    VIEW         = 1,
+    GET          = 2,
+    ADD          = 3,
+    UPDATE       = 4,
+    TOP          = 5,
+    UPDATE_BATCH = 6,
+    COUNT        = 7,
+    STATS        = 8
+};
+
+enum Status : uint8_t {
+    OK           = 0,
+    NOT_FOUND    = 1,
+    BAD_REQUEST  = 2,
+    READ_ONLY    = 3,
+    WRITE_FAILED = 4
+};
+
+// ------------------------------------------------------------
+// Class: FrameWriter
+// ------------------------------------------------------------
+// Builds one frame in a byte buffer. The length field is filled
+// in by finish(), once the payload size is known.
+//
+// Example:
+//   FrameWriter w(SoccerProtocol::ADD, 7);
+//   w.putString("Messi");
+//   w.putI32(13);
+//   send(fd, w.finish().data(), ...);
+// ------------------------------------------------------------
+class FrameWriter {
+public:
+    FrameWriter(uint8_t code, uint32_t requestId);
+
+    void putU16(uint16_t value);
+    void putU32(uint32_t value);
+    void putI32(int32_t value);
+    void putString(const std::string& value);
+    void putPlayers(const std::vector<std::pair<std::string, int>>& players);
+
+    // Writes the length field and returns the finished frame.
+    const std::vector<char>& finish();
+
+private:
+    std::vector<char> buffer_;
+
+    void putBytes(const void* data, size_t size);
+};
+
+// ------------------------------------------------------------
+// Class: FrameReader
+// ------------------------------------------------------------
+// Reads values back out of one frame body (everything after the
+// length field). Every get function returns false instead of
+// reading past the end, so a malformed frame can't crash the reader.
+// ------------------------------------------------------------
+class FrameReader {
+public:
+    FrameReader(const char* body, size_t size);
+
+    uint8_t code() const { return code_; }
+    uint32_t requestId() const { return requestId_; }
+    bool valid() const { return valid_; }
+    bool atEnd() const { return pos_ == size_; }
+
+    bool getU16(uint16_t& value);
+    bool getU32(uint32_t& value);
+    bool getI32(int32_t& value);
+    bool getString(std::string& value);
+    bool getPlayers(std::vector<std::pair<std::string, int>>& players);
+
+private:
+    const char* body_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint8_t code_ = 0;
+    uint32_t requestId_ = 0;
+    bool valid_ = false;
+
+    bool getBytes(void* out, size_t size);
+};
+
+// ------------------------------------------------------------
+// Function: nextFrame
+// ------------------------------------------------------------
+// Looks at the start of a receive buffer and reports whether a
+// complete frame is available.
+//
+// Returns:
+//   > 0 → total size of the first frame (length field included)
+//     0 → need more bytes
+//   < 0 → the length field is impossible (close the connection)
+// ------------------------------------------------------------
+long nextFrame(const char* data, size_t size);
+
+} // namespace SoccerProtocol
@@ -0,0 +1,419 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerReplication.cpp
+// ------------------------------------------------------------
+// Ships a league's changes from a primary to its replicas (see
+// SoccerReplication.h).
+//
+// Locking: the primary's feed() runs under the league's writer
+// lock and then takes mutex_, and addReplica() holds the league's
+// reader lock while it takes mutex_ – always league first. The
+// sender threads only ever take mutex_.
+// ------------------------------------------------------------
+
+#include "SoccerReplication.h"
+#include "SoccerLog.h"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+namespace {
+
+// How long a replica may refuse data before it is dropped.
+constexpr int SEND_TIMEOUT_MS = 5000;
+
+int64_t nowMs() {
+    using namespace chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// "!B 42 1718000000123\n" and friends.
+string controlLine(char kind, uint64_t sequence, int64_t ms) {
+    return string("!") + kind + ' ' + to_string(sequence) + ' ' + to_string(ms) + '\n';
+}
+
+bool fillAddress(const string& socketPath, sockaddr_un& addr) {
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        cerr << "Error: Socket path is too long: " << socketPath << "\n";
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath.c_str());
+    return true;
+}
+
+// ------------------------------------------------------------
+// Helper Function: sendAll
+// ------------------------------------------------------------
+// The fd is non-blocking, so a full pipe or socket buffer makes
+// write() fail with EAGAIN; poll() then waits until there is room
+// again – but only for SEND_TIMEOUT_MS.
+// ------------------------------------------------------------
+bool sendAll(int fd, string_view data) {
+    while (!data.empty()) {
+        ssize_t n = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n < 0 && errno == ENOTSOCK) n = write(fd, data.data(), data.size());   // A pipe
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd p{fd, POLLOUT, 0};
+            if (poll(&p, 1, SEND_TIMEOUT_MS) <= 0) return false;
+            continue;
+        }
+        if (n < 0) return false;
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
+
+// Reads "<number>" from the front of 'text' and skips one space after it.
+uint64_t takeNumber(string_view& text) {
+    uint64_t value = 0;
+    auto result = from_chars(text.data(), text.data() + text.size(), value);
+    text.remove_prefix(result.ptr - text.data());
+    if (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    return value;
+}
+
+} // namespace
+
+// ============================================================
+// ReplicationPrimary
+// ============================================================
+
+ReplicationPrimary::ReplicationPrimary(Soccer& league, size_t maxQueuedBytes)
+    : league_(league), maxQueuedBytes_(maxQueuedBytes) {
+    league_.setChangeFeed([this](string_view records) { feed(records); });
+}
+
+ReplicationPrimary::~ReplicationPrimary() {
+    stop();
+}
+
+// ------------------------------------------------------------
+// Function: listen
+// ------------------------------------------------------------
+bool ReplicationPrimary::listen(const string& socketPath) {
+    sockaddr_un addr{};
+    if (!fillAddress(socketPath, addr)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    unlink(socketPath.c_str());   // Left behind by an earlier run
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(fd, SOMAXCONN) < 0) {
+        cerr << "Error: Could not listen on " << socketPath << ": " << strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    listenFd_ = fd;
+    socketPath_ = socketPath;
+    acceptor_ = thread(&ReplicationPrimary::acceptLoop, this);
+    return true;
+}
+
+// shutdown() in stop() makes accept() fail, which ends the loop.
+void ReplicationPrimary::acceptLoop() {
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0 && errno == EINTR) continue;
+        if (fd < 0) break;
+        addReplica(fd);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: addReplica
+// ------------------------------------------------------------
+// Steps:
+//   1. Hold the league's reader lock (records()) while copying the
+//      table: no change can happen until the replica is registered,
+//      so every change is either in the copy or in its queue – never
+//      both, never neither.
+//   2. Queue "!S", the copy and a "!B" for the current batch, then
+//      start the replica's sender thread.
+// ------------------------------------------------------------
+bool ReplicationPrimary::addReplica(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    auto replica = make_shared<Replica>();
+    replica->fd = fd;
+
+    auto rows = league_.records();
+    string copy;
+    for (PlayerRecord row : rows) {
+        SoccerLog::formatAdd(copy, row.name, row.goals);
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    if (stopping_) {
+        close(fd);
+        return false;
+    }
+    replica->queued = "!S " + to_string(sequence_) + '\n' + copy + controlLine('B', sequence_, nowMs());
+    replicas_.push_back(replica);
+    replica->sender = thread(&ReplicationPrimary::sendLoop, this, replica);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Helper Function: feed
+// ------------------------------------------------------------
+// Runs under the league's writer lock, so it only appends to the
+// queues; the sender threads do the writing.
+// ------------------------------------------------------------
+void ReplicationPrimary::feed(string_view records) {
+    lock_guard<mutex> lock(mutex_);
+    string marker = controlLine('B', ++sequence_, nowMs());
+
+    for (auto& replica : replicas_) {
+        if (replica->closed) continue;
+        if (replica->queued.size() + records.size() > maxQueuedBytes_) {
+            replica->closed = true;    // Too far behind to catch up
+            replica->queued.clear();
+            ++dropped_;
+            continue;
+        }
+        replica->queued.append(records);
+        replica->queued += marker;
+    }
+    wake_.notify_all();
+}
+
+// ------------------------------------------------------------
+// Helper Function: sendLoop
+// ------------------------------------------------------------
+// Sends whatever is queued, all at once; after a second with
+// nothing to send, a heartbeat. When stopping, the queue is sent
+// one last time before the connection is closed.
+// ------------------------------------------------------------
+void ReplicationPrimary::sendLoop(shared_ptr<Replica> replica) {
+    unique_lock<mutex> lock(mutex_);
+    while (!replica->closed) {
+        wake_.wait_for(lock, chrono::seconds(1),
+                       [&] { return stopping_ || replica->closed || !replica->queued.empty(); });
+        if (replica->closed || (stopping_ && replica->queued.empty())) break;
+
+        string out;
+        if (replica->queued.empty()) {
+            out = controlLine('H', sequence_, nowMs());
+        } else {
+            out.swap(replica->queued);
+        }
+
+        lock.unlock();
+        bool sent = sendAll(replica->fd, out);
+        lock.lock();
+
+        if (!sent) {
+            if (!replica->closed) ++dropped_;
+            replica->closed = true;
+            replica->queued.clear();
+        }
+    }
+    replica->closed = true;
+    close(replica->fd);
+}
+
+// ------------------------------------------------------------
+// Function: stop
+// ------------------------------------------------------------
+void ReplicationPrimary::stop() {
+    league_.setChangeFeed(nullptr);   // After this, feed() is never called again
+
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    if (listenFd_ >= 0) {
+        shutdown(listenFd_, SHUT_RDWR);
+        acceptor_.join();
+        close(listenFd_);
+        listenFd_ = -1;
+        unlink(socketPath_.c_str());
+    }
+
+    vector<shared_ptr<Replica>> replicas;
+    {
+        lock_guard<mutex> lock(mutex_);
+        replicas = replicas_;    // The acceptor has finished adding
+    }
+    for (auto& replica : replicas) {
+        replica->sender.join();
+    }
+}
+
+// ------------------------------------------------------------
+// Function: stats
+// ------------------------------------------------------------
+ReplicationPrimaryStats ReplicationPrimary::stats() const {
+    lock_guard<mutex> lock(mutex_);
+    ReplicationPrimaryStats s;
+    s.sequence = sequence_;
+    s.dropped = dropped_;
+    for (const auto& replica : replicas_) {
+        if (replica->closed) continue;
+        ++s.replicas;
+        s.queuedBytes += replica->queued.size();
+    }
+    return s;
+}
+
+// ============================================================
+// ReplicationReplica
+// ============================================================
+
+ReplicationReplica::ReplicationReplica(Soccer& league) : league_(league) {}
+
+ReplicationReplica::~ReplicationReplica() {
+    stop();
+}
+
+// ------------------------------------------------------------
+// Function: connect / attach
+// ------------------------------------------------------------
+bool ReplicationReplica::connect(const string& socketPath) {
+    sockaddr_un addr{};
+    if (!fillAddress(socketPath, addr)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        cerr << "Error: Could not connect to " << socketPath << ": " << strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    return attach(fd);
+}
+
+bool ReplicationReplica::attach(int fd) {
+    if (fd_ >= 0) {
+        cerr << "Error: This replica is already following a primary.\n";
+        close(fd);
+        return false;
+    }
+
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        cerr << "Error: Could not create eventfd: " << strerror(errno) << "\n";
+        close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    {
+        lock_guard<mutex> lock(mutex_);
+        stats_.connected = true;
+        lastHeardMs_ = nowMs();
+    }
+    reader_ = thread(&ReplicationReplica::readLoop, this);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Helper Function: readLoop
+// ------------------------------------------------------------
+// Every read() may end in the middle of a line or of a batch, so
+// records are collected until their "!B" line. All batches that
+// are complete after one read() are applied together: one log
+// append instead of one per batch, which lets a replica that has
+// fallen behind catch up quickly.
+// ------------------------------------------------------------
+void ReplicationReplica::readLoop() {
+    string input;      // Bytes read but not yet cut into lines
+    string batch;      // Records of the batch still being received
+    string complete;   // Records of finished batches, not yet applied
+    char buffer[65536];
+
+    while (true) {
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;   // stop()
+
+        ssize_t n = read(fd_, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;           // The primary went away
+        input.append(buffer, static_cast<size_t>(n));
+
+        uint64_t sequence = 0;
+        uint64_t announced = 0;
+        int64_t madeMs = 0;
+        size_t start = 0;
+        size_t end;
+        while ((end = input.find('\n', start)) != string::npos) {
+            string_view line(input.data() + start, end - start);
+            start = end + 1;
+
+            if (line.size() < 2 || line[0] != '!' || line.find(',') != string_view::npos) {
+                batch.append(line);
+                batch += '\n';
+                continue;
+            }
+
+            char kind = line[1];
+            line.remove_prefix(min<size_t>(3, line.size()));
+            uint64_t number = takeNumber(line);
+            if (kind == 'B') {
+                complete += batch;
+                batch.clear();
+                sequence = announced = number;
+                madeMs = static_cast<int64_t>(takeNumber(line));
+            } else if (kind == 'H') {
+                announced = number;
+            }
+        }
+        input.erase(0, start);
+
+        size_t applied = complete.empty() ? 0 : league_.applyRecords(complete);
+        complete.clear();
+
+        lock_guard<mutex> lock(mutex_);
+        lastHeardMs_ = nowMs();
+        if (madeMs != 0) {
+            stats_.appliedSequence = sequence;
+            stats_.lagMs = lastHeardMs_ - madeMs;
+        }
+        stats_.primarySequence = max(stats_.primarySequence, announced);
+        stats_.appliedRecords += applied;
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    stats_.connected = false;
+}
+
+// ------------------------------------------------------------
+// Function: stop
+// ------------------------------------------------------------
+void ReplicationReplica::stop() {
+    if (fd_ < 0) return;
+
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+    (void)ignored;
+    reader_.join();
+    close(fd_);
+    close(wakeFd_);
+    fd_ = wakeFd_ = -1;
+}
+
+// ------------------------------------------------------------
+// Function: stats
+// ------------------------------------------------------------
+ReplicaStats ReplicationReplica::stats() const {
+    lock_guard<mutex> lock(mutex_);
+    ReplicaStats s = stats_;
+    s.silentMs = nowMs() - lastHeardMs_;
+    return s;
+}
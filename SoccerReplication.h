@@ -0,0 +1,184 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerReplication.h
+// ------------------------------------------------------------
+// Primary / replica copies of one league, for spreading reads
+// over several processes.
+//
+// The primary is the only league that takes writes. Every change
+// it makes is turned into update records (see SoccerLog.h) by its
+// change feed (Soccer::setChangeFeed) and shipped to each replica
+// over a socket or pipe. Replicas apply the records in the same
+// order (Soccer::applyRecords) and answer reads only.
+//
+// The stream is plain text, one line each:
+//
+//     !S 41           → a full copy follows, as of change batch 41
+//     Messi,#12       → records (only these lines contain a comma)
+//     Messi,+1
+//     !B 42 1718000000123   → batch 42 is complete; it was made on
+//                             the primary at that time (ms)
+//     !H 42 1718000001123   → heartbeat: nothing new since batch 42
+//
+// A new replica is first sent every row of the table ("!S" and one
+// "#" record per row), then each batch as it happens.
+//
+// Shipping is asynchronous: a write on the primary only appends the
+// records to each replica's queue (under the table's writer lock,
+// which keeps the order) and returns; one thread per replica sends
+// them. A replica is therefore always a little behind, and
+// ReplicaStats says by how much.
+//
+// Limits: a replica that falls too far behind (its queue passes
+// 'maxQueuedBytes') or stops reading is dropped, and a replica whose
+// connection is lost keeps serving its last state. Either way it has
+// to be restarted to catch up again.
+//
+// Example:
+//   Soccer primary("soccer.csv");
+//   ReplicationPrimary shipping(primary);
+//   shipping.listen("/tmp/soccer-repl.sock");
+//
+//   Soccer copy("replica.csv");            // another process, empty file
+//   ReplicationReplica replica(copy);
+//   replica.connect("/tmp/soccer-repl.sock");
+// ------------------------------------------------------------
+
+#pragma once
+#include "Soccer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------
+// Struct: ReplicationPrimaryStats
+// ------------------------------------------------------------
+//   sequence    → change batches fed to the replicas so far
+//   replicas    → replicas currently connected
+//   queuedBytes → records waiting to be sent, over all replicas
+//   dropped     → replicas dropped (too slow or gone)
+// ------------------------------------------------------------
+struct ReplicationPrimaryStats {
+    uint64_t sequence = 0;
+    size_t replicas = 0;
+    size_t queuedBytes = 0;
+    uint64_t dropped = 0;
+};
+
+// ------------------------------------------------------------
+// Struct: ReplicaStats
+// ------------------------------------------------------------
+//   connected        → the stream from the primary is still open
+//   appliedSequence  → the last batch applied here
+//   primarySequence  → the newest batch the primary has announced
+//   appliedRecords   → records applied since start-up
+//   lagMs            → how long the last batch took from being made
+//                      on the primary to being applied here
+//   silentMs         → time since anything arrived (heartbeats come
+//                      every second, so more than that is trouble)
+// ------------------------------------------------------------
+struct ReplicaStats {
+    bool connected = false;
+    uint64_t appliedSequence = 0;
+    uint64_t primarySequence = 0;
+    uint64_t appliedRecords = 0;
+    int64_t lagMs = 0;
+    int64_t silentMs = 0;
+};
+
+class ReplicationPrimary {
+public:
+    // ------------------------------------------------------------
+    // Constructor
+    // ------------------------------------------------------------
+    // Installs the change feed on 'league' (which must outlive this
+    // object). Changes made before a replica connects reach it as
+    // part of its full copy.
+    // ------------------------------------------------------------
+    explicit ReplicationPrimary(Soccer& league, size_t maxQueuedBytes = 64u << 20);
+    ~ReplicationPrimary();
+
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    // Accepts replicas on a Unix domain socket (on a background thread).
+    bool listen(const std::string& socketPath);
+
+    // Starts shipping to an already open pipe or socket (write end),
+    // which this object then owns.
+    bool addReplica(int fd);
+
+    // Sends what is still queued (giving up on a replica that doesn't
+    // take it within a few seconds), then disconnects every replica.
+    void stop();
+
+    ReplicationPrimaryStats stats() const;
+
+private:
+    struct Replica {
+        int fd = -1;
+        std::string queued;      // Bytes waiting to be sent
+        bool closed = false;
+        std::thread sender;
+    };
+
+    Soccer& league_;
+    size_t maxQueuedBytes_;
+
+    mutable std::mutex mutex_;   // Protects everything below (taken after the league's lock)
+    std::condition_variable wake_;
+    std::vector<std::shared_ptr<Replica>> replicas_;
+    uint64_t sequence_ = 0;
+    uint64_t dropped_ = 0;
+    bool stopping_ = false;
+
+    int listenFd_ = -1;
+    std::string socketPath_;
+    std::thread acceptor_;
+
+    void feed(std::string_view records);   // The league's change feed
+    void acceptLoop();
+    void sendLoop(std::shared_ptr<Replica> replica);
+};
+
+class ReplicationReplica {
+public:
+    // 'league' should start empty; it becomes a copy of the primary.
+    explicit ReplicationReplica(Soccer& league);
+    ~ReplicationReplica();
+
+    ReplicationReplica(const ReplicationReplica&) = delete;
+    ReplicationReplica& operator=(const ReplicationReplica&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: connect / attach
+    // ------------------------------------------------------------
+    // Start reading the primary's stream on a background thread,
+    // from a Unix socket or from an open pipe/socket (read end,
+    // then owned by this object). Only one stream per replica.
+    // ------------------------------------------------------------
+    bool connect(const std::string& socketPath);
+    bool attach(int fd);
+
+    void stop();
+
+    ReplicaStats stats() const;
+
+private:
+    Soccer& league_;
+    int fd_ = -1;
+    int wakeFd_ = -1;            // eventfd used by stop()
+    std::thread reader_;
+
+    mutable std::mutex mutex_;   // Protects the two fields below
+    ReplicaStats stats_;
+    int64_t lastHeardMs_ = 0;
+
+    void readLoop();
+};
@@ -0,0 +1,646 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerServer.cpp
+// ------------------------------------------------------------
+// The epoll event loop and worker pool for SoccerServer.
+//
+// The sockets are non-blocking: read() and write() never wait.
+// If a socket has nothing to read (or no room to write) they
+// return EAGAIN, and epoll tells us when to try again.
+// ------------------------------------------------------------
+
+#include "SoccerServer.h"
+#include "SoccerProtocol.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+using namespace std;
+
+namespace {
+
+// Marks which kind of file descriptor an epoll event belongs to.
+// Client sockets use their own fd number, which is never negative.
+constexpr int LISTEN_TAG = -1;
+constexpr int WAKE_TAG = -2;
+constexpr int DONE_TAG = -3;
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr int MAX_EVENTS = 128;
+
+} // namespace
+
+// ------------------------------------------------------------
+// Constructor / Destructor
+// ------------------------------------------------------------
+SoccerServer::SoccerServer(Soccer& league, const string& socketPath, unsigned workers)
+    : league_(league), socketPath_(socketPath), workerCount_(workers) {
+    if (workerCount_ == 0) {
+        workerCount_ = max(1u, thread::hardware_concurrency());
+    }
+}
+
+SoccerServer::~SoccerServer() {
+    shutdownAll();
+}
+
+// ------------------------------------------------------------
+// Function: openSocket
+// ------------------------------------------------------------
+// Creates the listening socket, the epoll instance and the
+// eventfds used to wake the loop up from stop() and from workers
+// that finished a half-closed connection.
+// ------------------------------------------------------------
+bool SoccerServer::openSocket() {
+    sockaddr_un addr{};
+    if (socketPath_.size() >= sizeof(addr.sun_path)) {
+        cerr << "Error: Socket path is too long: " << socketPath_ << "\n";
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath_.c_str());
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        cerr << "Error: Could not create socket: " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // A socket file left behind by an earlier run would make bind() fail.
+    unlink(socketPath_.c_str());
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd_, SOMAXCONN) < 0) {
+        cerr << "Error: Could not listen on " << socketPath_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    doneFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0 || doneFd_ < 0) {
+        cerr << "Error: Could not create epoll/eventfd: " << strerror(errno) << "\n";
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = LISTEN_TAG;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &ev);
+
+    ev.data.fd = WAKE_TAG;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+
+    ev.data.fd = DONE_TAG;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, doneFd_, &ev);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: run
+// ------------------------------------------------------------
+// The event loop. Each pass waits for sockets that are ready
+// and handles them; the loop ends when stop() writes to wakeFd_.
+// ------------------------------------------------------------
+bool SoccerServer::run() {
+    if (!openSocket()) {
+        shutdownAll();
+        return false;
+    }
+
+    running_ = true;
+    for (unsigned i = 0; i < workerCount_; ++i) {
+        workers_.emplace_back(&SoccerServer::workerLoop, this);
+    }
+
+    epoll_event events[MAX_EVENTS];
+    while (running_) {
+        int count = epoll_wait(epollFd_, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;   // Interrupted by a signal; try again
+            cerr << "Error: epoll_wait failed: " << strerror(errno) << "\n";
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int tag = events[i].data.fd;
+
+            if (tag == WAKE_TAG) {
+                running_ = false;
+                continue;
+            }
+            if (tag == LISTEN_TAG) {
+                acceptClients();
+                continue;
+            }
+            if (tag == DONE_TAG) {
+                closeAnswered();
+                continue;
+            }
+
+            auto it = connections_.find(tag);
+            if (it == connections_.end()) continue;
+            shared_ptr<Connection> conn = it->second;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(conn);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flushOutput(conn);
+            }
+            if (events[i].events & EPOLLIN) {
+                readFromClient(conn);
+            }
+        }
+    }
+
+    shutdownAll();
+    return true;
+}
+
+void SoccerServer::stop() {
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void SoccerServer::setStatsSource(function<vector<pair<string, int>>()> source) {
+    statsSource_ = move(source);
+}
+
+// ------------------------------------------------------------
+// Function: acceptClients
+// ------------------------------------------------------------
+// Accepts every waiting connection (there may be several) and
+// registers each one with epoll.
+// ------------------------------------------------------------
+void SoccerServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                cerr << "Error: accept failed: " << strerror(errno) << "\n";
+            }
+            return;
+        }
+
+        auto conn = make_shared<Connection>();
+        conn->fd = fd;
+        connections_[fd] = conn;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: readFromClient
+// ------------------------------------------------------------
+// Reads everything currently available, then cuts off every
+// complete frame and queues it for the workers. Bytes from a
+// half-received frame stay in conn->input until next time.
+// ------------------------------------------------------------
+void SoccerServer::readFromClient(const shared_ptr<Connection>& conn) {
+    bool peerClosed = false;
+    char chunk[READ_CHUNK];
+
+    while (true) {
+        ssize_t n = read(conn->fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            conn->input.insert(conn->input.end(), chunk, chunk + n);
+            continue;
+        }
+        if (n == 0) {
+            peerClosed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeConnection(conn);      // Broken socket: no reply can arrive
+            return;
+        }
+        break;
+    }
+
+    // Cut complete frames off the front of the buffer.
+    vector<vector<char>> frames;
+    size_t offset = 0;
+    while (true) {
+        long frameSize = SoccerProtocol::nextFrame(conn->input.data() + offset,
+                                                   conn->input.size() - offset);
+        if (frameSize < 0) {
+            closeConnection(conn);      // Garbage length: drop the client
+            return;
+        }
+        if (frameSize == 0) break;
+
+        const char* frameStart = conn->input.data() + offset;
+        frames.emplace_back(frameStart + 4, frameStart + frameSize);
+        offset += static_cast<size_t>(frameSize);
+    }
+    conn->input.erase(conn->input.begin(), conn->input.begin() + offset);
+
+    if (!frames.empty()) {
+        queueRequests(conn, frames);
+    }
+
+    // The client may only have shut down its sending side (e.g.
+    // "nc -N") and still be waiting for the answers. Stop reading,
+    // and close once every queued request is answered and sent:
+    // right away if nothing is queued, otherwise when the worker
+    // is done (closeAnswered) or the last reply leaves (flushOutput).
+    if (peerClosed) {
+        {
+            lock_guard<mutex> lock(conn->requestMutex);
+            conn->peerDone = true;
+        }
+        {
+            lock_guard<mutex> lock(conn->outputMutex);
+            conn->wantRead = false;
+            if (conn->fd >= 0) updateInterest(*conn);
+        }
+        closeIfAnswered(conn);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: closeIfAnswered / closeAnswered
+// ------------------------------------------------------------
+// Closes a connection whose client has shut down once no request
+// is queued or being served and every reply has been sent.
+// closeAnswered() runs when a worker signals doneFd_.
+// ------------------------------------------------------------
+void SoccerServer::closeIfAnswered(const shared_ptr<Connection>& conn) {
+    {
+        lock_guard<mutex> lock(conn->requestMutex);
+        if (!conn->peerDone || conn->scheduled) return;
+    }
+    {
+        lock_guard<mutex> lock(conn->outputMutex);
+        if (!conn->closed && !conn->output.empty()) return;   // flushOutput() comes back
+    }
+    closeConnection(conn);
+}
+
+void SoccerServer::closeAnswered() {
+    uint64_t count;
+    ssize_t ignored = read(doneFd_, &count, sizeof(count));
+    (void)ignored;
+
+    vector<shared_ptr<Connection>> done;
+    {
+        lock_guard<mutex> lock(doneMutex_);
+        done.swap(done_);
+    }
+    for (const auto& conn : done) {
+        closeIfAnswered(conn);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: flushOutput
+// ------------------------------------------------------------
+// Called by the event loop when a socket becomes writable again.
+// ------------------------------------------------------------
+void SoccerServer::flushOutput(const shared_ptr<Connection>& conn) {
+    {
+        lock_guard<mutex> lock(conn->outputMutex);
+        if (conn->closed) return;
+
+        if (!writePending(*conn)) {
+            conn->closed = true;
+            return;     // The event loop notices the error event and cleans up
+        }
+        if (!conn->output.empty()) return;
+        setWriteInterest(*conn, false);
+    }
+    closeIfAnswered(conn);      // The last reply to a half-closed client
+}
+
+// ------------------------------------------------------------
+// Function: closeConnection
+// ------------------------------------------------------------
+// Closes the socket under the output lock so no worker can be
+// writing to the same fd number while it is being reused.
+// ------------------------------------------------------------
+void SoccerServer::closeConnection(const shared_ptr<Connection>& conn) {
+    {
+        lock_guard<mutex> lock(conn->outputMutex);
+        if (conn->fd >= 0) {
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, conn->fd, nullptr);
+            close(conn->fd);
+            connections_.erase(conn->fd);
+            conn->fd = -1;
+        }
+        conn->closed = true;
+        conn->output.clear();
+    }
+}
+
+// ------------------------------------------------------------
+// Function: queueRequests
+// ------------------------------------------------------------
+// Adds frames to the connection's own request queue. If no worker
+// is looking after this connection yet, the connection itself is
+// put on the ready list.
+// ------------------------------------------------------------
+void SoccerServer::queueRequests(const shared_ptr<Connection>& conn, vector<vector<char>>& frames) {
+    bool schedule = false;
+    {
+        lock_guard<mutex> lock(conn->requestMutex);
+        for (auto& frame : frames) {
+            conn->requests.push_back(move(frame));
+        }
+        if (!conn->scheduled) {
+            conn->scheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        {
+            lock_guard<mutex> lock(readyMutex_);
+            ready_.push_back(conn);
+        }
+        readyCond_.notify_one();
+    }
+}
+
+// ------------------------------------------------------------
+// Function: workerLoop
+// ------------------------------------------------------------
+// Each worker takes one connection from the ready list and answers
+// its requests in the order they arrived. Only one worker serves a
+// connection at a time, so "update, then get" on the same connection
+// always sees the update. Different connections run in parallel.
+//
+// After REQUESTS_PER_TURN requests the connection goes to the back
+// of the ready list, so one very busy client can't starve the rest.
+// ------------------------------------------------------------
+void SoccerServer::workerLoop() {
+    constexpr int REQUESTS_PER_TURN = 64;
+
+    while (true) {
+        shared_ptr<Connection> conn;
+        {
+            unique_lock<mutex> lock(readyMutex_);
+            readyCond_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+            if (ready_.empty()) return;      // Only happens when stopping
+            conn = move(ready_.front());
+            ready_.pop_front();
+        }
+
+        for (int handled = 0; ; ++handled) {
+            vector<char> frame;
+            {
+                lock_guard<mutex> lock(conn->requestMutex);
+                if (conn->requests.empty()) {
+                    conn->scheduled = false;
+                    if (conn->peerDone) {
+                        {
+                            lock_guard<mutex> doneLock(doneMutex_);
+                            done_.push_back(conn);
+                        }
+                        uint64_t one = 1;
+                        ssize_t ignored = write(doneFd_, &one, sizeof(one));
+                        (void)ignored;
+                    }
+                    break;
+                }
+                if (handled == REQUESTS_PER_TURN) {
+                    lock_guard<mutex> readyLock(readyMutex_);
+                    ready_.push_back(conn);      // Still scheduled; come back later
+                    readyCond_.notify_one();
+                    break;
+                }
+                frame = move(conn->requests.front());
+                conn->requests.pop_front();
+            }
+
+            vector<char> reply = handleRequest(frame);
+            sendReply(conn, reply);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// Function: handleRequest
+// ------------------------------------------------------------
+// Decodes one request frame, calls the Soccer object and
+// returns the encoded reply frame.
+// ------------------------------------------------------------
+vector<char> SoccerServer::handleRequest(const vector<char>& frame) {
+    using namespace SoccerProtocol;
+
+    FrameReader in(frame.data(), frame.size());
+    uint32_t id = in.requestId();
+
+    auto status = [id](Status s) {
+        FrameWriter out(s, id);
+        return out.finish();
+    };
+
+    if (!in.valid()) {
+        return status(BAD_REQUEST);
+    }
+
+    switch (in.code()) {
+        case VIEW: {
+            FrameWriter out(OK, id);
+            out.putPlayers(league_.getPlayers());
+            return out.finish();
+        }
+
+        case GET: {
+            string name;
+            int goals;
+            if (!in.getString(name) || !in.atEnd()) return status(BAD_REQUEST);
+            bool found = updates_ ? updates_->find(name, goals) : league_.findPlayer(name, goals);
+            if (!found) return status(NOT_FOUND);
+
+            FrameWriter out(OK, id);
+            out.putI32(goals);
+            return out.finish();
+        }
+
+        case ADD:
+        case UPDATE: {
+            if (readOnly_) return status(READ_ONLY);
+            string name;
+            int32_t goals;
+            if (!in.getString(name) || !in.getI32(goals) || !in.atEnd() ||
+                !SoccerLog::validName(name)) {
+                return status(BAD_REQUEST);
+            }
+
+            // Through the update buffer, an UPDATE is only accepted
+            // here; it is written (and can fail) later.
+            bool written = true;
+            if (in.code() == ADD) {
+                written = updates_ ? updates_->addPlayer(name, goals) : league_.addPlayer(name, goals);
+            } else {
+                if (updates_) updates_->update(name, goals);
+                else written = league_.updatePlayer(name, goals);
+            }
+            return status(written ? OK : WRITE_FAILED);
+        }
+
+        case TOP: {
+            uint32_t n;
+            if (!in.getU32(n) || !in.atEnd()) return status(BAD_REQUEST);
+
+            FrameWriter out(OK, id);
+            out.putPlayers(league_.topPlayers(n));
+            return out.finish();
+        }
+
+        case COUNT: {
+            int32_t minGoals, maxGoals;
+            if (!in.getI32(minGoals) || !in.getI32(maxGoals) || !in.atEnd()) {
+                return status(BAD_REQUEST);
+            }
+
+            FrameWriter out(OK, id);
+            out.putU32(static_cast<uint32_t>(league_.countPlayers(minGoals, maxGoals)));
+            return out.finish();
+        }
+
+        case UPDATE_BATCH: {
+            if (readOnly_) return status(READ_ONLY);
+            vector<pair<string, int>> updates;
+            if (!in.getPlayers(updates) || !in.atEnd()) return status(BAD_REQUEST);
+            for (const auto& u : updates) {
+                if (!SoccerLog::validName(u.first)) return status(BAD_REQUEST);   // None applied
+            }
+
+            bool written = true;
+            if (updates_) updates_->updateMany(updates);
+            else written = league_.updatePlayers(updates);
+            return status(written ? OK : WRITE_FAILED);
+        }
+
+        case STATS: {
+            if (!in.atEnd()) return status(BAD_REQUEST);
+
+            FrameWriter out(OK, id);
+            out.putPlayers(statsSource_ ? statsSource_() : vector<pair<string, int>>());
+            return out.finish();
+        }
+
+        default:
+            return status(BAD_REQUEST);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: sendReply
+// ------------------------------------------------------------
+// Queues the reply and tries to send it immediately. If the socket
+// is full, EPOLLOUT is armed and the event loop finishes the job.
+// ------------------------------------------------------------
+void SoccerServer::sendReply(const shared_ptr<Connection>& conn, const vector<char>& reply) {
+    lock_guard<mutex> lock(conn->outputMutex);
+    if (conn->closed) return;
+
+    bool wasEmpty = conn->output.empty();
+    conn->output.insert(conn->output.end(), reply.begin(), reply.end());
+
+    // If bytes were already waiting, the event loop is already
+    // responsible for sending them (EPOLLOUT is armed).
+    if (!wasEmpty) return;
+
+    if (!writePending(*conn)) {
+        conn->closed = true;
+        return;
+    }
+    if (!conn->output.empty()) {
+        setWriteInterest(*conn, true);
+    }
+}
+
+bool SoccerServer::writePending(Connection& conn) {
+    size_t sent = 0;
+    while (sent < conn.output.size()) {
+        ssize_t n = send(conn.fd, conn.output.data() + sent, conn.output.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    conn.output.erase(conn.output.begin(), conn.output.begin() + sent);
+    return true;
+}
+
+void SoccerServer::setWriteInterest(Connection& conn, bool enable) {
+    if (conn.wantWrite == enable) return;
+    conn.wantWrite = enable;
+    updateInterest(conn);
+}
+
+// Re-arms epoll with what the connection waits for. A client that
+// shut down its side would make EPOLLIN fire forever, so it is
+// only armed while the client may still send.
+void SoccerServer::updateInterest(Connection& conn) {
+    epoll_event ev{};
+    if (conn.wantRead) {
+        ev.events = EPOLLIN | EPOLLRDHUP;
+    }
+    if (conn.wantWrite) {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.fd = conn.fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+// ------------------------------------------------------------
+// Function: shutdownAll
+// ------------------------------------------------------------
+// Stops the workers, closes every socket and removes the socket
+// file. Safe to call more than once.
+// ------------------------------------------------------------
+void SoccerServer::shutdownAll() {
+    {
+        lock_guard<mutex> lock(readyMutex_);
+        stopping_ = true;
+    }
+    readyCond_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    while (!connections_.empty()) {
+        closeConnection(connections_.begin()->second);
+    }
+
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        unlink(socketPath_.c_str());
+        listenFd_ = -1;
+    }
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+    if (doneFd_ >= 0) {
+        close(doneFd_);
+        doneFd_ = -1;
+    }
+    done_.clear();
+}
@@ -0,0 +1,176 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerServer.h
+// ------------------------------------------------------------
+// A long-running server that keeps ONE Soccer object in memory
+// and answers requests over a Unix domain socket.
+//
+// Why? Starting the program, checking the file and reading it
+// costs far more than answering a single question. Scripts that
+// ask thousands of small questions can connect once and reuse
+// the already-loaded table instead.
+//
+// How it works:
+//
+//   - One "event loop" thread uses epoll to wait on every socket
+//     at once. It accepts new connections, reads incoming bytes
+//     and cuts them into complete frames (SoccerProtocol.h).
+//   - Complete frames are handed to a small pool of worker
+//     threads, which call the Soccer object and build replies.
+//     Each connection's requests are answered in the order they
+//     were sent, so clients may pipeline many requests at once.
+//   - Replies are sent straight away if the socket has room; any
+//     leftover bytes are sent later by the event loop.
+//   - A client that shuts down its sending side after its last
+//     request still gets every answer; the connection closes once
+//     they are sent.
+//
+// Example:
+//   Soccer league("soccer.csv");
+//   SoccerServer server(league, "/tmp/soccer.sock");
+//   server.run();   // returns after stop() is called
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <functional>
+#include "Soccer.h"
+#include "UpdateBuffer.h"
+
+class SoccerServer {
+public:
+    // ------------------------------------------------------------
+    // Constructor
+    // ------------------------------------------------------------
+    // 'workers' is the number of worker threads (0 → one per CPU core).
+    // The socket is not created until run() is called.
+    // ------------------------------------------------------------
+    SoccerServer(Soccer& league, const std::string& socketPath, unsigned workers = 0);
+    ~SoccerServer();
+
+    SoccerServer(const SoccerServer&) = delete;
+    SoccerServer& operator=(const SoccerServer&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: run
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Creates the socket and serves requests until stop().
+    //   - Returns false if the socket could not be set up.
+    // ------------------------------------------------------------
+    bool run();
+
+    // ------------------------------------------------------------
+    // Function: stop
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Asks run() to finish. Safe to call from another thread
+    //     or from a signal handler (it only writes to an eventfd).
+    // ------------------------------------------------------------
+    void stop();
+
+    // ------------------------------------------------------------
+    // Function: setReadOnly / setStatsSource
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - setReadOnly(true) refuses every write with READ_ONLY (used
+    //     for replicas, whose table only the primary may change).
+    //   - STATS requests are answered with whatever 'source' returns
+    //     as (name, value) pairs; without a source the list is empty.
+    //   - Call both before run().
+    // ------------------------------------------------------------
+    void setReadOnly(bool readOnly) { readOnly_ = readOnly; }
+    void setStatsSource(std::function<std::vector<std::pair<std::string, int>>()> source);
+
+    // ------------------------------------------------------------
+    // Function: setUpdateBuffer
+    // ------------------------------------------------------------
+    // Purpose:
+    //   - Sends UPDATE and UPDATE_BATCH through 'buffer' (see
+    //     UpdateBuffer.h) instead of straight to the league, so
+    //     repeated updates of a player cost one log record. ADD and
+    //     GET go through it too, to keep each player's changes in
+    //     order. The buffer must outlive the server; call before run().
+    //   - The OK reply then means "accepted", not "in the file".
+    // ------------------------------------------------------------
+    void setUpdateBuffer(UpdateBuffer* buffer) { updates_ = buffer; }
+
+private:
+    // One connected client. Shared between the event loop and the
+    // workers, so it lives in a shared_ptr and outlives close().
+    struct Connection {
+        int fd = -1;
+        std::vector<char> input;      // Bytes read but not yet framed (event loop only)
+
+        std::mutex outputMutex;       // Protects the four fields below
+        std::vector<char> output;     // Reply bytes waiting to be sent
+        bool wantWrite = false;       // EPOLLOUT is currently armed
+        bool wantRead = true;         // EPOLLIN is armed (until the client shuts down)
+        bool closed = false;
+
+        std::mutex requestMutex;      // Protects the three fields below
+        std::deque<std::vector<char>> requests;   // Frame bodies waiting for a worker
+        bool scheduled = false;       // On the ready list or being served
+        bool peerDone = false;        // The client sent everything it will send
+    };
+
+    Soccer& league_;
+    std::string socketPath_;
+    unsigned workerCount_;
+
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;                 // eventfd used by stop()
+    int doneFd_ = -1;                 // eventfd: a worker finished a peerDone connection
+    std::atomic<bool> running_{false};
+
+    bool readOnly_ = false;
+    UpdateBuffer* updates_ = nullptr;
+    std::function<std::vector<std::pair<std::string, int>>()> statsSource_;
+
+    std::unordered_map<int, std::shared_ptr<Connection>> connections_;
+
+    // Connections whose client has shut down its side and whose
+    // last request a worker has answered. Only the event loop may
+    // close a connection (it owns connections_), so the worker
+    // leaves it here and wakes the loop through doneFd_.
+    std::mutex doneMutex_;
+    std::vector<std::shared_ptr<Connection>> done_;
+
+    // Connections with requests waiting for a worker.
+    std::mutex readyMutex_;
+    std::condition_variable readyCond_;
+    std::deque<std::shared_ptr<Connection>> ready_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+
+    bool openSocket();
+    void acceptClients();
+    void readFromClient(const std::shared_ptr<Connection>& conn);
+    void flushOutput(const std::shared_ptr<Connection>& conn);
+    void closeConnection(const std::shared_ptr<Connection>& conn);
+    void closeIfAnswered(const std::shared_ptr<Connection>& conn);
+    void closeAnswered();
+
+    void queueRequests(const std::shared_ptr<Connection>& conn,
+                       std::vector<std::vector<char>>& frames);
+    void workerLoop();
+    std::vector<char> handleRequest(const std::vector<char>& frame);
+    void sendReply(const std::shared_ptr<Connection>& conn, const std::vector<char>& reply);
+
+    // Sends as much of conn->output as the socket accepts.
+    // The caller must hold conn->outputMutex.
+    bool writePending(Connection& conn);
+    void setWriteInterest(Connection& conn, bool enable);
+    void updateInterest(Connection& conn);
+
+    void shutdownAll();
+};
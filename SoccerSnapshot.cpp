@@ -0,0 +1,397 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: SoccerSnapshot.cpp
+// ------------------------------------------------------------
+// Writer and reader for the shared memory snapshot described in
+// SoccerSnapshot.h.
+//
+// Note on the sequence lock: a reader may look at a record while
+// the writer is changing it. That is expected – the sequence check
+// afterwards tells the reader to throw the result away and retry.
+// The memory fences make sure the sequence checks really happen
+// before and after the record reads.
+// ------------------------------------------------------------
+
+#include "SoccerSnapshot.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace {
+
+constexpr uint32_t MIN_CAPACITY = 64;
+
+// How long a reader waits for a busy writer before giving up.
+constexpr auto MAX_READ_WAIT = chrono::seconds(1);
+
+// Spins this often (with a CPU pause) between looks at the clock.
+// A writer normally finishes within microseconds; after a
+// millisecond the reader sleeps between tries instead of spinning.
+constexpr int SPINS_PER_CHECK = 64;
+constexpr auto SPIN_TIME = chrono::milliseconds(1);
+constexpr auto SLEEP_TIME = chrono::microseconds(200);
+
+// Tells the CPU this is a spin-wait loop (cheaper for the other
+// hyper-thread, and no memory-order mis-speculation on exit).
+void cpuPause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    this_thread::yield();
+#endif
+}
+
+size_t segmentBytes(uint32_t capacity) {
+    return sizeof(SnapshotHeader) + size_t(capacity) * sizeof(SnapshotRecord);
+}
+
+string_view recordName(const SnapshotRecord& r) {
+    return string_view(r.name, min<size_t>(r.nameLength, SNAPSHOT_NAME_CAPACITY));
+}
+
+// Binary search over 'count' sorted records. Returns nullptr if missing.
+template <typename Record>
+Record* lowerBound(Record* records, uint32_t count, string_view name) {
+    Record* end = records + count;
+    Record* it = lower_bound(records, end, name,
+                             [](const SnapshotRecord& r, string_view key) {
+                                 return recordName(r) < key;
+                             });
+    return (it != end && recordName(*it) == name) ? it : nullptr;
+}
+
+} // namespace
+
+// ============================================================
+// SoccerSnapshotWriter
+// ============================================================
+
+SoccerSnapshotWriter::~SoccerSnapshotWriter() {
+    close();
+}
+
+SnapshotRecord* SoccerSnapshotWriter::records() const {
+    return reinterpret_cast<SnapshotRecord*>(static_cast<char*>(base_) + sizeof(SnapshotHeader));
+}
+
+// ------------------------------------------------------------
+// Function: open
+// ------------------------------------------------------------
+// Any old segment with the same name is removed first, so a
+// reader never sees a half-initialised header from a crashed run.
+// ------------------------------------------------------------
+bool SoccerSnapshotWriter::open(const string& shmName) {
+    close();
+
+    shm_unlink(shmName.c_str());
+    fd_ = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd_ < 0) {
+        cerr << "Error: Could not create shared memory " << shmName << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    name_ = shmName;
+
+    if (!resize(MIN_CAPACITY)) {
+        close();
+        return false;
+    }
+
+    SnapshotHeader* h = header();
+    h->magic = SNAPSHOT_MAGIC;
+    h->layoutVersion = SNAPSHOT_LAYOUT_VERSION;
+    h->sequence.store(0, memory_order_release);
+    h->count.store(0, memory_order_release);
+    h->omitted.store(0, memory_order_release);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: resize
+// ------------------------------------------------------------
+// Grows the segment and maps it again. Readers notice the new
+// 'segmentSize' and remap on their next query. Only called while
+// 'sequence' is odd (or before the first publish).
+// ------------------------------------------------------------
+bool SoccerSnapshotWriter::resize(uint32_t capacity) {
+    size_t bytes = segmentBytes(capacity);
+    if (ftruncate(fd_, static_cast<off_t>(bytes)) < 0) {
+        cerr << "Error: Could not size shared memory " << name_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        cerr << "Error: Could not map shared memory " << name_ << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    if (base_) {
+        munmap(base_, mappedSize_);
+    }
+    base_ = mapped;
+    mappedSize_ = bytes;
+
+    header()->capacity = capacity;
+    header()->segmentSize.store(bytes, memory_order_release);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: publish
+// ------------------------------------------------------------
+bool SoccerSnapshotWriter::publish(const vector<pair<string, int>>& players) {
+    if (!base_) return false;
+
+    // Sort a list of pointers (not the strings themselves) by name,
+    // keeping the first entry of each duplicate name.
+    vector<const pair<string, int>*> sorted;
+    sorted.reserve(players.size());
+    for (const auto& p : players) {
+        if (p.first.size() <= SNAPSHOT_NAME_CAPACITY) {
+            sorted.push_back(&p);
+        }
+    }
+    size_t fitting = sorted.size();
+    stable_sort(sorted.begin(), sorted.end(),
+                [](auto* a, auto* b) { return a->first < b->first; });
+    sorted.erase(unique(sorted.begin(), sorted.end(),
+                        [](auto* a, auto* b) { return a->first == b->first; }),
+                 sorted.end());
+
+    SnapshotHeader* h = header();
+    h->sequence.fetch_add(1, memory_order_relaxed);     // Now odd: busy
+    atomic_thread_fence(memory_order_release);
+
+    bool ok = true;
+    if (sorted.size() > h->capacity) {
+        uint32_t capacity = h->capacity;
+        while (capacity < sorted.size()) capacity *= 2;
+        ok = resize(capacity);
+        h = header();
+    }
+
+    if (ok) {
+        SnapshotRecord* out = records();
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            const string& name = sorted[i]->first;
+            memset(out[i].name, 0, sizeof(out[i].name));
+            memcpy(out[i].name, name.data(), name.size());
+            out[i].nameLength = static_cast<uint8_t>(name.size());
+            out[i].goals = sorted[i]->second;
+        }
+        h->count.store(static_cast<uint32_t>(sorted.size()), memory_order_relaxed);
+        h->omitted.store(static_cast<uint32_t>(players.size() - fitting), memory_order_relaxed);
+    }
+
+    h->sequence.fetch_add(1, memory_order_release);     // Even again: done
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Function: updateGoals
+// ------------------------------------------------------------
+bool SoccerSnapshotWriter::updateGoals(string_view name, int goals) {
+    if (!base_) return false;
+
+    SnapshotHeader* h = header();
+    SnapshotRecord* record = lowerBound(records(), h->count.load(memory_order_relaxed), name);
+    if (!record) return false;
+
+    h->sequence.fetch_add(1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    record->goals = goals;
+    h->sequence.fetch_add(1, memory_order_release);
+    return true;
+}
+
+void SoccerSnapshotWriter::close() {
+    if (base_) {
+        munmap(base_, mappedSize_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        shm_unlink(name_.c_str());
+        fd_ = -1;
+    }
+}
+
+// ============================================================
+// SoccerSnapshotReader
+// ============================================================
+
+SoccerSnapshotReader::~SoccerSnapshotReader() {
+    close();
+}
+
+const SnapshotRecord* SoccerSnapshotReader::records() const {
+    return reinterpret_cast<const SnapshotRecord*>(static_cast<const char*>(base_) + sizeof(SnapshotHeader));
+}
+
+bool SoccerSnapshotReader::open(const string& shmName) {
+    close();
+
+    fd_ = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd_ < 0) {
+        cerr << "Error: Could not open shared memory " << shmName << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd_, &info) < 0 || size_t(info.st_size) < sizeof(SnapshotHeader)) {
+        cerr << "Error: " << shmName << " is not a Soccer snapshot.\n";
+        close();
+        return false;
+    }
+
+    base_ = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (base_ == MAP_FAILED) {
+        base_ = nullptr;
+        cerr << "Error: Could not map shared memory " << shmName << ": " << strerror(errno) << "\n";
+        close();
+        return false;
+    }
+    mappedSize_ = info.st_size;
+
+    if (header()->magic != SNAPSHOT_MAGIC || header()->layoutVersion != SNAPSHOT_LAYOUT_VERSION) {
+        cerr << "Error: " << shmName << " is not a compatible Soccer snapshot.\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: remapIfGrown
+// ------------------------------------------------------------
+// The only place a reader makes system calls after open(): when
+// the writer has grown the segment past what we have mapped.
+// ------------------------------------------------------------
+bool SoccerSnapshotReader::remapIfGrown() {
+    size_t wanted = header()->segmentSize.load(memory_order_acquire);
+    if (wanted <= mappedSize_) return true;
+
+    const void* mapped = mmap(nullptr, wanted, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) return false;
+
+    munmap(const_cast<void*>(base_), mappedSize_);
+    base_ = mapped;
+    mappedSize_ = wanted;
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: consistentRead (template helper)
+// ------------------------------------------------------------
+// 'read' is given the records and how many of them to look at.
+// It may run more than once, so it must not have side effects
+// beyond filling in its own result.
+//
+// While the writer is busy the reader spins with a CPU pause,
+// then sleeps between tries, and gives up after MAX_READ_WAIT: a
+// writer that was killed between its two sequence increments
+// never finishes.
+// ------------------------------------------------------------
+template <typename Read>
+bool SoccerSnapshotReader::consistentRead(Read read) {
+    if (!base_) return false;
+
+    auto start = chrono::steady_clock::now();
+    for (int attempt = 1; ; ++attempt) {
+        if (attempt % SPINS_PER_CHECK == 0) {
+            auto waited = chrono::steady_clock::now() - start;
+            if (waited > MAX_READ_WAIT) return false;
+            if (waited > SPIN_TIME) this_thread::sleep_for(SLEEP_TIME);
+        }
+
+        uint64_t before = header()->sequence.load(memory_order_acquire);
+        if (before & 1) {                       // Writer is busy
+            cpuPause();
+            continue;
+        }
+
+        if (!remapIfGrown()) return false;
+
+        size_t mappedCapacity = (mappedSize_ - sizeof(SnapshotHeader)) / sizeof(SnapshotRecord);
+        uint32_t count = static_cast<uint32_t>(
+            min<size_t>(header()->count.load(memory_order_relaxed), mappedCapacity));
+
+        uint32_t omitted = header()->omitted.load(memory_order_relaxed);
+        read(records(), count);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (header()->sequence.load(memory_order_relaxed) == before) {
+            lastVersion_ = before;
+            lastOmitted_ = omitted;
+            return true;
+        }
+    }
+}
+
+// A name too long for a record can't be in the snapshot at all.
+bool SoccerSnapshotReader::find(string_view name, int& goals) {
+    bool found = false;
+    answered_ = name.size() <= SNAPSHOT_NAME_CAPACITY &&
+                consistentRead([&](const SnapshotRecord* recs, uint32_t count) {
+        const SnapshotRecord* r = lowerBound(recs, count, name);
+        found = (r != nullptr);
+        if (found) goals = r->goals;
+    });
+    return found && answered_;
+}
+
+// The whole table, or the best scorers, may include left-out players.
+vector<pair<string, int>> SoccerSnapshotReader::players() {
+    vector<pair<string, int>> result;
+    answered_ = consistentRead([&](const SnapshotRecord* recs, uint32_t count) {
+        result.clear();
+        result.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            result.push_back({string(recordName(recs[i])), recs[i].goals});
+        }
+    }) && lastOmitted_ == 0;
+    return result;
+}
+
+// Same ordering as Soccer::topPlayers: most goals first, then by name.
+vector<pair<string, int>> SoccerSnapshotReader::top(size_t n) {
+    vector<pair<string, int>> result;
+    answered_ = consistentRead([&](const SnapshotRecord* recs, uint32_t count) {
+        vector<const SnapshotRecord*> order;
+        order.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) order.push_back(&recs[i]);
+
+        size_t k = min<size_t>(n, count);
+        partial_sort(order.begin(), order.begin() + k, order.end(),
+                     [](const SnapshotRecord* a, const SnapshotRecord* b) {
+                         if (a->goals != b->goals) return a->goals > b->goals;
+                         return recordName(*a) < recordName(*b);
+                     });
+
+        result.clear();
+        for (size_t i = 0; i < k; ++i) {
+            result.push_back({string(recordName(*order[i])), order[i]->goals});
+        }
+    }) && lastOmitted_ == 0;
+    return result;
+}
+
+void SoccerSnapshotReader::close() {
+    if (base_) {
+        munmap(const_cast<void*>(base_), mappedSize_);
+        base_ = nullptr;
+        mappedSize_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
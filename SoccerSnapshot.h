@@ -0,0 +1,182 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerSnapshot.h
+// ------------------------------------------------------------
+// A read-only copy of the player table placed in POSIX shared
+// memory, so OTHER processes can look players up directly in
+// memory – no socket, no file, no copying, and no system call
+// per lookup.
+//
+// Layout of the shared memory segment:
+//
+//     +------------------+--------------------------------+
+//     | SnapshotHeader   | SnapshotRecord x capacity      |
+//     +------------------+--------------------------------+
+//
+// Records are kept sorted by name, so a lookup is a binary search.
+//
+// Versioning (a "sequence lock"):
+//   - The writer makes 'sequence' ODD before it changes anything
+//     and EVEN again when it is done.
+//   - A reader remembers 'sequence', does its lookup, and then
+//     checks that 'sequence' is still the same EVEN number. If
+//     not, the writer was busy and the reader simply tries again.
+//   - A writer that dies half way leaves 'sequence' odd for good,
+//     so a reader only waits for it a limited time (a second).
+//     The query then reports that it wasn't answered.
+//
+// Only one process (the one that owns the Soccer object) writes.
+// Any number of processes can read.
+//
+// Example (writer – usually via Soccer::publishSnapshot):
+//   league.publishSnapshot("/soccer_snapshot");
+//
+// Example (reader, in another process):
+//   SoccerSnapshotReader snap;
+//   int goals;
+//   if (snap.open("/soccer_snapshot") && snap.find("Messi", goals)) { ... }
+//   if (!snap.answered()) { ... ask the server instead ... }
+// ------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+// Longest name (in bytes) that fits in a record. Longer names
+// are left out of the snapshot; 'omitted' counts them, and
+// queries that might need them aren't answered (see answered()).
+constexpr size_t SNAPSHOT_NAME_CAPACITY = 59;
+
+// "SOCR" – lets a reader recognise a real snapshot segment.
+constexpr uint32_t SNAPSHOT_MAGIC = 0x52434F53;
+constexpr uint32_t SNAPSHOT_LAYOUT_VERSION = 2;
+
+// One player: exactly 64 bytes, one cache line.
+struct SnapshotRecord {
+    char name[SNAPSHOT_NAME_CAPACITY];
+    uint8_t nameLength;
+    int32_t goals;
+};
+static_assert(sizeof(SnapshotRecord) == 64, "SnapshotRecord should fill one cache line");
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t layoutVersion;
+    std::atomic<uint64_t> sequence;     // Odd while the writer is busy
+    std::atomic<uint64_t> segmentSize;  // Bytes the writer has sized the segment to
+    std::atomic<uint32_t> count;        // Records in use
+    uint32_t capacity;                  // Records that fit (changes only with segmentSize)
+    std::atomic<uint32_t> omitted;      // Players left out (name too long)
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory needs lock-free atomics");
+
+// ------------------------------------------------------------
+// Class: SoccerSnapshotWriter
+// ------------------------------------------------------------
+// Owns the shared memory segment and keeps it up to date.
+// The segment is removed (shm_unlink) when the writer is destroyed;
+// readers that already mapped it keep their mapping.
+// ------------------------------------------------------------
+class SoccerSnapshotWriter {
+public:
+    SoccerSnapshotWriter() = default;
+    ~SoccerSnapshotWriter();
+
+    SoccerSnapshotWriter(const SoccerSnapshotWriter&) = delete;
+    SoccerSnapshotWriter& operator=(const SoccerSnapshotWriter&) = delete;
+
+    // Creates (or replaces) the segment. 'shmName' must start with '/'.
+    bool open(const std::string& shmName);
+
+    // ------------------------------------------------------------
+    // Function: publish
+    // ------------------------------------------------------------
+    // Replaces the whole table. 'players' does not need to be
+    // sorted; for duplicate names the first entry wins.
+    // ------------------------------------------------------------
+    bool publish(const std::vector<std::pair<std::string, int>>& players);
+
+    // ------------------------------------------------------------
+    // Function: updateGoals
+    // ------------------------------------------------------------
+    // Changes one existing record in place (cheap). Returns false if
+    // the name isn't in the snapshot – the caller should publish().
+    // ------------------------------------------------------------
+    bool updateGoals(std::string_view name, int goals);
+
+private:
+    std::string name_;
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mappedSize_ = 0;
+
+    SnapshotHeader* header() const { return static_cast<SnapshotHeader*>(base_); }
+    SnapshotRecord* records() const;
+
+    bool resize(uint32_t capacity);
+    void close();
+};
+
+// ------------------------------------------------------------
+// Class: SoccerSnapshotReader
+// ------------------------------------------------------------
+// Maps a segment created by SoccerSnapshotWriter (read-only).
+// Every query retries on its own until it gets a consistent view,
+// or gives up after a second if the writer never finishes.
+// ------------------------------------------------------------
+class SoccerSnapshotReader {
+public:
+    SoccerSnapshotReader() = default;
+    ~SoccerSnapshotReader();
+
+    SoccerSnapshotReader(const SoccerSnapshotReader&) = delete;
+    SoccerSnapshotReader& operator=(const SoccerSnapshotReader&) = delete;
+
+    bool open(const std::string& shmName);
+
+    // Binary search by name. No copies, no system calls.
+    bool find(std::string_view name, int& goals);
+
+    // Copies of the whole table (sorted by name) or the n best scorers.
+    std::vector<std::pair<std::string, int>> players();
+    std::vector<std::pair<std::string, int>> top(size_t n);
+
+    // The sequence number of the last consistent read.
+    uint64_t version() const { return lastVersion_; }
+
+    // ------------------------------------------------------------
+    // Function: answered
+    // ------------------------------------------------------------
+    // False if the last query's result can't be trusted: no
+    // consistent view was seen in time (the writer may have died
+    // half way), or the answer may involve a player the snapshot
+    // leaves out (a name longer than SNAPSHOT_NAME_CAPACITY). Ask
+    // the server instead.
+    // ------------------------------------------------------------
+    bool answered() const { return answered_; }
+
+private:
+    int fd_ = -1;
+    const void* base_ = nullptr;
+    size_t mappedSize_ = 0;
+    uint64_t lastVersion_ = 0;
+    uint32_t lastOmitted_ = 0;          // 'omitted' at the last consistent read
+    bool answered_ = true;
+
+    const SnapshotHeader* header() const { return static_cast<const SnapshotHeader*>(base_); }
+    const SnapshotRecord* records() const;
+
+    // Runs 'read' until it sees a stable, even sequence number.
+    // False if it didn't within the time limit.
+    template <typename Read>
+    bool consistentRead(Read read);
+
+    bool remapIfGrown();
+    void close();
+};
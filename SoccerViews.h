@@ -0,0 +1,226 @@
+//
+// Module 9 - Streams and Files
+// Header File: SoccerViews.h
+// ------------------------------------------------------------
+// The player table as a C++20 range, so standard range adaptors
+// can be chained into one lazy pipeline:
+//
+//   auto mPlayers = league.records()
+//                 | std::views::filter([](PlayerRecord p) { return p.name.starts_with("M"); });
+//   auto best = SoccerViews::topScorers(mPlayers, 10);
+//
+// Nothing in that pipeline makes a vector of players: records()
+// reads straight from the goals / names columns, filter() asks
+// for one record at a time, and topScorers() keeps only the 10
+// best seen so far. The whole pipeline is a single pass.
+//
+// What is here:
+//
+//   PlayerRecord      one row: {string_view name, int goals}
+//   RecordView        the table as a random-access view (what
+//                     Soccer::records() returns)
+//   chunk(n)          splits any forward range into pieces of n
+//                     elements (std::views::chunk is C++23; this
+//                     header uses it when the library has it)
+//   topScorers(r, n)  the n best records of any range, O(n) memory
+//
+// The standard adaptors (std::views::filter, transform, take,
+// drop, ...) work on RecordView like on any other range.
+// ------------------------------------------------------------
+
+#pragma once
+#include <ranges>
+#include <iterator>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+// One row of the table. 'name' points into the table itself, so
+// nothing is copied.
+struct PlayerRecord {
+    std::string_view name;
+    int goals;
+};
+
+namespace SoccerViews {
+
+// ------------------------------------------------------------
+// Class: RecordView
+// ------------------------------------------------------------
+// Row i is {names[i], goals[i]}. The view shares ownership of a
+// reader lock on the table, so the columns can't change while any
+// copy of the view (or a pipeline built on it) is alive.
+// ------------------------------------------------------------
+class RecordView : public std::ranges::view_interface<RecordView> {
+public:
+    class iterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;   // operator* returns a value
+        using value_type = PlayerRecord;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const std::string* names, const int* goals, difference_type row)
+            : names_(names), goals_(goals), row_(row) {}
+
+        PlayerRecord operator*() const { return {names_[row_], goals_[row_]}; }
+        PlayerRecord operator[](difference_type n) const { return *(*this + n); }
+
+        iterator& operator++() { ++row_; return *this; }
+        iterator operator++(int) { iterator old = *this; ++row_; return old; }
+        iterator& operator--() { --row_; return *this; }
+        iterator operator--(int) { iterator old = *this; --row_; return old; }
+        iterator& operator+=(difference_type n) { row_ += n; return *this; }
+        iterator& operator-=(difference_type n) { row_ -= n; return *this; }
+
+        friend iterator operator+(iterator it, difference_type n) { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) { return a.row_ - b.row_; }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.row_ == b.row_; }
+        friend auto operator<=>(const iterator& a, const iterator& b) { return a.row_ <=> b.row_; }
+
+        // Row number in the table.
+        size_t row() const { return static_cast<size_t>(row_); }
+
+    private:
+        const std::string* names_ = nullptr;
+        const int* goals_ = nullptr;
+        difference_type row_ = 0;
+    };
+
+    RecordView() = default;
+    RecordView(std::shared_lock<std::shared_mutex> lock, const std::string* names,
+               const int* goals, size_t size)
+        : lock_(std::make_shared<std::shared_lock<std::shared_mutex>>(std::move(lock))),
+          names_(names), goals_(goals), size_(size) {}
+
+    iterator begin() const { return iterator(names_, goals_, 0); }
+    iterator end() const { return iterator(names_, goals_, static_cast<std::ptrdiff_t>(size_)); }
+    size_t size() const { return size_; }
+
+private:
+    std::shared_ptr<std::shared_lock<std::shared_mutex>> lock_;
+    const std::string* names_ = nullptr;
+    const int* goals_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ------------------------------------------------------------
+// Adaptor: chunk(n)
+// ------------------------------------------------------------
+// "r | chunk(3)" yields consecutive pieces of r with 3 elements
+// each (the last one may be shorter). Each piece is a subrange of
+// r, so no elements are copied.
+// ------------------------------------------------------------
+#if defined(__cpp_lib_ranges_chunk)
+inline auto chunk(std::ptrdiff_t n) { return std::views::chunk(n); }
+#else
+template <std::ranges::view V>
+    requires std::ranges::forward_range<V>
+class ChunkView : public std::ranges::view_interface<ChunkView<V>> {
+public:
+    using BaseIterator = std::ranges::iterator_t<V>;
+    using BaseSentinel = std::ranges::sentinel_t<V>;
+    using Difference = std::ranges::range_difference_t<V>;
+
+    class iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::ranges::subrange<BaseIterator>;
+        using difference_type = Difference;
+
+        iterator() = default;
+        iterator(BaseIterator current, BaseSentinel end, Difference n)
+            : current_(current), end_(end), n_(n) {}
+
+        value_type operator*() const {
+            return {current_, std::ranges::next(current_, n_, end_)};
+        }
+        iterator& operator++() {
+            current_ = std::ranges::next(current_, n_, end_);
+            return *this;
+        }
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a.current_ == b.current_; }
+        friend bool operator==(const iterator& it, std::default_sentinel_t) { return it.current_ == it.end_; }
+
+    private:
+        BaseIterator current_{};
+        BaseSentinel end_{};
+        Difference n_ = 1;
+    };
+
+    ChunkView() = default;
+    ChunkView(V base, Difference n) : base_(std::move(base)), n_(n) {}
+
+    iterator begin() { return iterator(std::ranges::begin(base_), std::ranges::end(base_), n_); }
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    V base_;
+    Difference n_ = 1;
+};
+
+struct ChunkAdaptor {
+    std::ptrdiff_t n;
+
+    template <std::ranges::viewable_range R>
+        requires std::ranges::forward_range<R>
+    friend auto operator|(R&& range, ChunkAdaptor adaptor) {
+        auto base = std::views::all(std::forward<R>(range));
+        using V = decltype(base);
+        return ChunkView<V>(std::move(base), static_cast<std::ranges::range_difference_t<V>>(adaptor.n));
+    }
+};
+
+inline ChunkAdaptor chunk(std::ptrdiff_t n) { return ChunkAdaptor{n < 1 ? 1 : n}; }
+#endif
+
+// ------------------------------------------------------------
+// Function: topScorers
+// ------------------------------------------------------------
+// The 'n' records of 'records' with the most goals, highest first
+// (ties by name), in one pass. Only the best n seen so far are
+// kept, in a heap whose top is the weakest of them.
+// ------------------------------------------------------------
+template <std::ranges::input_range R>
+std::vector<std::pair<std::string, int>> topScorers(R&& records, size_t n) {
+    auto better = [](const PlayerRecord& a, const PlayerRecord& b) {
+        if (a.goals != b.goals) return a.goals > b.goals;
+        return a.name < b.name;
+    };
+
+    std::vector<PlayerRecord> best;
+    if (n > 0) {
+        for (PlayerRecord record : records) {
+            if (best.size() < n) {
+                best.push_back(record);
+                std::push_heap(best.begin(), best.end(), better);
+            } else if (better(record, best.front())) {
+                std::pop_heap(best.begin(), best.end(), better);
+                best.back() = record;
+                std::push_heap(best.begin(), best.end(), better);
+            }
+        }
+    }
+    std::sort(best.begin(), best.end(), better);
+
+    std::vector<std::pair<std::string, int>> top;
+    top.reserve(best.size());
+    for (const PlayerRecord& record : best) {
+        top.push_back({std::string(record.name), record.goals});
+    }
+    return top;
+}
+
+} // namespace SoccerViews
@@ -0,0 +1,218 @@
+//
+// Module 9 - Streams and Files
+// Header File: SpscQueue.h
+// ------------------------------------------------------------
+// A bounded, lock-free queue for exactly ONE producer thread and
+// ONE consumer thread ("single-producer / single-consumer").
+//
+// The items live in a ring buffer whose size is a power of two.
+// The producer only ever writes 'tail_', the consumer only ever
+// writes 'head_', so no mutex and no compare-and-swap is needed:
+// each side publishes its progress with a release store and reads
+// the other side's with an acquire load.
+//
+//     head_                      tail_
+//       v                          v
+//     [ x | x | x | x |   |   |   |   ]   ← 4 items waiting
+//
+// When the ring is full, push() waits. That is how backpressure
+// works in a pipeline: a slow stage fills its input queue, the
+// stage before it stops, and so on up to the reader.
+//
+// head_ and tail_ sit on separate cache lines, otherwise every
+// push would invalidate the consumer's cache line and vice versa
+// ("false sharing").
+//
+// Example:
+//   SpscQueue<Batch> queue(64);
+//   producer:  queue.push(std::move(batch));   ...   queue.close();
+//   consumer:  Batch batch;  while (queue.pop(batch)) { ... }
+// ------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// ------------------------------------------------------------
+// Struct: QueueMetrics
+// ------------------------------------------------------------
+// Occupancy numbers for one queue, read by the pipeline report.
+// "Occupancy" is the number of items waiting, sampled on every
+// push; a queue that is usually full means the stage AFTER it is
+// the bottleneck, a queue that is usually empty means the stage
+// BEFORE it is.
+// ------------------------------------------------------------
+struct QueueMetrics {
+    size_t capacity = 0;
+    size_t highWater = 0;          // Most items ever waiting at once
+    double averageOccupancy = 0;   // Mean items waiting at push time
+    uint64_t pushes = 0;
+    uint64_t fullWaits = 0;        // Pushes that found the queue full
+};
+
+template <typename T>
+class SpscQueue {
+public:
+    // 'capacity' is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // ------------------------------------------------------------
+    // Producer side
+    // ------------------------------------------------------------
+
+    // Adds 'item' if there is room. Never blocks.
+    bool tryPush(T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            // Looks full: refresh our copy of the consumer's position.
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) return false;
+        }
+
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        // Items are big (whole batches), so one extra look at the
+        // consumer's position per push is cheap enough for metrics.
+        size_t waiting = tail + 1 - head_.load(std::memory_order_relaxed);
+        ++pushes_;
+        occupancySum_ += waiting;
+        if (waiting > highWater_) highWater_ = waiting;
+        return true;
+    }
+
+    // Adds 'item', waiting while the queue is full (backpressure).
+    // The consumer must keep popping until the queue is closed,
+    // otherwise this waits forever.
+    void push(T item) {
+        if (tryPush(item)) return;
+
+        ++fullWaits_;
+        Backoff backoff;
+        while (!tryPush(item)) {
+            backoff.pause();
+        }
+    }
+
+    // No more items will be pushed. The consumer drains what is
+    // left, then pop() returns false.
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // ------------------------------------------------------------
+    // Consumer side
+    // ------------------------------------------------------------
+
+    // Takes the oldest item if there is one. Never blocks.
+    bool tryPop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+
+        item = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Takes the oldest item, waiting while the queue is empty.
+    // Returns false once the queue is closed AND empty.
+    bool pop(T& item) {
+        Backoff backoff;
+        while (true) {
+            if (tryPop(item)) return true;
+            if (closed_.load(std::memory_order_acquire)) {
+                return tryPop(item);    // An item may have landed just before close()
+            }
+            backoff.pause();
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Function: popUntil
+    // ------------------------------------------------------------
+    // Like pop(), but gives up at 'deadline'. Used by stages that
+    // must do something on a timer even when no input arrives.
+    // ------------------------------------------------------------
+    enum class PopResult { ITEM, TIMEOUT, CLOSED };
+
+    template <typename Clock, typename Duration>
+    PopResult popUntil(T& item, std::chrono::time_point<Clock, Duration> deadline) {
+        Backoff backoff;
+        while (true) {
+            if (tryPop(item)) return PopResult::ITEM;
+            if (closed_.load(std::memory_order_acquire)) {
+                return tryPop(item) ? PopResult::ITEM : PopResult::CLOSED;
+            }
+            if (Clock::now() >= deadline) return PopResult::TIMEOUT;
+            backoff.pause();
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Metrics (read after the producer has finished)
+    // ------------------------------------------------------------
+    QueueMetrics metrics() const {
+        QueueMetrics m;
+        m.capacity = slots_.size();
+        m.highWater = highWater_;
+        m.pushes = pushes_;
+        m.fullWaits = fullWaits_;
+        m.averageOccupancy = pushes_ ? double(occupancySum_) / pushes_ : 0;
+        return m;
+    }
+
+private:
+    // ------------------------------------------------------------
+    // Struct: Backoff
+    // ------------------------------------------------------------
+    // Waiting without a mutex means polling. Spin briefly (the other
+    // side is usually only a moment away), then yield the CPU, then
+    // sleep, so an idle stage doesn't burn a whole core.
+    // ------------------------------------------------------------
+    struct Backoff {
+        int rounds = 0;
+        void pause() {
+            ++rounds;
+            if (rounds < 64) {
+                // Busy spin
+            } else if (rounds < 256) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    };
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    // Consumer-owned
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Producer-owned
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+    uint64_t pushes_ = 0;
+    uint64_t occupancySum_ = 0;
+    uint64_t fullWaits_ = 0;
+    size_t highWater_ = 0;
+
+    alignas(CACHE_LINE) std::atomic<bool> closed_{false};
+};
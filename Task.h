@@ -0,0 +1,177 @@
+//
+// Module 9 - Streams and Files
+// Header File: Task.h
+// ------------------------------------------------------------
+// Task<T>: the return type of an asynchronous function written as
+// a C++20 coroutine.
+//
+//   Task<int> goalsOf(Soccer& league, string name) {
+//       auto goals = co_await league.findPlayerAsync(name);
+//       co_return goals.value_or(0);
+//   }
+//
+// A Task does nothing until it is co_awaited (it is "lazy"). The
+// awaiting coroutine is then suspended – its thread is free to run
+// other work – and is resumed with the result once the task has
+// finished, on whichever thread finished it. No thread ever sits
+// blocked waiting for an answer, which is what lets thousands of
+// logical clients share a handful of threads (see Executor.h).
+//
+// Outside of a coroutine (e.g. in main), use:
+//
+//   syncWait(task)        run it and block this thread for the result
+//   spawn(executor, task) start it on an executor and forget about
+//                         it (see Executor.h)
+// ------------------------------------------------------------
+
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <utility>
+#include <type_traits>
+
+template <typename T = void>
+class Task;
+
+namespace TaskDetail {
+
+// Parts of the promise shared by Task<T> and Task<void>.
+struct PromiseBase {
+    std::coroutine_handle<> continuation;   // Who co_awaited this task
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // When the task finishes, jump straight into the coroutine that
+    // was waiting for it ("symmetric transfer": no extra stack frame).
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> done) noexcept {
+            auto next = done.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+    T result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() noexcept {}
+
+    void result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// A coroutine that starts immediately and frees itself when done.
+// Only used by syncWait() and spawn() (see Executor.h).
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace TaskDetail
+
+template <typename T>
+class Task {
+public:
+    using promise_type = TaskDetail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    // co_await: remember who is waiting, then start the task.
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+    T await_resume() { return handle_.promise().result(); }
+
+private:
+    Handle handle_;
+};
+
+namespace TaskDetail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Owns the task and the promise, so syncWait() can return as soon
+// as the result is ready without anything here being left dangling.
+template <typename T>
+Detached runAndSignal(Task<T> task, std::promise<T> done) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            done.set_value();
+        } else {
+            done.set_value(co_await task);
+        }
+    } catch (...) {
+        done.set_exception(std::current_exception());
+    }
+}
+
+} // namespace TaskDetail
+
+// ------------------------------------------------------------
+// Function: syncWait
+// ------------------------------------------------------------
+// Runs 'task' and blocks the calling thread until it finishes.
+// For main() and tests – never call it from inside a coroutine
+// that runs on an executor thread.
+// ------------------------------------------------------------
+template <typename T>
+T syncWait(Task<T> task) {
+    std::promise<T> done;
+    std::future<T> result = done.get_future();
+    TaskDetail::runAndSignal(std::move(task), std::move(done));
+    return result.get();
+}
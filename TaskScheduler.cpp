@@ -0,0 +1,187 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: TaskScheduler.cpp
+// ------------------------------------------------------------
+// Work-stealing worker pool (see TaskScheduler.h).
+// ------------------------------------------------------------
+
+#include "TaskScheduler.h"
+#include <chrono>
+#include <iostream>
+#include <cstring>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+using namespace std;
+
+namespace {
+
+// Which scheduler (if any) the current thread works for, and its
+// index there.
+thread_local const TaskScheduler* currentScheduler = nullptr;
+thread_local size_t currentIndex = 0;
+
+// Settings for TaskScheduler::shared(), and whether it has started.
+mutex sharedMutex;
+unsigned sharedWorkers = 0;
+bool sharedPin = false;
+bool sharedStarted = false;
+
+// Marks the shared scheduler as started and returns its settings.
+pair<unsigned, bool> startShared() {
+    lock_guard<mutex> lock(sharedMutex);
+    sharedStarted = true;
+    return {sharedWorkers, sharedPin};
+}
+
+} // namespace
+
+TaskScheduler::TaskScheduler(unsigned workers, bool pinThreads) {
+    if (workers == 0) workers = max(2u, thread::hardware_concurrency()) - 1;
+
+    // Create every deque before any thread starts stealing from them.
+    for (unsigned i = 0; i < workers; ++i) workers_.push_back(make_unique<Worker>());
+    for (unsigned i = 0; i < workers; ++i) {
+        workers_[i]->thread = thread(&TaskScheduler::workerLoop, this, i, pinThreads);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        lock_guard<mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static const pair<unsigned, bool> settings = startShared();
+    static TaskScheduler instance(settings.first, settings.second);
+    return instance;
+}
+
+bool TaskScheduler::configureShared(unsigned workers, bool pinThreads) {
+    lock_guard<mutex> lock(sharedMutex);
+    if (sharedStarted) return false;
+    sharedWorkers = workers;
+    sharedPin = pinThreads;
+    return true;
+}
+
+size_t TaskScheduler::currentWorker() const {
+    return (currentScheduler == this) ? currentIndex : workers_.size();
+}
+
+// ------------------------------------------------------------
+// Function: submit
+// ------------------------------------------------------------
+void TaskScheduler::submit(function<void()> task) {
+    size_t self = currentWorker();
+    size_t target = (self < workers_.size())
+                        ? self
+                        : nextVictim_.fetch_add(1, memory_order_relaxed) % workers_.size();
+    {
+        lock_guard<mutex> lock(workers_[target]->mutex);
+        workers_[target]->tasks.push_back(move(task));
+    }
+    pending_.fetch_add(1, memory_order_release);
+
+    // Taking the lock (even briefly) makes sure a worker that just
+    // saw pending_ == 0 is already waiting and gets the notify.
+    { lock_guard<mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+void TaskScheduler::post(coroutine_handle<> handle) {
+    submit([handle] { handle.resume(); });
+}
+
+// ------------------------------------------------------------
+// Helper Function: runOne
+// ------------------------------------------------------------
+bool TaskScheduler::runOne(size_t self) {
+    function<void()> task;
+    bool stolen = false;
+
+    // Own deque, newest first.
+    if (self < workers_.size()) {
+        Worker& own = *workers_[self];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+
+    // Someone else's deque, oldest first, starting next to us so
+    // thieves spread out over the victims.
+    for (size_t i = 1; !task && i <= workers_.size(); ++i) {
+        size_t victim = (self + i) % workers_.size();
+        Worker& other = *workers_[victim];
+        lock_guard<mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = move(other.tasks.front());
+            other.tasks.pop_front();
+            stolen = (victim != self);
+        }
+    }
+
+    if (!task) return false;
+    pending_.fetch_sub(1, memory_order_acq_rel);
+    if (stolen) steals_.fetch_add(1, memory_order_relaxed);
+    task();
+    tasksRun_.fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+// ------------------------------------------------------------
+// Helper Function: workerLoop
+// ------------------------------------------------------------
+void TaskScheduler::workerLoop(size_t self, bool pin) {
+    currentScheduler = this;
+    currentIndex = self;
+
+#ifdef __linux__
+    if (pin) {
+        unsigned cpus = max(1u, thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(self % cpus, &set);
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (result != 0) {
+            cerr << "Warning: Could not pin worker " << self << ": " << strerror(result) << "\n";
+        }
+    }
+#else
+    (void)pin;
+#endif
+
+    for (;;) {
+        if (runOne(self)) continue;
+
+        auto idleStart = chrono::steady_clock::now();
+        {
+            unique_lock<mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stopping_ || pending_.load(memory_order_acquire) > 0; });
+            if (stopping_ && pending_.load(memory_order_acquire) == 0) return;
+        }
+        idleNanoseconds_.fetch_add(static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - idleStart).count()),
+            memory_order_relaxed);
+    }
+}
+
+// ------------------------------------------------------------
+// Function: metrics
+// ------------------------------------------------------------
+SchedulerMetrics TaskScheduler::metrics() const {
+    SchedulerMetrics m;
+    m.workers = workerCount();
+    m.tasksRun = tasksRun_.load(memory_order_relaxed);
+    m.steals = steals_.load(memory_order_relaxed);
+    m.idleSeconds = idleNanoseconds_.load(memory_order_relaxed) / 1e9;
+    m.queueDepth = pending_.load(memory_order_relaxed);
+    return m;
+}
@@ -0,0 +1,213 @@
+//
+// Module 9 - Streams and Files
+// Header File: TaskScheduler.h
+// ------------------------------------------------------------
+// One pool of worker threads for every parallel job in the
+// process (aggregates, rebuilding totals from the goal history,
+// loading many files, ...), instead of starting and joining fresh
+// threads on every call.
+//
+// Work stealing:
+//
+//   - Every worker has its own deque of tasks. A worker pushes and
+//     pops at the BACK of its own deque (newest first, so the data
+//     it just touched is still in cache).
+//   - A worker whose deque is empty "steals" from the FRONT of
+//     another worker's deque (the oldest task, usually the biggest
+//     piece of remaining work).
+//   - Workers with nothing to run or steal go to sleep until new
+//     work is submitted.
+//
+// So there is no single queue that every thread fights over, and
+// a worker that finishes early helps the others instead of idling.
+// Each deque has its own small lock; only a thief and the owner
+// ever compete for it.
+//
+// parallelFor / parallelReduce cut a range into chunks and spread
+// them over the workers. The calling thread runs chunks too, and
+// while it waits it runs other queued tasks – so calling
+// parallelFor from inside a task can't deadlock.
+//
+// The scheduler is also an Executor (see Executor.h), so async
+// Soccer calls can resume on it.
+//
+// Example:
+//   TaskScheduler& pool = TaskScheduler::shared();
+//   pool.parallelFor(0, n, 4096, [&](size_t begin, size_t end) { ... });
+//   long long sum = pool.parallelReduce(0, n, 4096, 0LL,
+//       [&](size_t b, size_t e) { long long s = 0; for (...) s += v[i]; return s; },
+//       [](long long a, long long b) { return a + b; });
+// ------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <vector>
+#include "Executor.h"
+
+struct SchedulerMetrics {
+    unsigned workers = 0;
+    uint64_t tasksRun = 0;     // Tasks finished by workers or helping callers
+    uint64_t steals = 0;       // Tasks taken from another worker's deque
+    double idleSeconds = 0;    // Total time workers spent asleep
+    size_t queueDepth = 0;     // Tasks waiting right now
+};
+
+class TaskScheduler : public Executor {
+public:
+    // ------------------------------------------------------------
+    // Constructor
+    // ------------------------------------------------------------
+    // 'workers' = 0 starts one worker per CPU but one (the thread
+    // calling parallelFor works too). 'pinThreads' binds worker i
+    // to CPU i, so its deque and data stay in that core's caches.
+    // ------------------------------------------------------------
+    explicit TaskScheduler(unsigned workers = 0, bool pinThreads = false);
+    ~TaskScheduler() override;
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: shared / configureShared
+    // ------------------------------------------------------------
+    // The process-wide scheduler, started on first use. To change
+    // its size or pinning, call configureShared() before anything
+    // uses it; returns false if it is already running.
+    // ------------------------------------------------------------
+    static TaskScheduler& shared();
+    static bool configureShared(unsigned workers, bool pinThreads);
+
+    unsigned workerCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Queues one task. From a worker it goes on that worker's own
+    // deque; from any other thread, on the workers' deques in turn.
+    void submit(std::function<void()> task);
+
+    // Executor: resumes the coroutine as a task.
+    void post(std::coroutine_handle<> handle) override;
+
+    // ------------------------------------------------------------
+    // Function: parallelFor
+    // ------------------------------------------------------------
+    // Calls body(chunkBegin, chunkEnd) for pieces of [begin, end)
+    // of about 'grain' elements, in parallel, and returns when all
+    // are done. The first exception thrown by 'body' is rethrown.
+    // ------------------------------------------------------------
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body body);
+
+    // ------------------------------------------------------------
+    // Function: parallelReduce
+    // ------------------------------------------------------------
+    // map(chunkBegin, chunkEnd) → T for every chunk, then the
+    // results are folded with combine() in chunk order, starting
+    // from 'identity' (so the answer doesn't depend on timing).
+    // ------------------------------------------------------------
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(size_t begin, size_t end, size_t grain, T identity, Map map, Combine combine);
+
+    SchedulerMetrics metrics() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> nextVictim_{0};   // Round robin for outside submits
+
+    std::atomic<size_t> pending_{0};      // Tasks in all deques
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> tasksRun_{0};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<uint64_t> idleNanoseconds_{0};
+
+    void workerLoop(size_t self, bool pin);
+
+    // Runs one queued task (own deque first, then stealing).
+    // 'self' is the worker index, or workers_.size() for a thread
+    // that isn't a worker. Returns false if nothing was found.
+    bool runOne(size_t self);
+
+    // Index of the calling thread in this scheduler, or
+    // workers_.size() if it isn't one of its workers.
+    size_t currentWorker() const;
+};
+
+template <typename Body>
+void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grain, Body body) {
+    if (end <= begin) return;
+    grain = std::max<size_t>(1, grain);
+    size_t chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1) {
+        body(begin, end);
+        return;
+    }
+
+    // Lives on this stack frame: every task has finished with it
+    // before we return.
+    std::atomic<size_t> remaining{chunks - 1};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto runChunk = [&](size_t chunk) {
+        size_t first = begin + chunk * grain;
+        size_t last = std::min(end, first + grain);
+        try {
+            body(first, last);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        submit([&, chunk] {
+            runChunk(chunk);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    runChunk(0);
+
+    // Help out until every chunk is done.
+    size_t self = currentWorker();
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+template <typename T, typename Map, typename Combine>
+T TaskScheduler::parallelReduce(size_t begin, size_t end, size_t grain, T identity, Map map,
+                                Combine combine) {
+    if (end <= begin) return identity;
+    grain = std::max<size_t>(1, grain);
+    size_t chunks = (end - begin + grain - 1) / grain;
+
+    std::vector<T> partial(chunks, identity);
+    parallelFor(0, chunks, 1, [&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            size_t from = begin + chunk * grain;
+            partial[chunk] = map(from, std::min(end, from + grain));
+        }
+    });
+
+    T result = std::move(identity);
+    for (T& value : partial) result = combine(std::move(result), std::move(value));
+    return result;
+}
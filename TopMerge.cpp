@@ -0,0 +1,222 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: TopMerge.cpp
+// ------------------------------------------------------------
+// Per-file top N and k-way merge (see TopMerge.h).
+// ------------------------------------------------------------
+
+#include "TopMerge.h"
+#include "FileChecksum.h"
+#include "SoccerLog.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+using namespace std;
+
+namespace TopMerge {
+
+namespace {
+
+using Row = pair<string, int>;
+
+// Most goals first, ties by name (the order of Soccer::topPlayers).
+bool better(const Row& a, const Row& b) {
+    if (a.second != b.second) return a.second > b.second;
+    return a.first < b.first;
+}
+
+// Keeps the 'n' best rows offered so far. The heap's front is the
+// weakest of them, so a row that can't get in costs one compare
+// and its name is never copied.
+class BestRows {
+public:
+    explicit BestRows(size_t n) : n_(n) {}
+
+    void offer(string_view name, int goals) {
+        if (n_ == 0) return;
+        if (rows_.size() == n_) {
+            const Row& weakest = rows_.front();
+            if (goals < weakest.second || (goals == weakest.second && name >= weakest.first)) return;
+            pop_heap(rows_.begin(), rows_.end(), better);
+            rows_.pop_back();
+        }
+        rows_.push_back({string(name), goals});
+        push_heap(rows_.begin(), rows_.end(), better);
+    }
+
+    vector<Row> sorted() {
+        sort(rows_.begin(), rows_.end(), better);
+        return move(rows_);
+    }
+
+private:
+    size_t n_;
+    vector<Row> rows_;
+};
+
+// What a player's log records do to the league. Whether a record
+// changes existing rows or adds one depends on whether the player
+// is in the file, which isn't known until the file has been read –
+// so both outcomes are worked out while the log is replayed:
+//
+//   - in the file:  every file row is changed by 'set'/'value'
+//                   ("=value" or "+value"), and 'added' holds the
+//                   rows appended after them
+//   - not in file:  'alone' holds the rows the log creates
+struct LogEffect {
+    bool set = false;
+    int value = 0;
+    vector<int> added;
+    vector<int> alone;
+
+    void apply(char op, int v) {
+        if (op == '#') {
+            added.push_back(v);
+            alone.push_back(v);
+            return;
+        }
+        if (op == '=') {
+            set = true;
+            value = v;
+        } else {
+            value += v;
+        }
+        change(added, op, v);
+        if (alone.empty()) {
+            alone.push_back(v);        // The first '+' or '=' adds the player
+        } else {
+            change(alone, op, v);
+        }
+    }
+
+    int onFileRow(int goals) const { return set ? value : goals + value; }
+
+private:
+    static void change(vector<int>& rows, char op, int v) {
+        for (int& goals : rows) goals = (op == '=') ? v : goals + v;
+    }
+};
+
+} // namespace
+
+// ------------------------------------------------------------
+// Function: topOfFile
+// ------------------------------------------------------------
+// Notes:
+//   - Logged records apply to every row with that name, and a name
+//     that is only in the log counts as a new row – exactly what
+//     loading the file into Soccer would give.
+//   - Lines are read like Soccer reads them (SoccerLog::parseRow).
+//     A block that doesn't match its checksum (see FileChecksum.h)
+//     is only reported; its lines still count.
+//   - A team file of a team directory has no log of its own: the
+//     league's changes are in "<dir>/league.log" (see Soccer.h),
+//     and which team's rows they change depends on every team
+//     file. While that log holds records, the file is refused.
+// ------------------------------------------------------------
+bool topOfFile(const string& path, size_t n, vector<Row>& top) {
+    SoccerLog log(path + ".log");
+    if (log.empty()) {
+        SoccerLog leagueLog((filesystem::path(path).parent_path() / "league.log").string());
+        if (!leagueLog.empty()) {
+            cerr << "Error: " << path << " is a team file with changes waiting in " << leagueLog.path()
+                 << "; load the whole team directory instead.\n";
+            return false;
+        }
+    }
+
+    unordered_map<string, LogEffect> effects;
+    if (!log.empty()) {
+        log.replay([&effects](string_view name, char op, int value) { effects[string(name)].apply(op, value); });
+    }
+    unordered_map<string_view, bool> seen;   // Names of 'effects' found in the file
+
+    ifstream in(path);
+    if (!in) {
+        cerr << "Error: Could not open " << path << " for reading.\n";
+        return false;
+    }
+
+    FileChecksum::Report report = FileChecksum::verifyFile(path);
+    if (!report.ok()) {
+        cerr << "Warning: " << report.damaged.size() << " block(s) of " << path
+             << " don't match their checksum.\n";
+    }
+
+    BestRows best(n);
+    string line;
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+
+        string_view name;
+        int goals;
+        if (!SoccerLog::parseRow(line, name, goals)) continue;   // Soccer skips it too
+        if (!effects.empty()) {
+            auto it = effects.find(string(name));
+            if (it != effects.end()) {
+                goals = it->second.onFileRow(goals);
+                seen[it->first] = true;
+            }
+        }
+        best.offer(name, goals);
+    }
+
+    for (const auto& effect : effects) {
+        const vector<int>& rows = seen.count(effect.first) ? effect.second.added : effect.second.alone;
+        for (int goals : rows) best.offer(effect.first, goals);
+    }
+    top = best.sorted();
+    return true;
+}
+
+// ------------------------------------------------------------
+// Function: merge
+// ------------------------------------------------------------
+// The heap holds one (list, position) cursor per list that still
+// has rows; its top is the list whose next row is the best. Each
+// of the 'n' steps takes that row and moves the cursor along:
+// O(n log k) for k lists.
+// ------------------------------------------------------------
+vector<Row> merge(const vector<vector<Row>>& lists, size_t n) {
+    using Cursor = pair<size_t, size_t>;   // (list, position)
+    auto worse = [&lists](const Cursor& a, const Cursor& b) {
+        return better(lists[b.first][b.second], lists[a.first][a.second]);
+    };
+    priority_queue<Cursor, vector<Cursor>, decltype(worse)> heads(worse);
+    for (size_t i = 0; i < lists.size(); ++i) {
+        if (!lists[i].empty()) heads.push({i, 0});
+    }
+
+    vector<Row> top;
+    while (top.size() < n && !heads.empty()) {
+        Cursor cursor = heads.top();
+        heads.pop();
+        top.push_back(lists[cursor.first][cursor.second]);
+        if (++cursor.second < lists[cursor.first].size()) heads.push(cursor);
+    }
+    return top;
+}
+
+// ------------------------------------------------------------
+// Function: topAcrossFiles
+// ------------------------------------------------------------
+bool topAcrossFiles(const vector<string>& paths, size_t n, vector<Row>& top) {
+    vector<vector<Row>> lists(paths.size());
+    vector<char> readable(paths.size(), 0);
+
+    TaskScheduler::shared().parallelFor(0, paths.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            readable[i] = topOfFile(paths[i], n, lists[i]);
+        }
+    });
+
+    top = merge(lists, n);
+    return find(readable.begin(), readable.end(), 0) == readable.end();
+}
+
+} // namespace TopMerge
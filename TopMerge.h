@@ -0,0 +1,68 @@
+//
+// Module 9 - Streams and Files
+// Header File: TopMerge.h
+// ------------------------------------------------------------
+// League-wide leaderboards over many stat files, without loading
+// any of them into a Soccer table.
+//
+// The top N of the whole league is always among the top N of the
+// individual files. So:
+//
+//   1. Every file is read line by line, keeping only its N best
+//      rows in a small heap (one task per file, in parallel on the
+//      shared TaskScheduler).
+//   2. The per-file lists, each already sorted, are combined with
+//      a k-way merge: a heap holding the current head of every
+//      list hands out the overall best row N times.
+//
+// Memory is O(files · N) however big the files are, and each file
+// is read exactly once.
+//
+// merge() works on any sorted lists, so it can also combine top-N
+// answers from other sources (e.g. several servers).
+//
+// Example:
+//   std::vector<std::pair<std::string, int>> best;
+//   TopMerge::topAcrossFiles({"arsenal.csv", "chelsea.csv"}, 10, best);
+// ------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+namespace TopMerge {
+
+// ------------------------------------------------------------
+// Function: topOfFile
+// ------------------------------------------------------------
+// The 'n' best "Name,Goals" rows of one file, highest first (ties
+// by name, like Soccer::topPlayers). Changes still waiting in
+// the file's update log (file + ".log", see SoccerLog.h) are
+// counted. Returns false (with a message on cerr) if the file
+// can't be read, or if it is a team file whose directory's
+// "league.log" still holds changes.
+// ------------------------------------------------------------
+bool topOfFile(const std::string& path, size_t n, std::vector<std::pair<std::string, int>>& top);
+
+// ------------------------------------------------------------
+// Function: merge
+// ------------------------------------------------------------
+// The 'n' best rows of several lists that are each sorted highest
+// first, in the same order.
+// ------------------------------------------------------------
+std::vector<std::pair<std::string, int>> merge(const std::vector<std::vector<std::pair<std::string, int>>>& lists,
+                                               size_t n);
+
+// ------------------------------------------------------------
+// Function: topAcrossFiles
+// ------------------------------------------------------------
+// topOfFile() for every file in parallel, then merge(). Files it
+// refuses are left out; the result is still the top of the
+// others, but the function returns false.
+// ------------------------------------------------------------
+bool topAcrossFiles(const std::vector<std::string>& paths, size_t n,
+                    std::vector<std::pair<std::string, int>>& top);
+
+} // namespace TopMerge
@@ -0,0 +1,177 @@
+//
+// Module 9 - Streams and Files
+// Implementation File: UpdateBuffer.cpp
+// ------------------------------------------------------------
+// Coalescing write buffer for player updates (see UpdateBuffer.h).
+//
+// Locking: flushMutex_ is taken before mutex_, and mutex_ is never
+// held while the league is written, so update() never waits for
+// the disk – only flush() and addPlayer() do.
+// ------------------------------------------------------------
+
+#include "UpdateBuffer.h"
+#include <algorithm>
+using namespace std;
+
+UpdateBuffer::UpdateBuffer(Soccer& league, UpdateBufferOptions options)
+    : league_(league), options_(options) {
+    options_.maxPendingPlayers = max<size_t>(1, options_.maxPendingPlayers);
+    options_.flushIntervalMs = max(0, options_.flushIntervalMs);
+    flusher_ = thread(&UpdateBuffer::flushLoop, this);
+}
+
+UpdateBuffer::~UpdateBuffer() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    flusher_.join();
+    flush();
+}
+
+// ------------------------------------------------------------
+// Helper Function: put
+// ------------------------------------------------------------
+void UpdateBuffer::put(const string& name, int goals) {
+    ++stats_.updates;
+
+    auto it = slot_.find(name);
+    if (it != slot_.end()) {
+        pending_[it->second].second = goals;   // The newer value wins
+        ++stats_.coalesced;
+        return;
+    }
+
+    if (pending_.empty()) oldest_ = chrono::steady_clock::now();
+    slot_.emplace(name, pending_.size());
+    pending_.push_back({name, goals});
+}
+
+// ------------------------------------------------------------
+// Function: update / updateMany
+// ------------------------------------------------------------
+void UpdateBuffer::update(const string& name, int goals) {
+    bool wake;
+    {
+        lock_guard<mutex> lock(mutex_);
+        put(name, goals);
+        // The flusher waits for a first entry, then for a full buffer.
+        wake = pending_.size() == 1 || pending_.size() >= options_.maxPendingPlayers;
+    }
+    if (wake) wake_.notify_one();
+}
+
+void UpdateBuffer::updateMany(const vector<pair<string, int>>& updates) {
+    if (updates.empty()) return;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (const auto& u : updates) {
+            put(u.first, u.second);
+        }
+    }
+    wake_.notify_one();
+}
+
+// ------------------------------------------------------------
+// Function: addPlayer
+// ------------------------------------------------------------
+// Holding flushMutex_ for the whole call means no flush is in
+// flight: an update that flush() already took out of pending_
+// (it is in writing_) has reached the league before the row is
+// added, and can't be written after it.
+// ------------------------------------------------------------
+bool UpdateBuffer::addPlayer(const string& name, int goals) {
+    lock_guard<mutex> flushLock(flushMutex_);
+    bool pending;
+    {
+        lock_guard<mutex> lock(mutex_);
+        pending = slot_.count(name) != 0;
+    }
+    if (pending) flushLocked();
+    return league_.addPlayer(name, goals);
+}
+
+// ------------------------------------------------------------
+// Function: find
+// ------------------------------------------------------------
+bool UpdateBuffer::find(const string& name, int& goals) const {
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = slot_.find(name);
+        if (it != slot_.end()) {
+            goals = pending_[it->second].second;
+            return true;
+        }
+        auto writing = writing_.find(name);
+        if (writing != writing_.end()) {   // Maybe not in the league yet
+            goals = writing->second;
+            return true;
+        }
+    }
+    return league_.findPlayer(name, goals);
+}
+
+// ------------------------------------------------------------
+// Function: flush
+// ------------------------------------------------------------
+// The pending updates are swapped out under mutex_, so update()
+// can fill a new batch while this one is being written. Until the
+// league has it, find() answers from writing_.
+// ------------------------------------------------------------
+void UpdateBuffer::flush() {
+    lock_guard<mutex> flushLock(flushMutex_);
+    flushLocked();
+}
+
+void UpdateBuffer::flushLocked() {
+    vector<pair<string, int>> batch;
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (pending_.empty()) return;
+        batch.swap(pending_);
+        slot_.clear();
+        writing_.insert(batch.begin(), batch.end());
+        ++stats_.flushes;
+        stats_.playersWritten += batch.size();
+    }
+    league_.updatePlayers(batch);
+
+    lock_guard<mutex> lock(mutex_);
+    writing_.clear();
+}
+
+// ------------------------------------------------------------
+// Helper Function: flushLoop
+// ------------------------------------------------------------
+// Sleeps until something is pending, then until the oldest update
+// is 'flushIntervalMs' old – or until the buffer is full, which
+// update() wakes it up for.
+// ------------------------------------------------------------
+void UpdateBuffer::flushLoop() {
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        if (stopping_) return;
+
+        auto deadline = oldest_ + chrono::milliseconds(options_.flushIntervalMs);
+        wake_.wait_until(lock, deadline, [this] {
+            return stopping_ || pending_.size() >= options_.maxPendingPlayers;
+        });
+        if (stopping_) return;   // The destructor flushes the rest
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+// ------------------------------------------------------------
+// Function: stats
+// ------------------------------------------------------------
+UpdateBufferStats UpdateBuffer::stats() const {
+    lock_guard<mutex> lock(mutex_);
+    UpdateBufferStats s = stats_;
+    s.pending = pending_.size();
+    return s;
+}
@@ -0,0 +1,133 @@
+//
+// Module 9 - Streams and Files
+// Header File: UpdateBuffer.h
+// ------------------------------------------------------------
+// A write buffer in front of Soccer::updatePlayer() that collapses
+// rapid repeated updates of the same player into one.
+//
+// Every updatePlayer() call writes (and syncs) a log record. During
+// a match the same player may be updated many times within
+// milliseconds, and only the last value matters. UpdateBuffer keeps the pending
+// value per player (a later update simply overwrites an earlier one)
+// and hands all of them to Soccer::updatePlayers() together:
+//
+//     update("Messi", 13)  ┐
+//     update("Messi", 14)  ├─ pending: Messi → 15, Rapinoe → 10
+//     update("Rapinoe", 10)│
+//     update("Messi", 15)  ┘   ──flush──▶ updatePlayers(...)  (one append)
+//
+// A flush happens on a background thread when the oldest pending
+// update has waited 'flushIntervalMs', or as soon as
+// 'maxPendingPlayers' different players are waiting. So the number
+// of log writes depends on time and on how many DIFFERENT players
+// changed, not on how many updates arrived.
+//
+// The price: an update is only in the file after its flush. Until
+// then find() sees it, but the league's own reads (top, count, ...)
+// don't, and a crash loses it.
+//
+// Example:
+//   UpdateBuffer buffer(league, {/*maxPendingPlayers*/ 1024, /*flushIntervalMs*/ 20});
+//   buffer.update("Messi", 13);    // returns at once
+//   buffer.update("Messi", 14);    // replaces the 13
+//   buffer.flush();                // or wait up to 20 ms
+// ------------------------------------------------------------
+
+#pragma once
+#include "Soccer.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct UpdateBufferOptions {
+    size_t maxPendingPlayers = 4096;   // Flush once this many players are waiting
+    int flushIntervalMs = 50;          // ...or once the oldest update has waited this long
+};
+
+// ------------------------------------------------------------
+// Struct: UpdateBufferStats
+// ------------------------------------------------------------
+//   updates        → update() calls so far
+//   coalesced      → updates that replaced a still-pending value
+//   flushes        → updatePlayers() calls (log appends)
+//   playersWritten → players written by those flushes
+//   pending        → players waiting right now
+// ------------------------------------------------------------
+struct UpdateBufferStats {
+    uint64_t updates = 0;
+    uint64_t coalesced = 0;
+    uint64_t flushes = 0;
+    uint64_t playersWritten = 0;
+    size_t pending = 0;
+};
+
+class UpdateBuffer {
+public:
+    // 'league' must outlive the buffer.
+    explicit UpdateBuffer(Soccer& league, UpdateBufferOptions options = {});
+
+    // Flushes what is still pending.
+    ~UpdateBuffer();
+
+    UpdateBuffer(const UpdateBuffer&) = delete;
+    UpdateBuffer& operator=(const UpdateBuffer&) = delete;
+
+    // ------------------------------------------------------------
+    // Function: update / updateMany
+    // ------------------------------------------------------------
+    // Sets a player's goals, like Soccer::updatePlayer(), but only in
+    // the buffer. Returns at once; the last value per player wins.
+    // ------------------------------------------------------------
+    void update(const std::string& name, int goals);
+    void updateMany(const std::vector<std::pair<std::string, int>>& updates);
+
+    // ------------------------------------------------------------
+    // Function: addPlayer
+    // ------------------------------------------------------------
+    // Soccer::addPlayer(), after flushing a pending update of the
+    // same player and waiting for a flush that is writing one – so
+    // the new row isn't overwritten by an update that was made
+    // before it existed. Returns what
+    // Soccer::addPlayer() returns.
+    // ------------------------------------------------------------
+    bool addPlayer(const std::string& name, int goals);
+
+    // ------------------------------------------------------------
+    // Function: find
+    // ------------------------------------------------------------
+    // Like Soccer::findPlayer(), but a pending update is returned
+    // instead of the value in the league ("read your own writes").
+    // ------------------------------------------------------------
+    bool find(const std::string& name, int& goals) const;
+
+    // Writes everything pending now and returns when it is in the file.
+    void flush();
+
+    UpdateBufferStats stats() const;
+
+private:
+    Soccer& league_;
+    UpdateBufferOptions options_;
+
+    mutable std::mutex mutex_;       // Protects everything below
+    std::condition_variable wake_;
+    std::unordered_map<std::string, size_t, NameHash, std::equal_to<>> slot_;   // name → position in pending_
+    std::vector<std::pair<std::string, int>> pending_;   // In order of each player's first update
+    std::unordered_map<std::string, int, NameHash, std::equal_to<>> writing_;   // The batch flush() is writing
+    std::chrono::steady_clock::time_point oldest_;       // When pending_ got its first entry
+    UpdateBufferStats stats_;
+    bool stopping_ = false;
+
+    std::mutex flushMutex_;          // One flush at a time, so batches reach the league in order
+    std::thread flusher_;
+
+    void put(const std::string& name, int goals);   // Caller holds mutex_
+    void flushLocked();                             // Caller holds flushMutex_
+    void flushLoop();
+};
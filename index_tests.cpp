@@ -0,0 +1,366 @@
+//
+// Module 9 - Streams and Files
+// Test Program: index_tests.cpp
+// ------------------------------------------------------------
+// Checks the hand-written index structures against brute-force
+// references built from the standard library:
+//
+//   CrackedColumn  count / rows after random appends and updates
+//                  vs a linear scan of a plain vector
+//   RoaringBitmap  contains / cardinality / forEach / andCardinality
+//                  / intersect vs std::set, with containers pushed
+//                  across the array <-> bitmap conversion
+//   SpscQueue      every item arrives once and in order with a
+//                  producer and a consumer on separate threads
+//   PlayerFilter   random goals ranges (including INT_MIN and
+//                  INT_MAX) vs evaluating the comparisons directly
+//
+// Random inputs come from a fixed seed, so a failure can be
+// replayed. Prints one line per structure; exits 1 if any check
+// failed. Built as the "index_tests" target and run by ctest.
+// ------------------------------------------------------------
+
+#include "CrackedColumn.h"
+#include "RoaringBitmap.h"
+#include "SpscQueue.h"
+#include "PlayerFilter.h"
+#include <iostream>
+#include <vector>
+#include <set>
+#include <string>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <climits>
+#include <cstdint>
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+// ------------------------------------------------------------
+// Function: check
+// ------------------------------------------------------------
+// Records a failed check and prints what was being tested. Only
+// the first few failures are printed, so a broken structure
+// doesn't flood the terminal.
+// ------------------------------------------------------------
+bool check(bool ok, const string& what) {
+    if (!ok) {
+        if (failures < 20) cerr << "FAIL: " << what << endl;
+        ++failures;
+    }
+    return ok;
+}
+
+void report(const string& name, int failuresBefore) {
+    cout << (failures == failuresBefore ? "ok   " : "FAIL ") << name << endl;
+}
+
+// ============================================================
+// CrackedColumn
+// ============================================================
+
+size_t scanCount(const vector<int>& goals, int low, int high) {
+    size_t n = 0;
+    for (int g : goals) {
+        if (g >= low && g <= high) ++n;
+    }
+    return n;
+}
+
+vector<uint32_t> scanRows(const vector<int>& goals, int low, int high) {
+    vector<uint32_t> rows;
+    for (size_t row = 0; row < goals.size(); ++row) {
+        if (goals[row] >= low && goals[row] <= high) rows.push_back(uint32_t(row));
+    }
+    return rows;
+}
+
+void testCrackedColumn(mt19937& random) {
+    int before = failures;
+
+    // Values from a small range so cracks and duplicates pile up,
+    // plus the extremes so the INT64 crack bounds get exercised.
+    uniform_int_distribution<int> small(-5, 40);
+    auto value = [&]() {
+        int pick = int(random() % 50);
+        if (pick == 0) return INT_MIN;
+        if (pick == 1) return INT_MAX;
+        return small(random);
+    };
+
+    vector<int> goals(500);
+    for (int& g : goals) g = value();
+    CrackedColumn column;
+    column.reset(goals);
+
+    for (int round = 0; round < 3000; ++round) {
+        int action = int(random() % 10);
+        if (action < 5) {
+            uint32_t row = uint32_t(random() % goals.size());
+            int newGoals = value();
+            column.update(row, goals[row], newGoals);
+            goals[row] = newGoals;
+        } else if (action < 6) {
+            goals.push_back(value());
+            column.append(uint32_t(goals.size() - 1), goals.back());
+        } else {
+            int low = value(), high = value();
+            if (random() % 4 == 0) swap(low, high);   // Sometimes an empty range
+            string range = to_string(low) + ".." + to_string(high);
+
+            check(column.count(low, high) == scanCount(goals, low, high),
+                  "CrackedColumn count " + range + " in round " + to_string(round));
+
+            vector<uint32_t> rows = column.rows(low, high);
+            sort(rows.begin(), rows.end());
+            check(rows == scanRows(goals, low, high),
+                  "CrackedColumn rows " + range + " in round " + to_string(round));
+        }
+    }
+
+    // The full range must always see every row exactly once.
+    vector<uint32_t> all = column.rows(INT_MIN, INT_MAX);
+    sort(all.begin(), all.end());
+    check(all == scanRows(goals, INT_MIN, INT_MAX), "CrackedColumn rows INT_MIN..INT_MAX");
+    report("CrackedColumn (" + to_string(column.cracks()) + " cracks)", before);
+}
+
+// ============================================================
+// RoaringBitmap
+// ============================================================
+
+bool sameValues(const RoaringBitmap& bitmap, const set<uint32_t>& reference) {
+    vector<uint32_t> values;
+    bitmap.forEach([&](uint32_t v) { values.push_back(v); });
+    return bitmap.cardinality() == reference.size() &&
+           bitmap.empty() == reference.empty() &&
+           equal(values.begin(), values.end(), reference.begin(), reference.end());
+}
+
+void testRoaringBitmap(mt19937& random) {
+    int before = failures;
+
+    // Three 65536-value containers: 'a' and 'b' fill them past
+    // ARRAY_LIMIT (4096) to force bitmaps, then remove values until
+    // they drop back to arrays. A fourth key holds a single value.
+    RoaringBitmap a, b;
+    set<uint32_t> setA, setB;
+    auto randomValue = [&]() {
+        uint32_t key = uint32_t(random() % 3) * 7;   // Keys 0, 7, 14
+        return (key << 16) | uint32_t(random() % 12000);
+    };
+
+    auto compare = [&](const string& when) {
+        check(sameValues(a, setA), "RoaringBitmap a values " + when);
+        check(sameValues(b, setB), "RoaringBitmap b values " + when);
+
+        vector<uint32_t> both;
+        set_intersection(setA.begin(), setA.end(), setB.begin(), setB.end(),
+                         back_inserter(both));
+        check(RoaringBitmap::andCardinality(a, b) == both.size(),
+              "RoaringBitmap andCardinality " + when);
+        check(RoaringBitmap::andCardinality(b, a) == both.size(),
+              "RoaringBitmap andCardinality (swapped) " + when);
+        check(sameValues(RoaringBitmap::intersect(a, b), set<uint32_t>(both.begin(), both.end())),
+              "RoaringBitmap intersect " + when);
+
+        for (int probe = 0; probe < 200; ++probe) {
+            uint32_t v = randomValue();
+            check(a.contains(v) == (setA.count(v) != 0),
+                  "RoaringBitmap contains " + to_string(v) + " " + when);
+        }
+    };
+
+    a.add(UINT32_MAX);
+    setA.insert(UINT32_MAX);
+    b.add(UINT32_MAX);
+    setB.insert(UINT32_MAX);
+
+    // Grow: each key passes 4096 values in 'a', stays sparser in 'b'.
+    for (int i = 0; i < 30000; ++i) {
+        uint32_t v = randomValue();
+        a.add(v);
+        setA.insert(v);
+        if (i % 3 == 0) {
+            uint32_t w = randomValue();
+            b.add(w);
+            setB.insert(w);
+        }
+        if (i % 5000 == 4999) compare("after " + to_string(i + 1) + " adds");
+    }
+
+    // Shrink: remove until each container is back under the limit
+    // and finally empty, checking on the way down.
+    vector<uint32_t> values(setA.begin(), setA.end());
+    shuffle(values.begin(), values.end(), random);
+    for (size_t i = 0; i < values.size(); ++i) {
+        a.remove(values[i]);
+        setA.erase(values[i]);
+        a.remove(values[i]);   // Removing twice is harmless
+        if (i % 2500 == 0) compare("after " + to_string(i + 1) + " removes");
+    }
+    compare("with 'a' empty");
+    check(a.empty(), "RoaringBitmap empty after removing every value");
+    report("RoaringBitmap", before);
+}
+
+// ============================================================
+// SpscQueue
+// ============================================================
+
+void testSpscQueue() {
+    int before = failures;
+    const uint64_t ITEMS = 200000;
+
+    // A tiny queue, so the producer keeps wrapping and waiting.
+    SpscQueue<uint64_t> queue(8);
+    thread producer([&]() {
+        for (uint64_t i = 0; i < ITEMS; ++i) queue.push(i);
+        queue.close();
+    });
+
+    uint64_t expected = 0, item = 0;
+    bool inOrder = true;
+    while (queue.pop(item)) {
+        if (item != expected) inOrder = false;
+        ++expected;
+    }
+    producer.join();
+
+    check(inOrder, "SpscQueue items arrive in push order");
+    check(expected == ITEMS, "SpscQueue delivers every item (" + to_string(expected) + ")");
+
+    // After close() and with nothing left, waits end straight away.
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    check(queue.popUntil(item, deadline) == SpscQueue<uint64_t>::PopResult::CLOSED,
+          "SpscQueue popUntil reports CLOSED once drained");
+
+    QueueMetrics metrics = queue.metrics();
+    check(metrics.capacity == 8, "SpscQueue rounds capacity to a power of two");
+    check(metrics.pushes == ITEMS, "SpscQueue counts every push");
+    check(metrics.highWater <= metrics.capacity, "SpscQueue never holds more than its capacity");
+
+    // An open, empty queue times out instead.
+    SpscQueue<int> idle(3);
+    int value = 0;
+    check(idle.popUntil(value, chrono::steady_clock::now() + chrono::milliseconds(5)) ==
+              SpscQueue<int>::PopResult::TIMEOUT,
+          "SpscQueue popUntil times out on an open, empty queue");
+    report("SpscQueue", before);
+}
+
+// ============================================================
+// PlayerFilter
+// ============================================================
+
+// One goals comparison, evaluated the obvious way.
+struct Comparison {
+    string op;
+    int64_t value;
+
+    bool matches(int goals) const {
+        if (op == "=" || op == "==") return goals == value;
+        if (op == "!=") return goals != value;
+        if (op == "<") return goals < value;
+        if (op == "<=") return goals <= value;
+        if (op == ">") return goals > value;
+        return goals >= value;
+    }
+
+    string text() const { return "goals " + op + " " + to_string(value); }
+};
+
+void testPlayerFilter(mt19937& random) {
+    int before = failures;
+
+    // Goals near zero and at both ends of int, so ranges that end at
+    // INT_MIN / INT_MAX (and "< INT_MIN", "> INT_MAX") get folded.
+    const vector<int64_t> edges = {INT_MIN, INT_MIN + 1LL, -3, -1, 0, 1, 2, 5,
+                                   INT_MAX - 1LL, INT_MAX};
+    const vector<string> ops = {"=", "==", "!=", "<", "<=", ">", ">="};
+
+    vector<int> goals;
+    vector<string> names;
+    for (int64_t edge : edges) {
+        goals.push_back(int(edge));
+        names.push_back("Edge" + to_string(edge));
+    }
+    // Enough rows to span several BATCH_SIZE batches.
+    uniform_int_distribution<int> small(-4, 6);
+    while (goals.size() < 3 * PlayerFilter::BATCH_SIZE + 17) {
+        goals.push_back(random() % 8 == 0 ? int(edges[random() % edges.size()]) : small(random));
+        names.push_back("Player" + to_string(goals.size()));
+    }
+
+    auto randomComparison = [&]() {
+        Comparison c;
+        c.op = ops[random() % ops.size()];
+        c.value = random() % 2 ? edges[random() % edges.size()] : small(random);
+        return c;
+    };
+
+    for (int round = 0; round < 400; ++round) {
+        Comparison x = randomComparison(), y = randomComparison(), z = randomComparison();
+        int shape = round % 5;
+
+        string text;
+        vector<uint32_t> expected;
+        for (size_t row = 0; row < goals.size(); ++row) {
+            int g = goals[row];
+            bool match = false;
+            switch (shape) {
+                case 0: match = x.matches(g); break;
+                case 1: match = x.matches(g) && y.matches(g); break;
+                case 2: match = x.matches(g) || y.matches(g); break;
+                case 3: match = !(x.matches(g) && y.matches(g)); break;
+                default: match = (x.matches(g) || y.matches(g)) && !z.matches(g); break;
+            }
+            if (match) expected.push_back(uint32_t(row));
+        }
+        switch (shape) {
+            case 0: text = x.text(); break;
+            case 1: text = x.text() + " and " + y.text(); break;
+            case 2: text = x.text() + " or " + y.text(); break;
+            case 3: text = "not (" + x.text() + " and " + y.text() + ")"; break;
+            default: text = "(" + x.text() + " or " + y.text() + ") and not " + z.text(); break;
+        }
+
+        PlayerFilter filter;
+        string error;
+        if (!check(PlayerFilter::compile(text, filter, error), "PlayerFilter compile \"" + text + "\": " + error)) {
+            continue;
+        }
+        check(filter.select(names.data(), goals.data(), goals.size()) == expected,
+              "PlayerFilter select \"" + text + "\"");
+    }
+
+    // Numbers outside int are refused rather than wrapped.
+    PlayerFilter filter;
+    string error;
+    check(!PlayerFilter::compile("goals > 2147483648", filter, error),
+          "PlayerFilter refuses a number above INT_MAX");
+    check(!PlayerFilter::compile("goals < -2147483649", filter, error),
+          "PlayerFilter refuses a number below INT_MIN");
+    report("PlayerFilter", before);
+}
+
+}   // namespace
+
+int main() {
+    mt19937 random(20240611);
+    testCrackedColumn(random);
+    testRoaringBitmap(random);
+    testSpscQueue();
+    testPlayerFilter(random);
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -15,11 +15,96 @@
 //    Rapinoe,9
 //
 // Students can view, add, or update records.
+//
+// Running modes:
+//   ./Module9_Code_Together
+//       → interactive menu (the default)
+//   ./Module9_Code_Together serve [socket] [file] [shm]
+//       → keep the league in memory and answer requests over a
+//         Unix domain socket (see SoccerServer.h). Defaults:
+//         /tmp/soccer.sock and soccer.csv. Ctrl+C stops it.
+//         If 'shm' (e.g. /soccer_snapshot) is given, the table is
+//         also published to shared memory (see SoccerSnapshot.h).
+//         Replication (see SoccerReplication.h):
+//           --primary SOCKET     ship every change to the replicas
+//                                that connect to SOCKET
+//           --replica-of SOCKET  start 'file' empty, copy the primary
+//                                listening on SOCKET and stay in step;
+//                                writes are refused (reads only)
+//         Update coalescing (see UpdateBuffer.h):
+//           --coalesce-ms N       hold updates up to N ms and write
+//                                 only each player's last value
+//           --coalesce-players N  ...or write once N players wait
+//                                 (default 4096)
+//         "soccer_client stats" shows the replication and coalescing
+//         counters.
+//   ./Module9_Code_Together [-f file] view | get | add | update | top | import ...
+//       → 'file' may also be a directory or a quoted pattern
+//         ("teams/*.csv") of one file per team (see Soccer.h)
+//   ./Module9_Code_Together [-f file] query "goals >= 10 and name startswith 'R'"
+//       → print every player matching a filter (see PlayerFilter.h)
+//   ./Module9_Code_Together [-f file] batch
+//       → run one command (or a stream of commands from stdin)
+//         without menus or prompts (see SoccerCommands.h).
+//   ./Module9_Code_Together leagues DIR [--budget-mb N] [--max-loaded N]
+//       → host every DIR/*.csv league in this one process and run
+//         batch commands from stdin; "use NAME" picks the league
+//         (see LeagueManager.h). Leagues are loaded on first use and
+//         the least recently used ones are evicted when the loaded
+//         tables outgrow N MB (default 256).
+//   ./Module9_Code_Together topmerge N FILE...
+//       → the N best scorers over all the FILEs, without loading
+//         them: each file's own top N is found in parallel and the
+//         lists are merged (see TopMerge.h). Prints "Name,Goals".
+//         Team files are refused while their directory's
+//         league.log holds changes; use "-f DIR top N" then.
+//   ./Module9_Code_Together verify FILE...
+//       → check each FILE against its block checksums (FILE.crc,
+//         see FileChecksum.h) and print "file,blocks,damaged".
+//         Exits with 1 if anything is damaged.
+//   ./Module9_Code_Together cluster N [dir] [socket-prefix]
+//       → start N "serve" processes that share one league between
+//         them: shard i keeps its players in dir/shard-i.csv and
+//         listens on socket-prefix-i.sock (defaults: "." and
+//         /tmp/soccer-shard). Use "soccer_client -c" with the
+//         printed socket list to talk to them (see ShardRouter.h).
+//         Ctrl+C stops every shard.
+//   ./Module9_Code_Together [-f file] ingest [source] [options]
+//       → apply a live stream of "Name,+1" goal events from a file,
+//         FIFO or stdin ("-", the default). Options:
+//           --follow        keep waiting for more input (tail -f)
+//           --batch N       apply after N events (default 65536)
+//           --delay-ms N    ...or after N ms (default 5)
+//           --no-sync       skip fdatasync on the update log
+//           --dedupe-window S  ignore repeated ",id=KEY" events for
+//                           S seconds (default 600, 0 = off)
+//           --dedupe-keys N remember at most N ids per window
+//           --pipeline      parse, validate, log and apply on four
+//                           threads (see IngestPipeline.h)
+//         A "key=value" summary (rate, latency) is printed to stderr.
 // ---------------------------------------------
 
 #include <iostream>
 #include <limits>   // for numeric_limits (used when clearing input buffer)
+#include <string>
+#include <csignal>  // for signal (Ctrl+C handling in server mode)
 #include "Soccer.h" // our custom class that handles file operations
+#include "SoccerServer.h"
+#include "SoccerCommands.h"
+#include "GoalIngestor.h"
+#include "IngestPipeline.h"
+#include "LeagueManager.h"
+#include "TopMerge.h"
+#include "FileChecksum.h"
+#include "SoccerReplication.h"
+#include "UpdateBuffer.h"
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>     // for fork, execv (cluster mode)
+#include <sys/wait.h>   // for waitpid
+#include <cerrno>
+#include <climits>    // for INT_MAX (server counters)
 using namespace std;
 
 // Define menu options for readability
@@ -28,7 +113,61 @@ enum MenuOptions { VIEW = 1, ADD, UPDATE, QUIT };
 // Function prototype for displaying the menu
 int menu();
 
-int main() {
+// Function prototype for reading a goal count typed by the user
+bool readGoals(int& goals);
+
+// Function prototype for the socket server mode
+int runServer(int argc, char* argv[]);
+
+// Function prototype for the non-interactive command mode
+int runScript(int argc, char* argv[]);
+
+// Function prototype for the goal event ingest mode
+int runIngest(Soccer& league, const vector<string>& args);
+
+// Function prototype for the multi-league batch mode
+int runLeagues(int argc, char* argv[]);
+
+// Function prototype for the multi-file leaderboard mode
+int runTopMerge(int argc, char* argv[]);
+
+// Function prototype for the sharded multi-process mode
+int runCluster(int argc, char* argv[]);
+
+// Function prototype for the file integrity check
+int runVerify(int argc, char* argv[]);
+
+int main(int argc, char* argv[]) {
+
+    // "serve" runs the long-lived socket server instead of the menu.
+    if (argc > 1 && string(argv[1]) == "serve") {
+        return runServer(argc, argv);
+    }
+
+    // "leagues DIR" hosts a whole directory of leagues at once.
+    if (argc > 2 && string(argv[1]) == "leagues") {
+        return runLeagues(argc, argv);
+    }
+
+    // "topmerge N FILE..." reads the files without loading a league.
+    if (argc > 3 && string(argv[1]) == "topmerge") {
+        return runTopMerge(argc, argv);
+    }
+
+    // "cluster N" starts N shard servers and waits for them.
+    if (argc > 2 && string(argv[1]) == "cluster") {
+        return runCluster(argc, argv);
+    }
+
+    // "verify FILE..." checks the files' block checksums.
+    if (argc > 2 && string(argv[1]) == "verify") {
+        return runVerify(argc, argv);
+    }
+
+    // Any other arguments are a script command (view, add, batch, ...).
+    if (argc > 1) {
+        return runScript(argc, argv);
+    }
 
     // Create an instance of Soccer. This class automatically ensures
     // the file "soccer.csv" exists or creates one if not found.
@@ -58,7 +197,7 @@ int main() {
             case ADD: {
                 // Variables to store user input
                 string name;
-                int goals;
+                int goals = 0;
 
                 // Always clear the input buffer before getline
                 // (Prevents skipping input if user pressed Enter earlier)
@@ -68,7 +207,7 @@ int main() {
                 getline(cin, name);
 
                 cout << "Enter number of goals: ";
-                cin >> goals;
+                if (!readGoals(goals)) break;
 
                 // Adds a new player using ofstream in append mode (ios::app)
                 // This means the new player is added to the *end* of the file.
@@ -81,7 +220,7 @@ int main() {
             // -------------------------------
             case UPDATE: {
                 string name;
-                int goals;
+                int goals = 0;
 
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
@@ -89,7 +228,7 @@ int main() {
                 getline(cin, name);
 
                 cout << "Enter the new goal count: ";
-                cin >> goals;
+                if (!readGoals(goals)) break;
 
                 // Uses fstream (ios::in | ios::out) to both read and rewrite
                 // the same file. Demonstrates seekp() and clear() internally.
@@ -122,7 +261,7 @@ int main() {
 // Purpose : Display menu options and return user’s choice.
 // ------------------------------------------------------------
 int menu() {
-    int choice;
+    int choice = 0;
     cout << "\n=========================================\n";
     cout << "         ⚽️  SOCCER STATS TRACKER ⚽️\n";
     cout << "=========================================\n";
@@ -133,10 +272,450 @@ int menu() {
     cout << "-----------------------------------------\n";
     cout << "Choose an option: ";
 
-    cin >> choice;
+    if (!(cin >> choice)) {
+        if (cin.eof()) return QUIT;   // Input ended (Ctrl+D)
+        cin.clear();                  // Not a number: forget the line
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
 
     // NOTE: We intentionally don't call cin.ignore() here because
     // some menu options (like VIEW) don’t immediately read text input.
     // We handle it in each specific case where getline() is used.
     return choice;
 }
+
+// ------------------------------------------------------------
+// Function: readGoals()
+// Purpose : Read a goal count from cin.
+// ------------------------------------------------------------
+// Notes:
+//   - If the user didn't type a number, 'cin >> goals' fails and
+//     'goals' must not be used. The failed line is thrown away so
+//     the menu can read the next choice, and false is returned.
+// ------------------------------------------------------------
+bool readGoals(int& goals) {
+    if (cin >> goals) {
+        return true;
+    }
+    cout << "\nThat is not a number. Nothing was changed.\n";
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    return false;
+}
+
+// ------------------------------------------------------------
+// Function: runServer()
+// Purpose : Load the league once and serve it over a socket
+//           until Ctrl+C (SIGINT) or SIGTERM arrives.
+// ------------------------------------------------------------
+
+// The signal handler can only reach the server through a global.
+static SoccerServer* activeServer = nullptr;
+
+static void handleStopSignal(int) {
+    if (activeServer) {
+        activeServer->stop();   // Only writes to an eventfd: signal-safe
+    }
+}
+
+// Counters are sent as i32; anything bigger is shown as INT_MAX.
+static int statValue(uint64_t value) {
+    return static_cast<int>(min<uint64_t>(value, INT_MAX));
+}
+
+int runServer(int argc, char* argv[]) {
+    vector<string> positional;   // socket, file, shm
+    string primarySocket;
+    string replicaOf;
+    UpdateBufferOptions coalesce;
+    bool coalescing = false;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--primary" && i + 1 < argc) {
+                primarySocket = argv[++i];
+            } else if (arg == "--replica-of" && i + 1 < argc) {
+                replicaOf = argv[++i];
+            } else if (arg == "--coalesce-ms" && i + 1 < argc) {
+                coalesce.flushIntervalMs = stoi(argv[++i]);
+                coalescing = true;
+            } else if (arg == "--coalesce-players" && i + 1 < argc) {
+                coalesce.maxPendingPlayers = stoul(argv[++i]);
+                coalescing = true;
+            } else if (arg.rfind("--", 0) == 0) {
+                cerr << "error: unknown serve option " << arg << "\n";
+                return 2;
+            } else {
+                positional.push_back(arg);
+            }
+        }
+    } catch (const exception&) {
+        cerr << "error: expected a number\n";
+        return 2;
+    }
+    string socketPath = (positional.size() > 0) ? positional[0] : "/tmp/soccer.sock";
+    string filename = (positional.size() > 1) ? positional[1] : "soccer.csv";
+
+    // A replica's file is only a copy: it starts empty (rather than
+    // with sample players) and is filled from the primary.
+    if (!replicaOf.empty()) {
+        ofstream empty(filename, ios::trunc);
+        remove((filename + ".log").c_str());
+        remove(FileChecksum::sidecarPath(filename).c_str());
+    }
+
+    Soccer league(filename);
+    league.setVerbose(false);     // No per-request console output
+
+    if (positional.size() > 2 && !league.publishSnapshot(positional[2])) {
+        return 1;
+    }
+
+    // Declared before the server, whose stats source uses them. The
+    // update buffer comes after the primary, so its last flush on the
+    // way out is still shipped to the replicas.
+    unique_ptr<ReplicationPrimary> primary;
+    unique_ptr<ReplicationReplica> replica;
+    unique_ptr<UpdateBuffer> updates;
+
+    SoccerServer server(league, socketPath);
+    if (!primarySocket.empty()) {
+        primary = make_unique<ReplicationPrimary>(league);
+        if (!primary->listen(primarySocket)) return 1;
+    } else if (!replicaOf.empty()) {
+        replica = make_unique<ReplicationReplica>(league);
+        if (!replica->connect(replicaOf)) return 1;
+        server.setReadOnly(true);
+    }
+    if (coalescing && !replica) {
+        updates = make_unique<UpdateBuffer>(league, coalesce);
+        server.setUpdateBuffer(updates.get());
+    }
+
+    server.setStatsSource([&primary, &replica, &updates] {
+        vector<pair<string, int>> counters;
+        if (primary) {
+            ReplicationPrimaryStats s = primary->stats();
+            counters.push_back({"replication.sequence", statValue(s.sequence)});
+            counters.push_back({"replication.replicas", statValue(s.replicas)});
+            counters.push_back({"replication.queued_bytes", statValue(s.queuedBytes)});
+            counters.push_back({"replication.dropped", statValue(s.dropped)});
+        }
+        if (replica) {
+            ReplicaStats s = replica->stats();
+            counters.push_back({"replication.connected", s.connected ? 1 : 0});
+            counters.push_back({"replication.applied_sequence", statValue(s.appliedSequence)});
+            counters.push_back({"replication.primary_sequence", statValue(s.primarySequence)});
+            counters.push_back({"replication.lag_batches",
+                                statValue(s.primarySequence - min(s.primarySequence, s.appliedSequence))});
+            counters.push_back({"replication.lag_ms", statValue(max<int64_t>(0, s.lagMs))});
+            counters.push_back({"replication.silent_ms", statValue(max<int64_t>(0, s.silentMs))});
+            counters.push_back({"replication.applied_records", statValue(s.appliedRecords)});
+        }
+        if (updates) {
+            UpdateBufferStats s = updates->stats();
+            counters.push_back({"coalesce.updates", statValue(s.updates)});
+            counters.push_back({"coalesce.coalesced", statValue(s.coalesced)});
+            counters.push_back({"coalesce.flushes", statValue(s.flushes)});
+            counters.push_back({"coalesce.players_written", statValue(s.playersWritten)});
+            counters.push_back({"coalesce.pending", statValue(s.pending)});
+        }
+        return counters;
+    });
+    activeServer = &server;
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+
+    cout << "Serving " << filename << " on " << socketPath << " (Ctrl+C to stop)\n";
+    bool ok = server.run();
+
+    activeServer = nullptr;
+    return ok ? 0 : 1;
+}
+
+// ------------------------------------------------------------
+// Function: runScript()
+// Purpose : Run one command from argv, or "batch" commands from
+//           stdin, printing only machine-readable output.
+// ------------------------------------------------------------
+int runScript(int argc, char* argv[]) {
+    string filename = "soccer.csv";
+    int first = 1;
+
+    if (argc > 2 && string(argv[1]) == "-f") {
+        filename = argv[2];
+        first = 3;
+    }
+
+    // cin/cout don't need to stay in step with C's printf/scanf here,
+    // and turning that off makes large outputs much faster.
+    ios::sync_with_stdio(false);
+
+    Soccer league(filename);
+    league.setVerbose(false);
+
+    vector<string> args(argv + first, argv + argc);
+    if (!args.empty() && args[0] == "ingest") {
+        return runIngest(league, args);
+    }
+    if (args.size() == 1 && args[0] == "batch") {
+        return SoccerCommands::runBatch(league, cin, cout, cerr);
+    }
+    return SoccerCommands::runCommand(league, args, cout, cerr);
+}
+
+// ------------------------------------------------------------
+// Function: runLeagues()
+// Purpose : Host every league file in a directory and run batch
+//           commands ("use NAME" first) from stdin.
+// ------------------------------------------------------------
+int runLeagues(int argc, char* argv[]) {
+    size_t budgetMb = 256;
+    size_t maxLoaded = 0;
+
+    try {
+        for (int i = 3; i < argc; ++i) {
+            string option = argv[i];
+            if (option == "--budget-mb" && i + 1 < argc) {
+                budgetMb = stoul(argv[++i]);
+            } else if (option == "--max-loaded" && i + 1 < argc) {
+                maxLoaded = stoul(argv[++i]);
+            } else {
+                cerr << "error: unknown leagues option " << option << "\n";
+                return 2;
+            }
+        }
+    } catch (const exception&) {
+        cerr << "error: expected a number\n";
+        return 2;
+    }
+
+    ios::sync_with_stdio(false);
+
+    LeagueManager leagues(budgetMb << 20, maxLoaded);
+    if (leagues.addDirectory(argv[2]) == 0) {
+        cerr << "error: no .csv leagues in " << argv[2] << "\n";
+        return 1;
+    }
+    return SoccerCommands::runLeagueBatch(leagues, cin, cout, cerr);
+}
+
+// ------------------------------------------------------------
+// Function: runTopMerge()
+// Purpose : Print the league-wide top N over many stat files.
+// ------------------------------------------------------------
+int runTopMerge(int argc, char* argv[]) {
+    size_t n;
+    try {
+        n = stoul(argv[2]);
+    } catch (const exception&) {
+        cerr << "error: expected a number\n";
+        return 2;
+    }
+
+    ios::sync_with_stdio(false);
+
+    vector<string> files(argv + 3, argv + argc);
+    vector<pair<string, int>> top;
+    bool ok = TopMerge::topAcrossFiles(files, n, top);
+    for (const auto& row : top) {
+        cout << row.first << ',' << row.second << '\n';
+    }
+    return ok ? 0 : 1;
+}
+
+// ------------------------------------------------------------
+// Function: runVerify()
+// Purpose : Check every FILE against its block checksums.
+// ------------------------------------------------------------
+// Notes:
+//   - Prints one "file,blocks,damaged" line per file; a file
+//     without checksums shows "unchecked" instead of the numbers.
+//   - Each file's blocks are checked in parallel (see
+//     FileChecksum.h). Nothing is changed; "repair" rewrites a
+//     league's files with new checksums.
+//   - Returns 1 if any block is damaged or a file can't be read.
+// ------------------------------------------------------------
+int runVerify(int argc, char* argv[]) {
+    int status = 0;
+    for (int i = 2; i < argc; ++i) {
+        string file = argv[i];
+        if (access(file.c_str(), R_OK) != 0) {
+            cerr << "Error: Could not open " << file << " for reading.\n";
+            status = 1;
+            continue;
+        }
+
+        FileChecksum::Report report = FileChecksum::verifyFile(file);
+        if (!report.checked) {
+            cout << file << ",unchecked\n";
+            continue;
+        }
+        cout << file << ',' << report.blocks << ',' << report.damaged.size() << '\n';
+        for (const auto& range : report.damaged) {
+            cerr << "  damaged block at byte " << range.first << " (" << range.second - range.first << " bytes)\n";
+        }
+        if (!report.ok()) status = 1;
+    }
+    return status;
+}
+
+// ------------------------------------------------------------
+// Function: runCluster()
+// Purpose : Start one "serve" process per shard, then wait until
+//           they have all stopped.
+// ------------------------------------------------------------
+// Notes:
+//   - Each shard is this same program (/proc/self/exe) started
+//     with "serve SOCKET FILE", so it is a completely separate
+//     process with its own table, update log and writer thread.
+//   - Missing shard files are created empty first; otherwise every
+//     shard would start with its own copy of the sample players.
+//   - Ctrl+C reaches the shards directly (same terminal); SIGTERM
+//     sent to this process is passed on to them.
+// ------------------------------------------------------------
+
+static vector<pid_t> clusterShards;
+
+static void handleClusterSignal(int signo) {
+    for (pid_t pid : clusterShards) {
+        kill(pid, signo);   // kill() is signal-safe
+    }
+}
+
+int runCluster(int argc, char* argv[]) {
+    size_t shards;
+    try {
+        shards = stoul(argv[2]);
+    } catch (const exception&) {
+        cerr << "error: expected a number\n";
+        return 2;
+    }
+    if (shards == 0) {
+        cerr << "error: a cluster needs at least one shard\n";
+        return 2;
+    }
+    string directory = (argc > 3) ? argv[3] : ".";
+    string prefix = (argc > 4) ? argv[4] : "/tmp/soccer-shard";
+
+    error_code error;
+    filesystem::create_directories(directory, error);
+
+    vector<string> sockets;
+    for (size_t i = 0; i < shards; ++i) {
+        string file = directory + "/shard-" + to_string(i) + ".csv";
+        string socketPath = prefix + "-" + to_string(i) + ".sock";
+        if (!filesystem::exists(file) && !ofstream(file)) {
+            cerr << "Error: Could not create " << file << "\n";
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            cerr << "Error: Could not start shard " << i << "\n";
+            break;
+        }
+        if (pid == 0) {
+            char* args[] = {argv[0], const_cast<char*>("serve"), socketPath.data(), file.data(), nullptr};
+            execv("/proc/self/exe", args);
+            _exit(127);   // Only reached if execv failed
+        }
+        clusterShards.push_back(pid);
+        sockets.push_back(socketPath);
+    }
+
+    signal(SIGTERM, handleClusterSignal);
+    signal(SIGINT, SIG_IGN);   // The shards get Ctrl+C themselves
+
+    if (clusterShards.size() < shards) {
+        handleClusterSignal(SIGTERM);
+    } else {
+        cout << "Cluster sockets: ";
+        for (size_t i = 0; i < sockets.size(); ++i) {
+            cout << (i ? "," : "") << sockets[i];
+        }
+        cout << endl;
+    }
+
+    bool ok = clusterShards.size() == shards;
+    for (pid_t pid : clusterShards) {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+// ------------------------------------------------------------
+// Function: runIngest()
+// Purpose : Stream goal events into the league until the input
+//           ends (or Ctrl+C with --follow), then print a summary.
+// ------------------------------------------------------------
+
+static GoalIngestor* activeIngestor = nullptr;
+static IngestPipeline* activePipeline = nullptr;
+
+static void handleIngestSignal(int) {
+    // stop() only sets an atomic flag: signal-safe
+    if (activeIngestor) activeIngestor->stop();
+    if (activePipeline) activePipeline->stop();
+}
+
+int runIngest(Soccer& league, const vector<string>& args) {
+    IngestOptions options;
+    string source = "-";
+    bool sync = true;
+    bool pipeline = false;
+
+    try {
+        for (size_t i = 1; i < args.size(); ++i) {
+            if (args[i] == "--follow") {
+                options.follow = true;
+            } else if (args[i] == "--no-sync") {
+                sync = false;
+            } else if (args[i] == "--pipeline") {
+                pipeline = true;
+            } else if (args[i] == "--batch" && i + 1 < args.size()) {
+                options.maxBatchEvents = stoul(args[++i]);
+            } else if (args[i] == "--delay-ms" && i + 1 < args.size()) {
+                options.maxBatchDelayMs = stoi(args[++i]);
+            } else if (args[i] == "--dedupe-window" && i + 1 < args.size()) {
+                options.dedupeWindowSeconds = stoi(args[++i]);
+            } else if (args[i] == "--dedupe-keys" && i + 1 < args.size()) {
+                options.dedupeMaxKeys = stoul(args[++i]);
+            } else if (args[i].rfind("--", 0) != 0) {
+                source = args[i];
+            } else {
+                cerr << "error: unknown ingest option " << args[i] << "\n";
+                return 2;
+            }
+        }
+    } catch (const exception&) {
+        cerr << "error: expected a number\n";
+        return 2;
+    }
+
+    league.setLogSync(sync);
+
+    // No SA_RESTART: a blocked read()/poll() must return on Ctrl+C.
+    struct sigaction action{};
+    action.sa_handler = handleIngestSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    bool ok;
+    if (pipeline) {
+        IngestPipeline stages(league, options);
+        activePipeline = &stages;
+        ok = stages.ingestFile(source);
+        activePipeline = nullptr;
+        stages.report(cerr);
+    } else {
+        GoalIngestor ingestor(league, options);
+        activeIngestor = &ingestor;
+        ok = ingestor.ingestFile(source);
+        activeIngestor = nullptr;
+        ingestor.report(cerr);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+//
+// Module 9 - Streams and Files
+// Example: Soccer Stats Client
+// ---------------------------------------------
+// A command-line client for the socket server started with
+// "Module9_Code_Together serve". It uses SoccerClient, so bulk
+// loads are pipelined and batched instead of waiting for one
+// answer before sending the next request.
+//
+// Usage:
+//    soccer_client [-s socket] view
+//    soccer_client [-s socket] get NAME
+//    soccer_client [-s socket] add NAME GOALS
+//    soccer_client [-s socket] update NAME GOALS
+//    soccer_client [-s socket] top N
+//    soccer_client [-s socket] count MIN [MAX] (players with MIN..MAX goals)
+//    soccer_client [-s socket] load [FILE]    (FILE or stdin, "Name,Goals" lines)
+//    soccer_client [-s socket] stats          (server counters, e.g. replica lag)
+//
+//    soccer_client [-s socket] -m shm view | get NAME | top N
+//       → read from the shared memory snapshot published by
+//         "serve ... shm" instead of asking the server. Answers
+//         the snapshot can't give (a player whose name is too long
+//         for it, or a server that stopped half way through a
+//         change) are asked from the server after all.
+//
+//    soccer_client -c SOCKET,SOCKET,... COMMAND ...
+//       → talk to a sharded league (see "Module9_Code_Together
+//         cluster" and ShardRouter.h). Same commands as with -s;
+//         each player goes to its own shard, and view, top and
+//         count combine the answers of all shards.
+//
+// Player lists are printed as "Name,Goals" lines, the same
+// format as soccer.csv.
+// ---------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <climits>
+#include "SoccerClient.h"
+#include "SoccerSnapshot.h"
+#include "ShardRouter.h"
+#include "SoccerProtocol.h"
+using namespace std;
+
+// Prints a short usage message and returns the exit code for it.
+int usage() {
+    cerr << "Usage: soccer_client [-s socket] view | get NAME | add NAME GOALS |\n"
+         << "                     update NAME GOALS | top N | count MIN [MAX] |\n"
+         << "                     load [FILE] | stats\n"
+         << "       soccer_client [-s socket] -m shm view | get NAME | top N\n"
+         << "       soccer_client -c socket,socket,... (same commands as -s)\n";
+    return 2;
+}
+
+// Prints a list of players in "Name,Goals" format.
+void printPlayers(const vector<pair<string, int>>& players) {
+    for (const auto& p : players) {
+        cout << p.first << "," << p.second << "\n";
+    }
+}
+
+// Turns a reply into an exit code, printing an error if needed.
+int finish(const SoccerReply& reply) {
+    if (!reply.connected) {
+        cerr << "Error: Lost connection to the server.\n";
+        return 1;
+    }
+    if (reply.status == SoccerProtocol::READ_ONLY) {
+        cerr << "Error: The server is a read-only replica; send changes to the primary.\n";
+        return 1;
+    }
+    if (reply.status == SoccerProtocol::WRITE_FAILED) {
+        cerr << "Error: The server could not write the change.\n";
+        return 1;
+    }
+    if (!reply.ok()) {
+        cerr << "Error: Server answered with status " << int(reply.status) << ".\n";
+        return 1;
+    }
+    return 0;
+}
+
+// ------------------------------------------------------------
+// Function: loadPlayers()
+// Purpose : Stream "Name,Goals" lines to the server as batched
+//           updates. Nothing waits for an answer until the end.
+//
+// 'Client' is a SoccerClient or a ShardRouter (same calls).
+// ------------------------------------------------------------
+template <typename Client>
+int loadPlayers(Client& client, istream& in) {
+    string line;
+    size_t count = 0;
+
+    while (getline(in, line)) {
+        size_t comma = line.rfind(',');
+        if (line.empty() || comma == string::npos) continue;
+
+        try {
+            client.queueUpdate(line.substr(0, comma), stoi(line.substr(comma + 1)));
+            ++count;
+        } catch (const exception&) {
+            cerr << "Skipping bad line: " << line << "\n";
+        }
+    }
+
+    int status = finish(client.flush().get());
+    if (status == 0) {
+        cout << count << "\n";
+    }
+    return status;
+}
+
+
+// ------------------------------------------------------------
+// Function: runCommand()
+// Purpose : Send one command through 'client' (a SoccerClient or
+//           a ShardRouter) and print the answer.
+// ------------------------------------------------------------
+template <typename Client>
+int runCommand(Client& client, const string& command, int remaining, char* args[]) {
+    try {
+        if (command == "view" && remaining == 0) {
+            SoccerReply reply = client.view().get();
+            printPlayers(reply.players);
+            return finish(reply);
+        }
+        if (command == "get" && remaining == 1) {
+            SoccerReply reply = client.get(args[0]).get();
+            if (reply.ok()) cout << args[0] << "," << reply.goals << "\n";
+            return finish(reply);
+        }
+        if (command == "add" && remaining == 2) {
+            return finish(client.add(args[0], stoi(args[1])).get());
+        }
+        if (command == "update" && remaining == 2) {
+            return finish(client.update(args[0], stoi(args[1])).get());
+        }
+        if (command == "top" && remaining == 1) {
+            SoccerReply reply = client.top(static_cast<uint32_t>(stoul(args[0]))).get();
+            printPlayers(reply.players);
+            return finish(reply);
+        }
+        if (command == "count" && (remaining == 1 || remaining == 2)) {
+            int maxGoals = (remaining == 2) ? stoi(args[1]) : INT_MAX;
+            SoccerReply reply = client.count(stoi(args[0]), maxGoals).get();
+            if (reply.ok()) cout << "count," << reply.count << "\n";
+            return finish(reply);
+        }
+        if (command == "stats" && remaining == 0) {
+            SoccerReply reply = client.stats().get();
+            for (const auto& counter : reply.players) {
+                cout << counter.first << "=" << counter.second << "\n";
+            }
+            return finish(reply);
+        }
+        if (command == "load" && remaining <= 1) {
+            if (remaining == 0 || string(args[0]) == "-") {
+                return loadPlayers(client, cin);
+            }
+            ifstream in(args[0]);
+            if (!in) {
+                cerr << "Error: Could not open " << args[0] << " for reading.\n";
+                return 1;
+            }
+            return loadPlayers(client, in);
+        }
+    } catch (const exception&) {
+        cerr << "Error: Expected a number.\n";
+        return 2;
+    }
+
+    return usage();
+}
+
+// ------------------------------------------------------------
+// Function: readSnapshot()
+// Purpose : Answer read-only commands from shared memory, or from
+//           the server at 'socketPath' when the snapshot can't
+//           (see SoccerSnapshotReader::answered).
+// ------------------------------------------------------------
+int readSnapshot(const string& shmName, const string& socketPath, const string& command,
+                 int remaining, char* args[]) {
+    SoccerSnapshotReader snapshot;
+    if (!snapshot.open(shmName)) return 1;
+
+    try {
+        if (command == "view" && remaining == 0) {
+            auto players = snapshot.players();
+            if (snapshot.answered()) {
+                printPlayers(players);
+                return 0;
+            }
+        } else if (command == "get" && remaining == 1) {
+            int goals;
+            bool found = snapshot.find(args[0], goals);
+            if (snapshot.answered()) {
+                if (!found) {
+                    cerr << "Error: " << args[0] << " not found.\n";
+                    return 1;
+                }
+                cout << args[0] << "," << goals << "\n";
+                return 0;
+            }
+        } else if (command == "top" && remaining == 1) {
+            auto players = snapshot.top(stoul(args[0]));
+            if (snapshot.answered()) {
+                printPlayers(players);
+                return 0;
+            }
+        } else {
+            return usage();
+        }
+    } catch (const exception&) {
+        cerr << "Error: Expected a number.\n";
+        return 2;
+    }
+
+    SoccerClient client;
+    if (!client.connect(socketPath)) return 1;
+    return runCommand(client, command, remaining, args);
+}
+
+int main(int argc, char* argv[]) {
+    string socketPath = "/tmp/soccer.sock";
+    string shmName;
+    vector<string> shardPaths;
+    int arg = 1;
+
+    if (arg + 1 < argc && string(argv[arg]) == "-s") {
+        socketPath = argv[arg + 1];
+        arg += 2;
+    }
+    if (arg + 1 < argc && string(argv[arg]) == "-m") {
+        shmName = argv[arg + 1];
+        arg += 2;
+    } else if (arg + 1 < argc && string(argv[arg]) == "-c") {
+        string list = argv[arg + 1];
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t comma = list.find(',', start);
+            if (comma == string::npos) comma = list.size();
+            if (comma > start) shardPaths.push_back(list.substr(start, comma - start));
+            start = comma + 1;
+        }
+        if (shardPaths.empty()) return usage();
+        arg += 2;
+    }
+    if (arg >= argc) return usage();
+
+    string command = argv[arg++];
+    int remaining = argc - arg;
+
+    if (!shmName.empty()) {
+        return readSnapshot(shmName, socketPath, command, remaining, argv + arg);
+    }
+
+    if (!shardPaths.empty()) {
+        ShardRouter router;
+        if (!router.connect(shardPaths)) return 1;
+        return runCommand(router, command, remaining, argv + arg);
+    }
+
+    SoccerClient client;
+    if (!client.connect(socketPath)) return 1;
+    return runCommand(client, command, remaining, argv + arg);
+}